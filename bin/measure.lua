@@ -24,38 +24,122 @@
 -- measure: A benchmarking tool for Lua
 --
 local print = print
+local next = next
 local find = string.find
+local sub = string.sub
 local format = string.format
 local match = string.match
-local unpack = table.unpack or unpack
-local chdir = require('chdir')
+local gmatch = string.gmatch
+local sqrt = math.sqrt
+local sort = table.sort
+local getcwd = require('measure.getcwd')
 local report = require('measure.report')
+local render_diff = require('measure.report.diff')
+local render_matrix = require('measure.report.matrix')
 local report_sysinfo = require('measure.report.sysinfo')
 local listfiles = require('measure.listfiles')
-local loadfile = require('measure.loadfile')
+local realpath = require('measure.realpath')
+local watch = require('measure.watch')
 local new_samples = require('measure.samples').new
-local sampler = require('measure.sampler')
-local stats_ci = require('measure.stats.ci')
+local merge_samples = require('measure.samples').merge
+local calibrate = require('measure.calibrate')
+local quantile = require('measure.quantile')
+local fmt = require('measure.report.format')
+local stats_hierarchical = require('measure.stats.hierarchical')
+local stats_coldstart = require('measure.stats.coldstart')
+local new_jittrace = require('measure.jittrace')
+local serialize = require('measure.serialize')
+local runner = require('measure.runner')
+local printf = runner.printf
+local pcall_in_dir = runner.pcall_in_dir
+local load_file = runner.load_file
+local safecall = runner.safecall
+local sample_describe = runner.sample
+local fork_describe = runner.fork
+local sample_variant = runner.variant
+local NOOP = runner.NOOP
+local sample_require = require('measure.mode.require')
+local cold_start_describe = require('measure.mode.cold_start')
+local jit_trace_describe = require('measure.mode.jit_trace')
+local bisect_judge = require('measure.bisect').judge
+local bisect_search = require('measure.bisect').search
+local render_bisect = require('measure.report.bisect')
 -- constants
 -- current working directory
-local PWD = assert(io.popen('pwd'):read('*l'))
-
---- Change directory, execute function, and return to original directory
---- @param dir string Working directory to change
---- @param fn function Function to execute
---- @param ... any Arguments to pass to the function
---- @return ... Results of the function execution
-local function pcall_in_dir(dir, fn, ...)
-    assert(chdir(dir))
-    local res = {
-        pcall(fn, ...),
-    }
-    assert(chdir(PWD))
-    if not res[1] then
-        error(res[2])
-    end
-    return unpack(res, 2, 10)
-end
+local PWD = assert(getcwd())
+-- default maximum number of samples per benchmark
+local MAX_SAMPLE_SIZE = 5000
+-- maximum number of samples per benchmark on a noisy host
+local MAX_SAMPLE_SIZE_NOISY = 20000
+-- maximum number of samples per benchmark for this run
+local max_sample_size = MAX_SAMPLE_SIZE
+-- pathname of this script to run it under the other runtimes
+local SCRIPT = _G.arg and _G.arg[0]
+-- version of the running Lua runtime
+local RUNTIME_VERSION = _G.jit and _G.jit.version or _VERSION
+-- default number of samples of each revision of the bisect command
+local BISECT_SAMPLES = 100
+-- options that run the describe as the variants of their own and their
+-- samplers, which return the samples of the variants and the analysis
+local VARIANT_MODES = {
+    {
+        'ab',
+        require('measure.mode.ab'),
+    },
+    {
+        'gc_modes',
+        require('measure.mode.gc_modes'),
+    },
+    {
+        'gc_tune',
+        require('measure.mode.gc_tune'),
+    },
+    {
+        'cold_cache',
+        require('measure.mode.cold_cache'),
+    },
+    {
+        'page_cache',
+        require('measure.mode.page_cache'),
+    },
+    {
+        'numa',
+        require('measure.mode.numa'),
+    },
+    {
+        'allocators',
+        require('measure.mode.allocators'),
+    },
+}
+-- options that run the describe again after the steady state, the kind of
+-- their analysis and the functions to run them
+local ANALYSIS_MODES = {
+    {
+        'leak_check',
+        'leak',
+        require('measure.mode.leak_check'),
+    },
+    {
+        'heap_census',
+        'census',
+        require('measure.mode.heap_census'),
+    },
+    {
+        'alloc_profile',
+        'alloc_sites',
+        require('measure.mode.alloc_profile'),
+    },
+    {
+        'cpu_profile',
+        'cpu_profile',
+        require('measure.mode.cpu_profile'),
+    },
+    {
+        'opcode_profile',
+        'opcodes',
+        require('measure.mode.opcode_profile'),
+    },
+}
 
 --- Print usage information
 local function print_usage()
@@ -64,25 +148,52 @@ measure is a benchmarking command for Lua scripts.
 
 Usage:
   measure [options] <pathname>
+  measure bisect [bisect-options] <good-rev> <bad-rev> <pathname>
 
 Options:
   --help                Show this help message.
   --version             Show version information.
+  --watch               Watch the benchmark files and the modules they require,
+                        and re-run the affected benchmarks when they change.
+  --recursive           Search the benchmark files in subdirectories too.
+  --include=<pattern>   Glob pattern of the benchmark files to run
+                        (default: *_bench.lua). Can be specified multiple times.
+  --exclude=<pattern>   Glob pattern of the files and directories to skip.
+                        Can be specified multiple times.
+  --noise-threshold=<pct>
+                        Threshold of the timing jitter (CV of a constant
+                        workload in percent) measured before running the
+                        benchmarks.
+  --noise-action=<action>
+                        Action when the jitter exceeds the threshold:
+                        warn (default), abort, or raise (raise the maximum
+                        number of samples from 5000 to 20000).
+  --lua=<list>          Comma-separated Lua interpreters to run the benchmarks
+                        under (e.g. lua5.1,lua5.4,luajit), and compare the
+                        results across them.
+  --export=<file>       Write the samples to the file instead of printing the
+                        report (used by --lua to collect the results).
+
+Bisect Options:
+  --describe=<name>     The describe to measure (required).
+  --build=<command>     Shell command to build each revision in its worktree.
+  --root=<dir>          Directory of the modules in the worktree (default: .).
+  --threshold=<pct>     Minimum slowdown from the good revision to consider
+                        a revision bad (default: 5).
+  --samples=<n>         Number of samples of each revision (default: 100).
 
 Arguments:
     <pathname>  The path to a Lua script or directory containing Lua scripts
                 to benchmark. The benchmark script should be named `*_bench.lua`.
+    <good-rev>  The git revision without the regression.
+    <bad-rev>   The git revision with the regression.
+
+Patterns are matched against the file name, or against the pathname relative
+to the directory if the pattern contains a slash.
 ]])
     os.exit(0)
 end
 
---- Print formatted output
---- @param ... any Arguments to format
---- @usage printf("Hello, %s!", "world")
-local function printf(...)
-    print(format(...))
-end
-
 local VERSION = '0.1.0'
 --- Print version information
 local function print_version()
@@ -96,16 +207,86 @@ local function parse_argv()
     local argv = _G.arg or {}
     local args = {
         record_dir = './measure_records',
+        noise_action = 'warn',
     }
-    for i = 1, #argv do
+    if argv[1] == 'bisect' then
+        args.bisect = {
+            root = '.',
+            threshold = 5,
+        }
+    end
+    for i = args.bisect and 2 or 1, #argv do
         local arg = argv[i]
         if arg == '--help' then
             print_usage()
         elseif arg == '--version' then
             print_version()
+        elseif arg == '--watch' then
+            args.watch = true
+        elseif arg == '--recursive' then
+            args.recursive = true
+        elseif find(arg, '^%-%-include=') then
+            args.include = args.include or {}
+            args.include[#args.include + 1] = match(arg, '^%-%-include=(.*)$')
+        elseif find(arg, '^%-%-noise%-threshold=') then
+            local v = tonumber(match(arg, '^%-%-noise%-threshold=(.*)$'))
+            if not v or v <= 0 then
+                printf('Invalid noise threshold: %q', arg)
+                os.exit(1)
+            end
+            args.noise_threshold = v
+        elseif find(arg, '^%-%-noise%-action=') then
+            local v = match(arg, '^%-%-noise%-action=(.*)$')
+            if v ~= 'warn' and v ~= 'abort' and v ~= 'raise' then
+                printf('Invalid noise action: %q', arg)
+                os.exit(1)
+            end
+            args.noise_action = v
+        elseif find(arg, '^%-%-lua=') then
+            args.lua = {}
+            for v in gmatch(match(arg, '^%-%-lua=(.*)$'), '[^,]+') do
+                args.lua[#args.lua + 1] = v
+            end
+            if #args.lua == 0 then
+                printf('Invalid Lua interpreters: %q', arg)
+                os.exit(1)
+            end
+        elseif find(arg, '^%-%-export=') then
+            args.export = match(arg, '^%-%-export=(.+)$')
+            if not args.export then
+                printf('Invalid export pathname: %q', arg)
+                os.exit(1)
+            end
+        elseif find(arg, '^%-%-exclude=') then
+            args.exclude = args.exclude or {}
+            args.exclude[#args.exclude + 1] = match(arg, '^%-%-exclude=(.*)$')
+        elseif args.bisect and find(arg, '^%-%-describe=.') then
+            args.bisect.describe = match(arg, '^%-%-describe=(.*)$')
+        elseif args.bisect and find(arg, '^%-%-build=.') then
+            args.bisect.build = match(arg, '^%-%-build=(.*)$')
+        elseif args.bisect and find(arg, '^%-%-root=.') then
+            args.bisect.root = match(arg, '^%-%-root=(.*)$')
+        elseif args.bisect and find(arg, '^%-%-threshold=') then
+            local v = tonumber(match(arg, '^%-%-threshold=(.*)$'))
+            if not v or v < 0 then
+                printf('Invalid threshold: %q', arg)
+                os.exit(1)
+            end
+            args.bisect.threshold = v
+        elseif args.bisect and find(arg, '^%-%-samples=') then
+            local v = tonumber(match(arg, '^%-%-samples=(.*)$'))
+            if not v or v < 10 or v % 1 ~= 0 then
+                printf('Invalid number of samples: %q', arg)
+                os.exit(1)
+            end
+            args.bisect.samples = v
         elseif find(arg, '^%-') then
             printf('Unknown option: %q', arg)
             os.exit(1)
+        elseif args.bisect and not args.bisect.good then
+            args.bisect.good = arg
+        elseif args.bisect and not args.bisect.bad then
+            args.bisect.bad = arg
         elseif args.pathname then
             print('Error: Only one pathname is allowed.')
             print_usage()
@@ -117,125 +298,205 @@ local function parse_argv()
     if not args.pathname then
         print('Error: No pathname specified')
         print_usage()
+    elseif args.lua and (args.watch or args.export) then
+        print('Error: --lua cannot be used with --watch or --export')
+        os.exit(1)
+    elseif args.bisect then
+        if not args.bisect.describe then
+            print('Error: bisect requires --describe=<name>')
+            os.exit(1)
+        elseif args.watch or args.lua or args.export then
+            print('Error: bisect cannot be used with --watch, --lua or --export')
+            os.exit(1)
+        end
     end
 
     return args
 end
 
--- Execute benchmarks
-
---- Safely call a function with error handling
---- @param msg string Error message prefix
---- @param fn function Function to call
---- @param ... any Arguments to pass to the function
---- @return boolean ok True if the function executed successfully
---- @return any ... results of the function or an error message if failed
-local function safecall(msg, fn, ...)
-    local res = {
-        pcall(fn, ...),
-    }
-    if not res[1] then
-        return false, format('ERROR: %s: %s', msg, res[2])
+--- Get the absolute pathname
+--- @param pathname string The pathname
+--- @param dir string? The base directory of the relative pathname
+--- @return string pathname The absolute pathname
+local function abspath(pathname, dir)
+    if sub(pathname, 1, 1) ~= '/' then
+        pathname = (dir or PWD) .. '/' .. pathname
     end
-    return true, unpack(res, 2, 10)
+    return realpath(pathname)
 end
 
---- Run the sampling function with warmup
---- @param name string The name of the benchmark
---- @param fn function The function to sample
---- @param ctx table The context object for the sampling function
---- @return measure.samples? samples The samples object with collected data
---- @return any err Error message if failed
-local function do_sampling(name, fn, ctx)
-    local iteration = 1
-    local sample_size = 30
-    local warmup = ctx.warmup
-    local samples = new_samples(name, sample_size, ctx.gc_step,
-                                ctx.confidence_level, ctx.rciw)
-
-    printf('    - Sampling %d samples (iteration %d, warmup %d sec)',
-           sample_size, iteration, warmup)
-    while sample_size do
-        local ok, err = sampler(fn, samples, warmup)
-        if not ok then
-            error(err, 2)
-        end
+-- Execute benchmarks
 
-        local ci = stats_ci(samples)
-        sample_size = ci.resample_size
-        if sample_size then
-            iteration = iteration + 1
-            warmup = nil -- no warmup for subsequent iterations
-            samples:capacity(sample_size - #samples)
-            printf('    - Sampling %d samples (iteration %d)', sample_size,
-                   iteration)
-        end
-    end
+--- Quote the string for the shell
+--- @param s string
+--- @return string
+local function shell_quote(s)
+    return "'" .. s:gsub("'", "'\\''") .. "'"
+end
 
-    return samples
+--- Run the shell command
+--- @param cmd string The command to run
+--- @return boolean ok True if the command exited successfully
+local function execute(cmd)
+    local rc = os.execute(cmd)
+    -- Lua 5.1 returns the exit status, and Lua 5.2 or later returns true
+    return rc == true or rc == 0
 end
 
-local function NOOP()
+--- Get the options of the describe with defaults
+--- @param desc measure.describe The describe
+--- @return table opts The options with defaults
+local function describe_opts(desc)
+    local options = desc.spec.options or {}
+    return {
+        -- set default options
+        context = options.context or {},
+        warmup = options.warmup or 1, -- warmup time (seconds)
+        gc_step = options.gc_step or 0, -- gc step size (KB)
+        confidence_level = options.confidence_level or 95, -- confidence level (%)
+        rciw = options.rciw or 5, -- target relative confidence interval width (%)
+        forks = options.forks, -- number of child processes
+        max_sample_size = max_sample_size, -- maximum number of samples
+    }
 end
 
-local function run_describes(spec)
-    local results = {}
-    for _, desc in ipairs(spec.describes) do
-        printf('- %s', desc.spec.name)
-
-        -- get options with defaults
-        local options = desc.spec.options or {}
-        local opts = {
-            -- set default options
-            context = options.context or {},
-            warmup = options.warmup or 1, -- warmup time (seconds)
-            gc_step = options.gc_step or 0, -- gc step size (KB)
-            confidence_level = options.confidence_level or 95, -- confidence level (%)
-            rciw = options.rciw or 5, -- target relative confidence interval width (%)
+--- Run the describe
+--- @param desc measure.describe The describe to run
+--- @param analyses table The additional analyses of the report
+--- @return measure.samples[]? list The samples objects with collected data
+--- @return any err Error message if failed
+local function run_describe(desc, analyses)
+    local name = desc.spec.name
+    printf('- %s', name)
+
+    local options = desc.spec.options or {}
+    local opts = describe_opts(desc)
+
+    if desc.spec.require then
+        local samples, err, result = sample_require(desc, opts)
+        if not samples then
+            return nil, err
+        end
+        analyses.require = analyses.require or {}
+        analyses.require[name] = result
+        return {
+            samples,
         }
+    end
 
-        -- execute setup() function if defined
-        local ok, res = safecall('setup()', desc.spec.setup or NOOP,
-                                 opts.context)
-        if not ok then
-            return nil, res
+    -- run the variants of the option instead of the steady state
+    for _, v in ipairs(VARIANT_MODES) do
+        local k, sample = v[1], v[2]
+        if options[k] then
+            local list, err, result = sample(desc, opts, options[k])
+            if not list then
+                return nil, err
+            end
+            analyses[k] = analyses[k] or {}
+            analyses[k][name] = result
+            return list
         end
+    end
+
+    -- measure the cold start before anything runs in this process
+    local cold_list, err
+    if options.cold_start then
+        cold_list, err = cold_start_describe(desc, opts, options.cold_start)
+        if not cold_list then
+            return nil, err
+        end
+    end
 
-        -- execute run() or run_with_timer() function
-        local bench_ok, bench_res
-        if desc.spec.run then
-            bench_ok, bench_res = safecall('run()', function()
-                return do_sampling(desc.spec.name, desc.spec.run, opts)
-            end)
+    -- measure the steady state
+    local samples
+    if opts.forks then
+        if options.jit_trace then
+            printf('    - JIT trace is not recorded in the child processes')
+        end
+        local list
+        list, err = fork_describe(desc, opts, opts.forks, 'Fork')
+        if not list then
+            return nil, err
+        end
+        samples = merge_samples(name, list)
+        analyses.forks = analyses.forks or {}
+        analyses.forks[name] = stats_hierarchical(list)
+    elseif options.jit_trace then
+        local recorder, result
+        recorder, err = new_jittrace()
+        if recorder then
+            samples, err, result = jit_trace_describe(desc, opts, recorder)
+            if not samples then
+                return nil, err
+            end
+            analyses.jit_trace = analyses.jit_trace or {}
+            analyses.jit_trace[name] = result
         else
-            bench_ok, bench_res = safecall('run_with_timer()',
-                                           desc.spec.run_with_timer,
-                                           function(fn)
-                return do_sampling(desc.spec.name, fn, opts)
-            end)
+            printf('    - JIT trace is not available: %s', err)
+            samples, err = sample_describe(desc, opts)
+            if not samples then
+                return nil, err
+            end
         end
+    else
+        samples, err = sample_describe(desc, opts)
+        if not samples then
+            return nil, err
+        end
+    end
 
-        -- execute teardown() function if defined
-        ok, res = safecall('teardown()', desc.spec.teardown or NOOP,
-                           opts.context)
-        if not ok then
-            return nil, res
+    if cold_list then
+        analyses.cold_start = analyses.cold_start or {}
+        analyses.cold_start[name] = stats_coldstart(cold_list, samples)
+    end
+
+    -- run the describe again for the analyses of the steady state
+    for _, v in ipairs(ANALYSIS_MODES) do
+        local k, kind, analyze = v[1], v[2], v[3]
+        if options[k] then
+            local result
+            result, err = analyze(desc, opts, options[k], samples)
+            if not result then
+                return nil, err
+            end
+            analyses[kind] = analyses[kind] or {}
+            analyses[kind][name] = result
         end
+    end
+    return {
+        samples,
+    }
+end
 
-        if not bench_ok then
-            -- benchmarking failed
-            return nil, bench_res
+--- Run the describes of the benchmark specification
+--- @param spec table The benchmark specification
+--- @param filter table<string, boolean>? The names of the describes to run
+--- @param analyses table The additional analyses of the report
+--- @return table? results The benchmark results
+--- @return any err Error message if failed
+local function run_describes(spec, filter, analyses)
+    local results = {}
+    for _, desc in ipairs(spec.describes) do
+        if not filter or filter[desc.spec.name] then
+            local list, err = run_describe(desc, analyses)
+            if not list then
+                return nil, err
+            end
+            for _, samples in ipairs(list) do
+                results[#results + 1] = samples
+            end
         end
-        results[#results + 1] = bench_res
     end
     return results
 end
 
 --- Execute the benchmark specification
 --- @param spec table The benchmark specification
+--- @param filter table<string, boolean>? The names of the describes to run
+--- @param analyses table The additional analyses of the report
 --- @return table? results The benchmark results
 --- @return any err Error message if failed
-local function do_benchmark(spec)
+local function do_benchmark(spec, filter, analyses)
     -- execute before_all()
     local ok, res = safecall('before_all()', spec.hooks.before_all or NOOP)
     if not ok then
@@ -245,7 +506,7 @@ local function do_benchmark(spec)
     local hook_ctx = res or {}
 
     -- run describes
-    local results, err = run_describes(spec)
+    local results, err = run_describes(spec, filter, analyses)
 
     -- execute: after_all hook if defined
     ok, res = safecall('after_all()', spec.hooks.after_all or NOOP, hook_ctx)
@@ -256,18 +517,584 @@ local function do_benchmark(spec)
     return results, err
 end
 
---- Get the directory name from a given pathname
---- @param pathname string The full pathname
---- @return string dirname The directory part of the pathname
---- @return string filename The filename part of the pathname
-local function dirname(pathname)
-    local dir, file = match(pathname, '^(.-)([^/]+)$')
-    return dir ~= '' and dir or '.', file
+--- Execute the benchmark file and print the report
+--- @param file table The loaded benchmark file
+--- @param filter table<string, boolean>? The names of the describes to run
+--- @return table? results The benchmark results
+local function exec_file(file, filter)
+    printf('## Exec: %s', file.pathname)
+    print()
+
+    -- run the benchmark in the directory of the file
+    local analyses = {}
+    local results, err = pcall_in_dir(file.dirname, do_benchmark, file.spec,
+                                      filter, analyses)
+
+    -- print the results or error message
+    print()
+    if results then
+        report(results, analyses):render()
+    else
+        print(err)
+    end
+    return results
+end
+
+--- Run the benchmark files and write the samples to the file instead of
+--- printing the report
+--- @param files table[] The loaded benchmark files
+--- @param pathname string The pathname of the file to write
+local function export_files(files, pathname)
+    local dumps = {}
+    for _, file in ipairs(files) do
+        printf('## Exec: %s', file.pathname)
+        print()
+        local results, err = pcall_in_dir(file.dirname, do_benchmark,
+                                          file.spec, nil, {})
+        if not results then
+            print(err)
+            os.exit(1)
+        end
+        for _, samples in ipairs(results) do
+            dumps[#dumps + 1] = samples:dump()
+        end
+    end
+
+    local src = assert(serialize.encode({
+        version = RUNTIME_VERSION,
+        results = dumps,
+    }))
+    local f = assert(io.open(pathname, 'w'))
+    assert(f:write(src))
+    f:close()
+end
+
+--- Run the benchmark file under the Lua runtime in a child process
+--- @param runtime string The command of the Lua interpreter
+--- @param file table The loaded benchmark file
+--- @return table? result The runtime, version and results (measure.samples[])
+--- @return any err Error message if failed
+local function exec_runtime(runtime, file)
+    local tmpname = os.tmpname()
+    local cmd = format('%s %s --export=%s %s', runtime, shell_quote(SCRIPT),
+                       shell_quote(tmpname), shell_quote(file.pathname))
+    if not execute(cmd) then
+        os.remove(tmpname)
+        return nil, format('failed to run %q', cmd)
+    end
+
+    local f, err = io.open(tmpname, 'r')
+    if not f then
+        os.remove(tmpname)
+        return nil, err
+    end
+    local src = f:read('*a')
+    f:close()
+    os.remove(tmpname)
+
+    local res
+    res, err = serialize.decode(src)
+    if type(res) ~= 'table' then
+        return nil, format('invalid results of %q: %s', runtime,
+                           tostring(err or src))
+    end
+
+    local results = {}
+    for i, dump in ipairs(res.results) do
+        results[i] = assert(new_samples(dump))
+    end
+    return {
+        runtime = runtime,
+        version = res.version,
+        results = results,
+    }
+end
+
+--- Run the benchmark file under each Lua runtime and print the comparison
+--- @param file table The loaded benchmark file
+--- @param runtimes string[] The commands of the Lua interpreters
+local function exec_file_runtimes(file, runtimes)
+    printf('## Exec: %s', file.pathname)
+    print()
+
+    local columns = {}
+    for _, runtime in ipairs(runtimes) do
+        printf('### Runtime: %s', runtime)
+        print()
+        local res, err = exec_runtime(runtime, file)
+        if res then
+            columns[#columns + 1] = res
+        else
+            printf('ERROR: %s', err)
+        end
+        print()
+    end
+
+    local matrix = render_matrix(columns)
+    if matrix then
+        print('### Runtime Comparison')
+        print()
+        print('*Compared with the first runtime by Welch\'s t-test.*')
+        print()
+        print(matrix)
+        print()
+    end
+end
+
+--- Run the command and read its output
+--- @param cmd string The command to run
+--- @return string? output The output without the trailing newlines, or nil
+---                        if the command printed nothing
+local function read_command(cmd)
+    local f = io.popen(cmd .. ' 2>/dev/null', 'r')
+    if not f then
+        return nil
+    end
+    local out = f:read('*a')
+    f:close()
+    out = match(out, '^(.-)%s*$')
+    return out ~= '' and out or nil
+end
+
+--- Get the samples of the describe at the revision.
+--- The revision is checked out into a temporary worktree, built by the build
+--- command, and the describe is run with the modules of the worktree like the
+--- variant of the A/B comparison. The samples are stored in the record
+--- directory and reused while the benchmark file is not changed.
+--- @param bisect table The bisect arguments
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param rev string The full commit hash of the revision
+--- @return measure.samples? samples The samples object with collected data
+--- @return any err Error message if failed
+local function sample_revision(bisect, desc, opts, rev)
+    local record = format('%s/%s-%s.lua', bisect.record_dir, rev,
+                          (desc.spec.name:gsub('[^%w%-_.]', '_')))
+    local f = io.open(record, 'r')
+    if f then
+        local dump = serialize.decode(f:read('*a'))
+        f:close()
+        if type(dump) == 'table' and dump.source == bisect.source and
+            dump.sample_size == opts.sample_size then
+            printf('  - Reuse the samples in %s', record)
+            return new_samples(dump.samples)
+        end
+    end
+
+    local dir = os.tmpname()
+    os.remove(dir)
+    if not execute(format('git worktree add --detach %s %s >/dev/null 2>&1',
+                          shell_quote(dir), rev)) then
+        return nil, format('failed to check out %s', rev)
+    end
+
+    local ok = true
+    local samples, err
+    if bisect.build then
+        printf('  - Build: %s', bisect.build)
+        ok = execute(format('cd %s && %s', shell_quote(dir), bisect.build))
+        if not ok then
+            err = format('failed to build %s', rev)
+        end
+    end
+    if ok then
+        samples, err = sample_variant(desc, opts, dir .. '/' .. bisect.root)
+    end
+    execute(format('git worktree remove --force %s', shell_quote(dir)))
+    if not samples then
+        return nil, err
+    end
+
+    -- store the samples for the next run
+    execute(format('mkdir -p %s', shell_quote(bisect.record_dir)))
+    f = io.open(record, 'w')
+    if f then
+        f:write(assert(serialize.encode({
+            source = bisect.source,
+            sample_size = opts.sample_size,
+            samples = samples:dump(),
+        })))
+        f:close()
+    end
+    return samples
+end
+
+--- Search the first revision between the good and bad revisions that makes
+--- the describe slower.
+--- @param args table The command line arguments
+--- @return boolean ok True if the first bad revision is found
+local function exec_bisect(args)
+    local bisect = args.bisect
+    local pathname = abspath(args.pathname)
+    printf('## Bisect: %s (%s)', pathname, bisect.describe)
+    print()
+
+    local f, err = io.open(pathname, 'r')
+    if not f then
+        printf('ERROR: %s', err)
+        return false
+    end
+    bisect.source = f:read('*a')
+    f:close()
+    bisect.record_dir = args.record_dir .. '/bisect'
+
+    -- find the describe in the benchmark file
+    local file
+    file, err = load_file(pathname)
+    if not file then
+        print(err)
+        return false
+    end
+    local desc
+    for _, v in ipairs(file.spec.describes) do
+        if v.spec.name == bisect.describe then
+            desc = v
+        end
+    end
+    if not desc then
+        printf('ERROR: describe %q not found', bisect.describe)
+        return false
+    end
+    local opts = describe_opts(desc)
+    opts.sample_size = bisect.samples or BISECT_SAMPLES
+
+    -- list the revisions from the good revision to the bad revision
+    local good = read_command(format('git rev-parse --verify %s',
+                                     shell_quote(bisect.good .. '^{commit}')))
+    local bad = read_command(format('git rev-parse --verify %s',
+                                    shell_quote(bisect.bad .. '^{commit}')))
+    if not good or not bad then
+        printf('ERROR: unknown revision %q', good and bisect.bad or bisect.good)
+        return false
+    end
+    local revs = {
+        [0] = good,
+    }
+    local list = read_command(format(
+                                  'git rev-list --reverse --ancestry-path %s..%s',
+                                  good, bad))
+    for rev in gmatch(list or '', '%x+') do
+        revs[#revs + 1] = rev
+    end
+    if revs[#revs] ~= bad then
+        printf('ERROR: %s is not an ancestor of %s', bisect.good, bisect.bad)
+        return false
+    end
+
+    -- measure the revision and judge it with the good samples
+    local steps = {}
+    local good_samples
+    local function test(i)
+        local rev = revs[i]
+        local subject = read_command(format('git log -1 --format=%%s %s', rev))
+        local short = read_command(format('git rev-parse --short %s', rev))
+        printf('- Revision %s: %s', short, subject or '')
+        local samples, serr = sample_revision(bisect, desc, opts, rev)
+        if not samples then
+            return nil, format('ERROR: revision %s: %s', short, serr)
+        end
+
+        local step = {
+            index = i,
+            revision = short,
+            subject = subject,
+            samples = samples,
+        }
+        steps[#steps + 1] = step
+        if i == 0 then
+            good_samples = samples
+            return false
+        end
+        local res = bisect_judge(good_samples, samples, bisect.threshold)
+        step.ratio = res.ratio
+        step.p_value = res.p_value
+        step.bad = res.bad
+        printf('  - %.3fx of good (p-value %.4f): %s', res.ratio, res.p_value,
+               res.bad and 'bad' or 'good')
+        return res.bad
+    end
+
+    local is_bad
+    is_bad, err = test(0)
+    if is_bad ~= nil then
+        is_bad, err = test(#revs)
+    end
+    local idx
+    if is_bad then
+        idx, err = bisect_search(#revs, test)
+    elseif is_bad == false then
+        err = format('ERROR: %s is not slower than %s', bisect.bad, bisect.good)
+    end
+
+    print()
+    sort(steps, function(a, b)
+        return a.index < b.index
+    end)
+    if #steps > 1 then
+        print('### Bisect Result')
+        print()
+        printf(
+            '*Compared with the good revision by Welch\'s t-test. Bad is a significant slowdown of more than %g%%.*',
+            bisect.threshold)
+        print()
+        print(render_bisect(steps))
+        print()
+    end
+    if not idx then
+        print(err)
+        return false
+    end
+    printf('First bad revision: %s %s', revs[idx],
+           read_command(format('git log -1 --format=%%s %s', revs[idx])) or '')
+    return true
+end
+
+--- Get the fingerprints of the hooks and describes of the benchmark spec
+--- @param spec table The benchmark specification
+--- @return table fingerprints The fingerprints
+local function fingerprint_spec(spec)
+    local fps = {
+        hooks = watch.fingerprint(spec.hooks),
+        describes = {},
+    }
+    local fns = {}
+    for _, desc in ipairs(spec.describes) do
+        fps.describes[desc.spec.name] = watch.fingerprint(desc.spec)
+        for _, v in pairs(desc.spec) do
+            if type(v) == 'function' then
+                fns[#fns + 1] = v
+            end
+        end
+    end
+    -- the code shared by the describes, e.g. file-level locals and helpers
+    fps.outside = watch.fingerprint_outside(fns)
+    return fps
+end
+
+--- Watch the benchmark file and its dependencies
+--- @param w measure.watch The watch object
+--- @param file table The loaded benchmark file
+--- @param prev table<string, boolean>? The dependencies watched for the
+---                                     previous load of the file
+local function watch_file(w, file, prev)
+    local dir = abspath(file.dirname)
+    file.abspath = abspath(file.pathname)
+    file.fingerprints = pcall_in_dir(file.dirname, fingerprint_spec, file.spec)
+    file.watched_deps = {}
+    if not prev then
+        assert(w:add(file.abspath))
+    end
+    for _, pathname in pairs(file.deps) do
+        pathname = abspath(pathname, dir)
+        if not file.watched_deps[pathname] then
+            file.watched_deps[pathname] = true
+            if not (prev and prev[pathname]) then
+                assert(w:add(pathname))
+            end
+        end
+    end
+
+    -- stop watching the dependencies that are no longer required
+    for pathname in pairs(prev or {}) do
+        if not file.watched_deps[pathname] then
+            assert(w:remove(pathname))
+        end
+    end
+end
+
+--- Group the samples by the describe that produced them. The options that
+--- run the describe as variants name the samples `<name> [<variant>]`.
+--- @param names string[] The names of the describes
+--- @param list measure.samples[] The samples
+--- @return table<string, measure.samples[]> groups The samples by describe
+local function group_by_describe(names, list)
+    local groups = {}
+    for _, samples in ipairs(list) do
+        local sname = samples:name()
+        -- the longest describe name that the samples name starts with
+        local found
+        for _, name in ipairs(names) do
+            if (sname == name or sub(sname, 1, #name + 2) == name .. ' [') and
+                (not found or #name > #found) then
+                found = name
+            end
+        end
+        if found then
+            local group = groups[found] or {}
+            groups[found] = group
+            group[#group + 1] = samples
+        end
+    end
+    return groups
+end
+
+--- Reload the changed benchmark file and re-run the affected describes
+--- @param w measure.watch The watch object
+--- @param file table The loaded benchmark file
+--- @param all boolean If true, all describes are re-run
+local function rerun_file(w, file, all)
+    -- unload the dependent modules to load the latest ones
+    for modname in pairs(file.deps) do
+        package.loaded[modname] = nil
+    end
+
+    local newfile, err = load_file(file.pathname)
+    if not newfile then
+        printf('ERROR: failed to reload %s: %s', file.pathname,
+               err or 'no benchmark spec found')
+        print()
+        return
+    end
+
+    -- re-run only the describes that have been changed or added unless the
+    -- hooks, the code outside the describes or the dependent modules have
+    -- been changed
+    local fps = pcall_in_dir(newfile.dirname, fingerprint_spec, newfile.spec)
+    local filter
+    if not all and fps.hooks == file.fingerprints.hooks and fps.outside ==
+        file.fingerprints.outside then
+        filter = {}
+        for name, fp in pairs(fps.describes) do
+            if file.fingerprints.describes[name] ~= fp then
+                filter[name] = true
+            end
+        end
+        if not next(filter) then
+            printf('No benchmarks affected in %s', file.pathname)
+            print()
+            return
+        end
+    end
+
+    local results = exec_file(newfile, filter)
+    if not results then
+        return
+    end
+
+    -- print the differences from the previous results
+    local diff = render_diff(file.results, results)
+    if diff then
+        print('### Changes from the Previous Run')
+        print()
+        print(diff)
+    end
+
+    -- keep the previous results of the describes that were not re-run
+    local names = {}
+    for _, desc in ipairs(newfile.spec.describes) do
+        names[#names + 1] = desc.spec.name
+    end
+    local prev = group_by_describe(names, file.results)
+    local curr = group_by_describe(names, results)
+    newfile.results = {}
+    for _, name in ipairs(names) do
+        for _, samples in ipairs(curr[name] or prev[name] or {}) do
+            newfile.results[#newfile.results + 1] = samples
+        end
+    end
+
+    -- replace the previous state of the file
+    local prev = file.watched_deps
+    for k in pairs(file) do
+        file[k] = nil
+    end
+    for k, v in pairs(newfile) do
+        file[k] = v
+    end
+    watch_file(w, file, prev)
+end
+
+--- Watch the benchmark files and re-run the benchmarks when they change
+--- @param files table[] The loaded benchmark files
+local function watch_files(files)
+    local w, err = watch.new()
+    if not w then
+        printf('ERROR: %s', err)
+        os.exit(1)
+    end
+    for _, file in ipairs(files) do
+        watch_file(w, file)
+    end
+
+    while true do
+        print('Watching for changes... (press Ctrl+C to stop)')
+        print()
+        local changed
+        changed, err = w:wait()
+        if not changed then
+            printf('ERROR: %s', err)
+            os.exit(1)
+        end
+
+        local changed_set = {}
+        for _, pathname in ipairs(changed) do
+            printf('Changed: %s', pathname)
+            changed_set[pathname] = true
+        end
+        print()
+
+        watch.clear_cache()
+        for _, file in ipairs(files) do
+            local dep_changed = false
+            for pathname in pairs(file.watched_deps) do
+                dep_changed = dep_changed or changed_set[pathname] == true
+            end
+            if dep_changed or changed_set[file.abspath] then
+                rerun_file(w, file, dep_changed)
+            end
+        end
+    end
+end
+
+--- Measure the timing jitter of the host and check it against the threshold
+--- @param args table The command line arguments
+--- @return string noise The formatted noise information
+--- @return string? warning The warning message if the jitter is too high
+local function check_noise(args)
+    local res = calibrate()
+    local warning
+    if args.noise_threshold and res.cv > args.noise_threshold then
+        warning = format('timing jitter %.2f%% exceeds the threshold %.2f%%',
+                         res.cv, args.noise_threshold)
+        if args.noise_action == 'abort' then
+            print(warning)
+            os.exit(1)
+        elseif args.noise_action == 'raise' then
+            max_sample_size = MAX_SAMPLE_SIZE_NOISY
+            warning = format('%s, raised the maximum number of samples to %d',
+                             warning, max_sample_size)
+        end
+    end
+
+    -- the best RCIW achievable at 95% confidence level on this host
+    local min_rciw = 2 * quantile(0.95) * res.cv / sqrt(max_sample_size)
+    local noise = format(
+                      'cv=%.2f%%, spikes=%.2f%% (>10x median), median=%s, min RCIW=%.2f%% at %d samples',
+                      res.cv, res.spike_rate, fmt.time(res.median), min_rciw,
+                      max_sample_size)
+    return noise, warning
 end
 
 do
     local ARGS = parse_argv()
-    local pathnames, err = listfiles(ARGS.pathname)
+    if ARGS.bisect then
+        print()
+        print('# Bisect Report')
+        print()
+        print('```')
+        for k, v in pairs(report_sysinfo()) do
+            printf('%-8s: %s', k, v)
+        end
+        print('```')
+        print()
+        os.exit(exec_bisect(ARGS) and 0 or 1)
+    end
+
+    local pathnames, err = listfiles(ARGS.pathname, {
+        recursive = ARGS.recursive,
+        include = ARGS.include,
+        exclude = ARGS.exclude,
+    })
     if not pathnames then
         print(err)
         os.exit(1)
@@ -275,15 +1102,12 @@ do
 
     local target_files = {}
     for _, pathname in ipairs(pathnames) do
-        local dir, filename = dirname(pathname)
         local file
-        file, err = pcall_in_dir(dir, loadfile, filename)
+        file, err = load_file(pathname)
         if not file then
             print(err)
             os.exit(1)
         end
-        file.pathname = pathname
-        file.dirname = dir
         target_files[#target_files + 1] = file
     end
     if #target_files == 0 then
@@ -292,34 +1116,44 @@ do
         os.exit(1)
     end
 
+    if ARGS.export then
+        -- run under the parent process of the --lua option
+        export_files(target_files, ARGS.export)
+        return
+    end
+
     print()
     print('# Benchmark Reports')
     print()
 
     -- Environment information
+    local info = report_sysinfo()
+    local warning
+    info.Noise, warning = check_noise(ARGS)
+    if warning then
+        info.Warning = info.Warning and (info.Warning .. '; ' .. warning) or
+                           warning
+    end
     print('```')
-    for k, v in pairs(report_sysinfo()) do
+    for k, v in pairs(info) do
         printf('%-8s: %s', k, v)
     end
     print('```')
     print()
 
-    for _, file in ipairs(target_files) do
-        printf('## Exec: %s', file.pathname)
-        print()
+    if ARGS.lua then
+        for _, file in ipairs(target_files) do
+            exec_file_runtimes(file, ARGS.lua)
+        end
+        return
+    end
 
-        -- run the benchmark in the directory of the file
-        local results
-        results, err = pcall_in_dir(file.dirname, do_benchmark, file.spec)
+    for _, file in ipairs(target_files) do
+        file.results = exec_file(file) or {}
+    end
 
-        -- print the results or error message
-        print()
-        if results then
-            report(results):render()
-        else
-            print(err)
-        end
+    if ARGS.watch then
+        watch_files(target_files)
     end
     return
 end
-
@@ -0,0 +1,79 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.bisect
+-- This module searches the first revision that makes the benchmark slower
+--
+local floor = math.floor
+local welcht = require('measure.posthoc.welcht')
+
+--- Judge whether the samples of the revision are slower than the samples of
+--- the good revision.
+--- The revision is bad if the Welch's t-test finds the difference significant
+--- at the confidence level of the good samples, and the mean is slower than
+--- the good mean by more than the threshold.
+--- @param good measure.samples The samples of the good revision
+--- @param samples measure.samples The samples of the revision to judge
+--- @param threshold number The minimum slowdown to consider as bad (percent)
+--- @return table result The ratio to the good mean, p-value and verdict
+local function judge(good, samples, threshold)
+    local result = {
+        ratio = samples:mean() / good:mean(), -- Ratio of the mean to good
+        p_value = welcht({
+            good,
+            samples,
+        })[1].p_value, -- Two-sided p-value of the Welch's t-test
+        bad = false, -- True if the revision is slower than good
+    }
+    result.bad = result.p_value < 1 - good:cl() / 100 and result.ratio > 1 +
+                     threshold / 100
+    return result
+end
+
+--- Search the first bad revision by binary search.
+--- The revisions are indexed from 0 (the good revision) to n (the bad
+--- revision), and the revisions between them are tested in the order of the
+--- binary search.
+--- @param n integer The index of the bad revision
+--- @param test fun(i:integer):(boolean?, any) The function to test whether
+---                                             the i-th revision is bad
+--- @return integer? index The index of the first bad revision
+--- @return any err Error message if the test failed
+local function search(n, test)
+    local good, bad = 0, n
+    while bad - good > 1 do
+        local mid = floor((good + bad) / 2)
+        local is_bad, err = test(mid)
+        if is_bad == nil then
+            return nil, err
+        elseif is_bad then
+            bad = mid
+        else
+            good = mid
+        end
+    end
+    return bad
+end
+
+return {
+    judge = judge,
+    search = search,
+}
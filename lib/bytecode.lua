@@ -0,0 +1,690 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.bytecode
+-- This module decodes the bytecode of string.dump() of Lua 5.1 to 5.4 to
+-- classify the VM instructions of each source line of a function
+--
+local type = type
+local pairs = pairs
+local ipairs = ipairs
+local error = error
+local pcall = pcall
+local setmetatable = setmetatable
+local byte = string.byte
+local sub = string.sub
+local dump = string.dump
+
+--- Opcodes of each version in the order of their numbers
+local OPCODES = {
+    [0x51] = {
+        'MOVE',
+        'LOADK',
+        'LOADBOOL',
+        'LOADNIL',
+        'GETUPVAL',
+        'GETGLOBAL',
+        'GETTABLE',
+        'SETGLOBAL',
+        'SETUPVAL',
+        'SETTABLE',
+        'NEWTABLE',
+        'SELF',
+        'ADD',
+        'SUB',
+        'MUL',
+        'DIV',
+        'MOD',
+        'POW',
+        'UNM',
+        'NOT',
+        'LEN',
+        'CONCAT',
+        'JMP',
+        'EQ',
+        'LT',
+        'LE',
+        'TEST',
+        'TESTSET',
+        'CALL',
+        'TAILCALL',
+        'RETURN',
+        'FORLOOP',
+        'FORPREP',
+        'TFORLOOP',
+        'SETLIST',
+        'CLOSE',
+        'CLOSURE',
+        'VARARG',
+    },
+    [0x52] = {
+        'MOVE',
+        'LOADK',
+        'LOADKX',
+        'LOADBOOL',
+        'LOADNIL',
+        'GETUPVAL',
+        'GETTABUP',
+        'GETTABLE',
+        'SETTABUP',
+        'SETUPVAL',
+        'SETTABLE',
+        'NEWTABLE',
+        'SELF',
+        'ADD',
+        'SUB',
+        'MUL',
+        'DIV',
+        'MOD',
+        'POW',
+        'UNM',
+        'NOT',
+        'LEN',
+        'CONCAT',
+        'JMP',
+        'EQ',
+        'LT',
+        'LE',
+        'TEST',
+        'TESTSET',
+        'CALL',
+        'TAILCALL',
+        'RETURN',
+        'FORLOOP',
+        'FORPREP',
+        'TFORCALL',
+        'TFORLOOP',
+        'SETLIST',
+        'CLOSURE',
+        'VARARG',
+        'EXTRAARG',
+    },
+    [0x53] = {
+        'MOVE',
+        'LOADK',
+        'LOADKX',
+        'LOADBOOL',
+        'LOADNIL',
+        'GETUPVAL',
+        'GETTABUP',
+        'GETTABLE',
+        'SETTABUP',
+        'SETUPVAL',
+        'SETTABLE',
+        'NEWTABLE',
+        'SELF',
+        'ADD',
+        'SUB',
+        'MUL',
+        'MOD',
+        'POW',
+        'DIV',
+        'IDIV',
+        'BAND',
+        'BOR',
+        'BXOR',
+        'SHL',
+        'SHR',
+        'UNM',
+        'BNOT',
+        'NOT',
+        'LEN',
+        'CONCAT',
+        'JMP',
+        'EQ',
+        'LT',
+        'LE',
+        'TEST',
+        'TESTSET',
+        'CALL',
+        'TAILCALL',
+        'RETURN',
+        'FORLOOP',
+        'FORPREP',
+        'TFORCALL',
+        'TFORLOOP',
+        'SETLIST',
+        'CLOSURE',
+        'VARARG',
+        'EXTRAARG',
+    },
+    [0x54] = {
+        'MOVE',
+        'LOADI',
+        'LOADF',
+        'LOADK',
+        'LOADKX',
+        'LOADFALSE',
+        'LFALSESKIP',
+        'LOADTRUE',
+        'LOADNIL',
+        'GETUPVAL',
+        'SETUPVAL',
+        'GETTABUP',
+        'GETTABLE',
+        'GETI',
+        'GETFIELD',
+        'SETTABUP',
+        'SETTABLE',
+        'SETI',
+        'SETFIELD',
+        'NEWTABLE',
+        'SELF',
+        'ADDI',
+        'ADDK',
+        'SUBK',
+        'MULK',
+        'MODK',
+        'POWK',
+        'DIVK',
+        'IDIVK',
+        'BANDK',
+        'BORK',
+        'BXORK',
+        'SHRI',
+        'SHLI',
+        'ADD',
+        'SUB',
+        'MUL',
+        'MOD',
+        'POW',
+        'DIV',
+        'IDIV',
+        'BAND',
+        'BOR',
+        'BXOR',
+        'SHL',
+        'SHR',
+        'MMBIN',
+        'MMBINI',
+        'MMBINK',
+        'UNM',
+        'BNOT',
+        'NOT',
+        'LEN',
+        'CONCAT',
+        'CLOSE',
+        'TBC',
+        'JMP',
+        'EQ',
+        'LT',
+        'LE',
+        'EQK',
+        'EQI',
+        'LTI',
+        'LEI',
+        'GTI',
+        'GEI',
+        'TEST',
+        'TESTSET',
+        'CALL',
+        'TAILCALL',
+        'RETURN',
+        'RETURN0',
+        'RETURN1',
+        'FORLOOP',
+        'FORPREP',
+        'TFORPREP',
+        'TFORCALL',
+        'TFORLOOP',
+        'SETLIST',
+        'CLOSURE',
+        'VARARG',
+        'VARARGPREP',
+        'EXTRAARG',
+    },
+}
+
+--- Class of the opcodes that are not listed is 'arithmetic'
+local CLASSES = {
+    ['load'] = {
+        'MOVE',
+        'LOADI',
+        'LOADF',
+        'LOADK',
+        'LOADKX',
+        'LOADFALSE',
+        'LFALSESKIP',
+        'LOADTRUE',
+        'LOADBOOL',
+        'LOADNIL',
+    },
+    ['upvalue'] = {
+        'GETUPVAL',
+        'SETUPVAL',
+    },
+    ['global access'] = {
+        'GETGLOBAL',
+        'SETGLOBAL',
+        'GETTABUP',
+        'SETTABUP',
+    },
+    ['table access'] = {
+        'GETTABLE',
+        'GETI',
+        'GETFIELD',
+        'SETTABLE',
+        'SETI',
+        'SETFIELD',
+        'SELF',
+        'LEN',
+    },
+    ['constructor'] = {
+        'NEWTABLE',
+        'SETLIST',
+        'CLOSURE',
+    },
+    ['string concat'] = {
+        'CONCAT',
+    },
+    ['comparison'] = {
+        'NOT',
+        'EQ',
+        'LT',
+        'LE',
+        'EQK',
+        'EQI',
+        'LTI',
+        'LEI',
+        'GTI',
+        'GEI',
+        'TEST',
+        'TESTSET',
+    },
+    ['control flow'] = {
+        'JMP',
+        'FORLOOP',
+        'FORPREP',
+        'TFORPREP',
+        'TFORLOOP',
+        'CLOSE',
+        'TBC',
+    },
+    ['call'] = {
+        'CALL',
+        'TAILCALL',
+        'TFORCALL',
+        'RETURN',
+        'RETURN0',
+        'RETURN1',
+        'VARARG',
+        'VARARGPREP',
+    },
+    ['other'] = {
+        'EXTRAARG',
+    },
+}
+local CLASS_OF = {}
+for class, names in pairs(CLASSES) do
+    for _, name in ipairs(names) do
+        CLASS_OF[name] = class
+    end
+end
+
+--- Opcodes that are usually skipped, e.g. the fallback of the arithmetic to
+--- the metamethods of Lua 5.4, which are not weighted in line_classes()
+local SKIPPED = {
+    MMBIN = true,
+    MMBINI = true,
+    MMBINK = true,
+    EXTRAARG = true,
+}
+
+--- Get the class of the opcode
+--- @param opname string The name of the opcode (e.g. 'GETFIELD')
+--- @return string class The class of the opcode (e.g. 'table access')
+local function classify(opname)
+    return CLASS_OF[opname] or 'arithmetic'
+end
+
+--- @class measure.bytecode.reader
+--- @field str string The dumped chunk
+--- @field pos integer The position of the next byte
+--- @field version integer The version number (e.g. 0x54)
+--- @field little boolean True if the chunk is little endian
+--- @field sizeint integer sizeof(int)
+--- @field sizesize integer sizeof(size_t)
+--- @field sizeinst integer sizeof(Instruction)
+--- @field sizeinteger integer sizeof(lua_Integer)
+--- @field sizenumber integer sizeof(lua_Number)
+local Reader = {}
+Reader.__index = Reader
+
+--- Read the bytes
+--- @param n integer The number of bytes
+--- @return string bytes
+function Reader:bytes(n)
+    local pos = self.pos
+    if pos + n - 1 > #self.str then
+        error('truncated chunk', 0)
+    end
+    self.pos = pos + n
+    return sub(self.str, pos, pos + n - 1)
+end
+
+--- Read a byte
+--- @return integer
+function Reader:byte()
+    return byte(self:bytes(1))
+end
+
+--- Read an unsigned integer of the size in the byte order of the chunk
+--- @param n integer The size of the integer
+--- @return integer
+function Reader:uint(n)
+    local s = self:bytes(n)
+    local v = 0
+    if self.little then
+        for i = n, 1, -1 do
+            v = v * 256 + byte(s, i)
+        end
+    else
+        for i = 1, n do
+            v = v * 256 + byte(s, i)
+        end
+    end
+    return v
+end
+
+--- Read an int of the chunk
+--- @return integer
+function Reader:int()
+    if self.version == 0x54 then
+        -- variable length integer from the most significant 7 bits
+        local v = 0
+        repeat
+            local b = self:byte()
+            v = v * 128 + b % 128
+        until b >= 128
+        return v
+    end
+    return self:uint(self.sizeint)
+end
+
+--- Read a string of the chunk
+--- @return string? str The string, or nil for NULL
+function Reader:string()
+    local size
+    if self.version == 0x54 then
+        size = self:int()
+    elseif self.version == 0x53 then
+        size = self:byte()
+        if size == 0xFF then
+            size = self:uint(self.sizesize)
+        end
+    else
+        -- the size includes the trailing '\0'
+        size = self:uint(self.sizesize)
+        if size > 0 then
+            local s = self:bytes(size)
+            return sub(s, 1, -2)
+        end
+    end
+    if size == 0 then
+        return nil
+    end
+    return self:bytes(size - 1)
+end
+
+--- Read the header of the chunk
+function Reader:header()
+    if self:bytes(4) ~= '\27Lua' then
+        error('not a Lua bytecode', 0)
+    end
+    local version = self:byte()
+    if not OPCODES[version] then
+        error('unsupported bytecode version', 0)
+    end
+    self.version = version
+    self:byte() -- format
+
+    if version <= 0x52 then
+        self.little = self:byte() == 1
+        self.sizeint = self:byte()
+        self.sizesize = self:byte()
+        self.sizeinst = self:byte()
+        self.sizenumber = self:byte()
+        self:byte() -- integral
+        if version == 0x52 then
+            self:bytes(6) -- LUAC_TAIL
+        end
+        return
+    end
+
+    self:bytes(6) -- LUAC_DATA
+    if version == 0x53 then
+        self.sizeint = self:byte()
+        self.sizesize = self:byte()
+    end
+    self.sizeinst = self:byte()
+    self.sizeinteger = self:byte()
+    self.sizenumber = self:byte()
+    -- LUAC_INT is 0x5678
+    self.little = byte(self:bytes(self.sizeinteger), 1) == 0x78
+    self:bytes(self.sizenumber) -- LUAC_NUM
+    self:byte() -- sizeupvalues
+end
+
+--- Read the instructions and return their opcode names
+--- @return string[] ops
+function Reader:code()
+    local names = OPCODES[self.version]
+    -- the opcode is the lowest 6 bits, or 7 bits in Lua 5.4
+    local mask = self.version == 0x54 and 128 or 64
+    local n = self:int()
+    local ops = {}
+    for i = 1, n do
+        local s = self:bytes(self.sizeinst)
+        local b = self.little and byte(s, 1) or byte(s, -1)
+        ops[i] = names[b % mask + 1] or 'UNKNOWN'
+    end
+    return ops
+end
+
+--- Skip the constants
+function Reader:constants()
+    local version = self.version
+    for _ = 1, self:int() do
+        local t = self:byte()
+        if version == 0x54 then
+            if t == 3 then -- LUA_VNUMINT
+                self:bytes(self.sizeinteger)
+            elseif t == 19 then -- LUA_VNUMFLT
+                self:bytes(self.sizenumber)
+            elseif t == 4 or t == 20 then -- LUA_VSHRSTR, LUA_VLNGSTR
+                self:string()
+            end
+        elseif t == 1 then -- LUA_TBOOLEAN
+            self:byte()
+        elseif t == 3 then -- LUA_TNUMBER, LUA_TNUMFLT
+            self:bytes(self.sizenumber)
+        elseif t == 19 then -- LUA_TNUMINT
+            self:bytes(self.sizeinteger)
+        elseif t == 4 or t == 20 then -- LUA_TSTRING, LUA_TLNGSTR
+            self:string()
+        end
+    end
+end
+
+--- Skip the upvalues
+function Reader:upvalues()
+    local size = self.version == 0x54 and 3 or 2
+    self:bytes(self:int() * size)
+end
+
+--- Read the line of each instruction
+--- @param f table The function
+--- @return integer[] lines
+function Reader:lineinfo(f)
+    local lines = {}
+    if self.version ~= 0x54 then
+        for i = 1, self:int() do
+            lines[i] = self:uint(self.sizeint)
+        end
+        return lines
+    end
+
+    -- the differences from the previous line, or -128 for the absolute line
+    local deltas = {}
+    for i = 1, self:int() do
+        local d = self:byte()
+        deltas[i] = d >= 128 and d - 256 or d
+    end
+    local abs = {}
+    for _ = 1, self:int() do
+        local pc = self:int()
+        abs[pc + 1] = self:int()
+    end
+    local line = f.linedefined
+    for i, d in ipairs(deltas) do
+        if d == -128 then
+            line = abs[i] or line
+        else
+            line = line + d
+        end
+        lines[i] = line
+    end
+    return lines
+end
+
+--- Skip the local variables and the names of the upvalues
+function Reader:names()
+    for _ = 1, self:int() do
+        self:string()
+        self:int()
+        self:int()
+    end
+    for _ = 1, self:int() do
+        self:string()
+    end
+end
+
+--- @class measure.bytecode.proto
+--- @field source string? The source of the function
+--- @field linedefined integer The line where the function is defined
+--- @field lastlinedefined integer The line where the function ends
+--- @field ops string[] The opcode names of the instructions
+--- @field lines integer[] The lines of the instructions
+--- @field protos measure.bytecode.proto[] The nested functions
+
+--- Read a function
+--- @param psource string? The source of the enclosing function
+--- @return measure.bytecode.proto
+function Reader:func(psource)
+    local version = self.version
+    local f = {
+        protos = {},
+    }
+    if version ~= 0x52 then
+        f.source = self:string() or psource
+    end
+    f.linedefined = self:int()
+    f.lastlinedefined = self:int()
+    if version == 0x51 then
+        self:byte() -- nups
+    end
+    self:bytes(3) -- numparams, is_vararg, maxstacksize
+    f.ops = self:code()
+    self:constants()
+
+    if version == 0x51 or version == 0x52 then
+        for i = 1, self:int() do
+            f.protos[i] = self:func(f.source)
+        end
+        if version == 0x52 then
+            self:upvalues()
+            f.source = self:string() or psource
+            for i = 1, #f.protos do
+                f.protos[i].source = f.protos[i].source or f.source
+            end
+        end
+    else
+        self:upvalues()
+        for i = 1, self:int() do
+            f.protos[i] = self:func(f.source)
+        end
+    end
+
+    f.lines = self:lineinfo(f)
+    self:names()
+    return f
+end
+
+--- Decode the dumped chunk
+--- @param str string The chunk of string.dump()
+--- @return measure.bytecode.proto? proto The main function of the chunk
+--- @return any err Error message if failed
+local function decode(str)
+    if type(str) ~= 'string' then
+        error('str must be a string', 2)
+    end
+    local reader = setmetatable({
+        str = str,
+        pos = 1,
+    }, Reader)
+    local ok, res = pcall(function()
+        reader:header()
+        return reader:func(nil)
+    end)
+    if not ok then
+        return nil, res
+    end
+    return res
+end
+
+--- Count the instructions of each class on each line of the function.
+--- The opcodes that are usually skipped are not counted.
+--- @param fn function The Lua function
+--- @return table<integer, table<string, integer>>? lines The number of
+---                                                      instructions by class
+---                                                      on each line
+--- @return any err Error message if failed
+local function line_classes(fn)
+    local ok, str = pcall(dump, fn)
+    if not ok then
+        return nil, str
+    end
+    local f, err = decode(str)
+    if not f then
+        return nil, err
+    end
+
+    local lines = {}
+    for i, op in ipairs(f.ops) do
+        local line = f.lines[i]
+        if line and not SKIPPED[op] then
+            local classes = lines[line]
+            if not classes then
+                classes = {}
+                lines[line] = classes
+            end
+            local class = classify(op)
+            classes[class] = (classes[class] or 0) + 1
+        end
+    end
+    return lines
+end
+
+return {
+    decode = decode,
+    classify = classify,
+    line_classes = line_classes,
+}
@@ -0,0 +1,307 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.census
+-- This module counts the objects reachable from the registry and the globals
+-- by type and by site, and compares two censuses
+--
+local type = type
+local next = next
+local pairs = pairs
+local rawget = rawget
+local tostring = tostring
+local format = string.format
+local find = string.find
+local sort = table.sort
+local getmetatable = debug.getmetatable
+local getinfo = debug.getinfo
+local getupvalue = debug.getupvalue
+local getregistry = debug.getregistry
+local getuservalue = debug.getuservalue
+local getfenv = debug.getfenv
+
+--- Estimated sizes in bytes of the objects on a 64-bit platform.
+--- Lua does not expose the size of an object, so the census estimates it from
+--- the layout of the object headers and the number of elements.
+local SIZE_TABLE = 56
+local SIZE_ARRAY_SLOT = 16
+local SIZE_HASH_NODE = 32
+local SIZE_STRING = 25
+local SIZE_LCLOSURE = 32
+local SIZE_CCLOSURE = 32
+local SIZE_UPVALUE = 16
+local SIZE_USERDATA = 40
+local SIZE_THREAD = 200
+
+--- Get the site of the function definition
+--- @param fn function
+--- @return string site
+local function function_site(fn)
+    local info = getinfo(fn, 'S')
+    if info.what == 'C' then
+        return '[C]'
+    end
+    return format('%s:%d', info.short_src, info.linedefined)
+end
+
+--- Estimate the size of the table and list its references
+--- @param t table
+--- @param push function The function to add the reference
+--- @return integer size
+local function walk_table(t, push)
+    local mt = getmetatable(t)
+    local mode = mt and rawget(mt, '__mode')
+    local weak_k = type(mode) == 'string' and find(mode, 'k', 1, true)
+    local weak_v = type(mode) == 'string' and find(mode, 'v', 1, true)
+
+    local narr = 0
+    while rawget(t, narr + 1) ~= nil do
+        narr = narr + 1
+    end
+    local nhash = 0
+    for k, v in next, t do
+        if type(k) ~= 'number' or k < 1 or k > narr or k % 1 ~= 0 then
+            nhash = nhash + 1
+        end
+        if not weak_k then
+            push(k)
+        end
+        if not weak_v then
+            push(v)
+        end
+    end
+    if mt then
+        push(mt)
+    end
+
+    -- the hash part is a power of 2
+    local size = 1
+    while size < nhash do
+        size = size * 2
+    end
+    if nhash == 0 then
+        size = 0
+    end
+    return SIZE_TABLE + narr * SIZE_ARRAY_SLOT + size * SIZE_HASH_NODE
+end
+
+--- @class measure.census.entry
+--- @field type string? The type of the objects of the site
+--- @field site string? The site of the objects
+--- @field count integer Number of objects
+--- @field size integer Estimated size of the objects in bytes
+
+--- @class measure.census
+--- @field types table<string, measure.census.entry> Objects by type
+--- @field sites table<string, measure.census.entry> Objects by type and site
+
+--- Count the objects reachable from the registry and the globals.
+--- A function is attributed to the site of its definition, and the other
+--- objects to the site where they are first reached: the upvalue of a
+--- function, the global variable, or the registry. The stacks of the threads
+--- are not traversed, so the locals of the caller are not counted.
+--- Run the full GC before the census to exclude the garbage.
+--- @param roots table<string, any>? Additional roots attributed to their keys,
+---                                   such as the objects only held by locals
+--- @return measure.census census
+local function census(roots)
+    local types = {}
+    local sites = {}
+    local visited = {}
+    local queue = {}
+    local head, tail = 1, 0
+    local site
+
+    -- add the reference of the object to the queue with the current site
+    local function push(v, at)
+        local t = type(v)
+        if (t == 'table' or t == 'function' or t == 'userdata' or t ==
+            'thread' or t == 'string') and not visited[v] then
+            visited[v] = true
+            tail = tail + 1
+            queue[tail] = {
+                v,
+                at or site,
+            }
+        end
+    end
+
+    local function add(t, at, size)
+        local e = types[t]
+        if not e then
+            e = {
+                count = 0,
+                size = 0,
+            }
+            types[t] = e
+        end
+        e.count = e.count + 1
+        e.size = e.size + size
+
+        local key = t .. ' ' .. at
+        e = sites[key]
+        if not e then
+            e = {
+                type = t,
+                site = at,
+                count = 0,
+                size = 0,
+            }
+            sites[key] = e
+        end
+        e.count = e.count + 1
+        e.size = e.size + size
+    end
+
+    -- the globals are attributed to their names
+    local G = _G
+    visited[G] = true
+    for k, v in next, G do
+        if type(k) == 'string' then
+            push(v, '_G.' .. k)
+        end
+    end
+    site = '_G'
+    add('table', site, walk_table(G, push))
+    push(getregistry(), 'registry')
+    for k, v in pairs(roots or {}) do
+        push(v, tostring(k))
+    end
+
+    while head <= tail do
+        local item = queue[head]
+        queue[head] = nil
+        head = head + 1
+        local v = item[1]
+        site = item[2]
+
+        local t = type(v)
+        if t == 'table' then
+            add(t, site, walk_table(v, push))
+        elseif t == 'string' then
+            add(t, site, SIZE_STRING + #v)
+        elseif t == 'function' then
+            local fsite = function_site(v)
+            local info = getinfo(v, 'u')
+            local nups = info.nups
+            if fsite == '[C]' then
+                add(t, site, SIZE_CCLOSURE + nups * SIZE_ARRAY_SLOT)
+            else
+                add(t, fsite, SIZE_LCLOSURE + nups * (8 + SIZE_UPVALUE))
+                site = fsite
+            end
+            for i = 1, nups do
+                local name, uv = getupvalue(v, i)
+                if name and name ~= '' and name ~= '?' then
+                    push(uv, format('%s (upvalue %s)', fsite, name))
+                else
+                    push(uv)
+                end
+            end
+            if getfenv then
+                push(getfenv(v))
+            end
+        elseif t == 'userdata' then
+            add(t, site, SIZE_USERDATA)
+            push(getmetatable(v))
+            if getuservalue then
+                push(getuservalue(v))
+            end
+        elseif t == 'thread' then
+            add(t, site, SIZE_THREAD)
+        end
+    end
+
+    return {
+        types = types,
+        sites = sites,
+    }
+end
+
+--- @class measure.census.delta
+--- @field type string The type of the objects
+--- @field site string? The site of the objects
+--- @field before integer Number of objects in the first census
+--- @field after integer Number of objects in the second census
+--- @field count integer Difference of the number of objects
+--- @field size integer Difference of the estimated size in bytes
+
+--- Compare the entries of two censuses
+--- @param before table<string, measure.census.entry>
+--- @param after table<string, measure.census.entry>
+--- @param changed_only boolean Whether to list only the changed entries
+--- @return measure.census.delta[] list
+local function diff_entries(before, after, changed_only)
+    local list = {}
+    local keys = {}
+    for k in pairs(before) do
+        keys[k] = true
+    end
+    for k in pairs(after) do
+        keys[k] = true
+    end
+    for k in pairs(keys) do
+        local b = before[k] or {
+            count = 0,
+            size = 0,
+        }
+        local a = after[k] or {
+            count = 0,
+            size = 0,
+        }
+        if not changed_only or a.count ~= b.count or a.size ~= b.size then
+            list[#list + 1] = {
+                type = a.type or b.type or k,
+                site = a.site or b.site,
+                before = b.count,
+                after = a.count,
+                count = a.count - b.count,
+                size = a.size - b.size,
+            }
+        end
+    end
+    sort(list, function(x, y)
+        if x.size ~= y.size then
+            return x.size > y.size
+        elseif x.count ~= y.count then
+            return x.count > y.count
+        end
+        return tostring(x.site or x.type) < tostring(y.site or y.type)
+    end)
+    return list
+end
+
+--- Compare two censuses
+--- @param before measure.census The census before the runs
+--- @param after measure.census The census after the runs
+--- @return table result The differences by type, and by site sorted in
+---                      descending order of the size
+local function diff(before, after)
+    return {
+        types = diff_entries(before.types, after.types, false),
+        sites = diff_entries(before.sites, after.sites, true),
+    }
+end
+
+return {
+    census = census,
+    diff = diff,
+}
@@ -27,7 +27,9 @@ local type = type
 local find = string.find
 local sub = string.sub
 local format = string.format
-local getinfo = require('measure.getinfo')
+local debug_getinfo = debug.getinfo
+local realpath = require('measure.realpath')
+local getcwd = require('measure.getcwd')
 
 --- @class measure.describe.spec
 --- @field name string The name of the benchmark
@@ -37,6 +39,7 @@ local getinfo = require('measure.getinfo')
 --- @field run function|nil The function to benchmark
 --- @field run_with_timer function|nil function to benchmark with timer
 --- @field teardown function|nil Teardown function for cleanup after each iteration
+--- @field require string|nil Name of the module to measure the require() cost of
 
 --- @class measure.describe.fileinfo
 --- @field source string The source of the benchmark (e.g., file path)
@@ -64,6 +67,8 @@ function Describe:setup(fn)
         return false, 'cannot be defined if setup_once() is defined'
     elseif spec.run or spec.run_with_timer then
         return false, 'must be defined before run() or run_with_timer()'
+    elseif spec.require then
+        return false, 'cannot be defined if require() is defined'
     end
 
     spec.setup = fn
@@ -84,6 +89,8 @@ function Describe:setup_once(fn)
         return false, 'cannot be defined if setup() is defined'
     elseif spec.run or spec.run_with_timer then
         return false, 'must be defined before run() or run_with_timer()'
+    elseif spec.require then
+        return false, 'cannot be defined if require() is defined'
     end
 
     spec.setup_once = fn
@@ -102,6 +109,8 @@ function Describe:run(fn)
         return false, 'cannot be defined twice'
     elseif spec.run_with_timer then
         return false, 'cannot be defined if run_with_timer() is defined'
+    elseif spec.require then
+        return false, 'cannot be defined if require() is defined'
     end
 
     spec.run = fn
@@ -120,12 +129,36 @@ function Describe:run_with_timer(fn)
         return false, 'cannot be defined twice'
     elseif spec.run then
         return false, 'cannot be defined if run() is defined'
+    elseif spec.require then
+        return false, 'cannot be defined if require() is defined'
     end
 
     spec.run_with_timer = fn
     return true
 end
 
+--- Define the module to measure the cost of require().
+--- Each sample loads the module in a new Lua state of a fresh process, so
+--- setup(), setup_once() and teardown() cannot be used with it.
+--- @param modname string The name of the module
+--- @return boolean ok True if successful
+--- @return string|nil err Error message if failed
+function Describe:require(modname)
+    local spec = self.spec
+    if type(modname) ~= 'string' then
+        return false, 'argument must be a string'
+    elseif spec.require then
+        return false, 'cannot be defined twice'
+    elseif spec.run or spec.run_with_timer then
+        return false, 'cannot be defined if run() or run_with_timer() is defined'
+    elseif spec.setup or spec.setup_once then
+        return false, 'cannot be defined if setup() or setup_once() is defined'
+    end
+
+    spec.require = modname
+    return true
+end
+
 --- Define teardown function for cleanup
 --- @param fn function The teardown function
 --- @return boolean ok True if successful
@@ -144,6 +177,64 @@ function Describe:teardown(fn)
     return true
 end
 
+--- Cache of the pathnames resolved from the chunk sources.
+--- The key is the working directory and the source joined with NUL, and the
+--- value is false if the source is not a Lua file under the directory.
+--- @type table<string, string|false>
+local PATHNAMES = {}
+
+--- Resolve the pathname of the benchmark file from the source of the chunk.
+--- The result is cached so that the file is resolved only once per file.
+--- @param cwd string The current working directory
+--- @param source string The source of the chunk
+--- @return string|false pathname The absolute pathname or false
+local function resolve_pathname(cwd, source)
+    local key = cwd .. '\0' .. source
+    local pathname = PATHNAMES[key]
+    if pathname == nil then
+        pathname = false
+        if sub(source, 1, 1) == '@' and find(source, '%.lua$') then
+            local v = sub(source, 2)
+            if sub(v, 1, 1) ~= '/' then
+                v = cwd .. '/' .. v
+            end
+            v = realpath(v)
+            if sub(v, 1, #cwd) == cwd then
+                pathname = v
+            end
+        end
+        PATHNAMES[key] = pathname
+    end
+    return pathname
+end
+
+--- Get the file information of the benchmark definition.
+--- This will search the call stack for the first Lua file that is located
+--- under the current working directory.
+--- @return measure.describe.fileinfo? fileinfo
+local function get_fileinfo()
+    local cwd = getcwd()
+    if not cwd then
+        return nil
+    end
+
+    -- level 3 is the caller of new_describe()
+    local level = 3
+    local info = debug_getinfo(level, 'Sl')
+    while info do
+        local pathname = resolve_pathname(cwd, info.source)
+        if pathname then
+            return {
+                source = info.source,
+                pathname = pathname,
+                lineno = info.currentline,
+            }
+        end
+        level = level + 1
+        info = debug_getinfo(level, 'Sl')
+    end
+end
+
 --- Create a new benchmark describe instance
 --- @param name string The name of the benchmark
 --- @param opts measure.options? Optional options for the describe
@@ -154,27 +245,7 @@ local function new_describe(name, opts)
         return nil, format('name must be a string, got %q', type(name))
     end
 
-    --- Get the current working directory
-    local PWD = assert(io.popen('pwd'):read('*l'))
-    --- Get the file information for the current benchmark
-    --- This will search the call stack for the first Lua file that matches the
-    --- current working directory and has a `.lua` extension.
-    local fileinfo
-    for i = 1, 100 do
-        local info = getinfo(i, 'file', 'source')
-        if not info then
-            break
-        elseif sub(info.file.pathname, 1, #PWD) == PWD and
-            find(info.file.source, '%.lua$') then
-            fileinfo = {
-                source = info.file.source,
-                pathname = info.file.pathname,
-                lineno = info.source.line_current,
-            }
-            break
-        end
-    end
-
+    local fileinfo = get_fileinfo()
     local desc = setmetatable({
         spec = {
             name = name,
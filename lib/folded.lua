@@ -0,0 +1,171 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.folded
+-- This module formats the folded stacks of the CPU profile for the flame
+-- graph tools and summarizes the time of each function
+--
+local type = type
+local ipairs = ipairs
+local pairs = pairs
+local format = string.format
+local gmatch = string.gmatch
+local sub = string.sub
+local concat = table.concat
+local sort = table.sort
+
+--- @class measure.folded.stack
+--- @field stack string Frames from the root to the leaf joined by ';'
+--- @field count integer Number of samples of the stack
+
+--- Encode the stacks in the folded format of flamegraph.pl and inferno,
+--- one stack per line followed by a space and the number of samples
+--- @param stacks measure.folded.stack[] The stacks
+--- @return string folded The folded stacks sorted by the stack
+local function encode(stacks)
+    local list = {}
+    for i, v in ipairs(stacks) do
+        list[i] = v
+    end
+    sort(list, function(a, b)
+        return a.stack < b.stack
+    end)
+
+    local lines = {}
+    for i, v in ipairs(list) do
+        lines[i] = format('%s %d\n', v.stack, v.count)
+    end
+    return concat(lines)
+end
+
+--- Remove the leading frames of the source and the C functions, which are
+--- the frames of the caller of the profiled code. The stacks that become the
+--- same are merged, and the stacks that have no other frames are kept as is.
+--- @param stacks measure.folded.stack[] The stacks
+--- @param src string|table<string, boolean> The short_src of the caller, or
+---                                          the set of them
+--- @return measure.folded.stack[] stacks The stacks without the leading frames
+local function strip(stacks, src)
+    local srcs = type(src) == 'table' and src or {
+        [src] = true,
+    }
+    local function is_caller(frame)
+        if sub(frame, -4) == ' [C]' then
+            return true
+        end
+        for v in pairs(srcs) do
+            if frame == 'main ' .. v or frame:find(' ' .. v .. ':', 1, true) then
+                return true
+            end
+        end
+        return false
+    end
+
+    local list = {}
+    local index = {}
+    for _, v in ipairs(stacks) do
+        local stack = v.stack
+        local pos = 1
+        for frame, next_pos in gmatch(stack, '([^;]+);?()') do
+            if not is_caller(frame) then
+                stack = sub(stack, pos)
+                break
+            end
+            pos = next_pos
+        end
+
+        local s = index[stack]
+        if s then
+            s.count = s.count + v.count
+        else
+            s = {
+                stack = stack,
+                count = v.count,
+            }
+            index[stack] = s
+            list[#list + 1] = s
+        end
+    end
+    return list
+end
+
+--- @class measure.folded.frame
+--- @field frame string The name of the frame
+--- @field self integer Number of samples the frame is the leaf
+--- @field total integer Number of samples the frame is on the stack
+
+--- Summarize the samples of each frame
+--- @param stacks measure.folded.stack[] The stacks
+--- @param top integer? The number of frames to list (default: all)
+--- @return measure.folded.frame[] frames The frames sorted in descending
+---                                       order of the self samples
+local function summarize(stacks, top)
+    local frames = {}
+    for _, v in ipairs(stacks) do
+        local seen = {}
+        local leaf
+        for frame in gmatch(v.stack, '[^;]+') do
+            local f = frames[frame]
+            if not f then
+                f = {
+                    frame = frame,
+                    self = 0,
+                    total = 0,
+                }
+                frames[frame] = f
+            end
+            -- recursive frames are counted once in the total
+            if not seen[frame] then
+                seen[frame] = true
+                f.total = f.total + v.count
+            end
+            leaf = f
+        end
+        if leaf then
+            leaf.self = leaf.self + v.count
+        end
+    end
+
+    local list = {}
+    for _, f in pairs(frames) do
+        list[#list + 1] = f
+    end
+    sort(list, function(a, b)
+        if a.self ~= b.self then
+            return a.self > b.self
+        elseif a.total ~= b.total then
+            return a.total > b.total
+        end
+        return a.frame < b.frame
+    end)
+    if top then
+        for i = #list, top + 1, -1 do
+            list[i] = nil
+        end
+    end
+    return list
+end
+
+return {
+    encode = encode,
+    strip = strip,
+    summarize = summarize,
+}
@@ -0,0 +1,165 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.gctune
+-- This module lists the GC parameters to try and selects the best of them
+--
+local ipairs = ipairs
+local format = string.format
+local sort = table.sort
+local collectgarbage = collectgarbage
+
+--- Values of the pause and the step multiplier of the incremental mode
+local PAUSES = {
+    100,
+    150,
+    200,
+    300,
+    400,
+}
+local STEPMULS = {
+    100,
+    200,
+    400,
+}
+--- Values of the minor and major multipliers of the generational mode
+local MINORMULS = {
+    10,
+    20,
+    50,
+}
+local MAJORMULS = {
+    50,
+    100,
+    200,
+}
+
+--- @class measure.gctune.candidate
+--- @field label string The description of the parameters
+--- @field mode string? The GC mode, or nil to keep the default parameters
+--- @field params table<string, integer>? The parameters of the mode
+
+--- List the GC parameters to try.
+--- The first candidate keeps the default parameters.
+--- @param generational boolean True to include the generational mode
+--- @return measure.gctune.candidate[] list
+local function candidates(generational)
+    local list = {
+        {
+            label = 'default',
+        },
+    }
+    for _, pause in ipairs(PAUSES) do
+        for _, stepmul in ipairs(STEPMULS) do
+            list[#list + 1] = {
+                label = format('incremental pause=%d stepmul=%d', pause,
+                               stepmul),
+                mode = 'incremental',
+                params = {
+                    pause = pause,
+                    stepmul = stepmul,
+                },
+            }
+        end
+    end
+    if generational then
+        for _, minormul in ipairs(MINORMULS) do
+            for _, majormul in ipairs(MAJORMULS) do
+                list[#list + 1] = {
+                    label = format('generational minormul=%d majormul=%d',
+                                   minormul, majormul),
+                    mode = 'generational',
+                    params = {
+                        minormul = minormul,
+                        majormul = majormul,
+                    },
+                }
+            end
+        end
+    end
+    return list
+end
+
+--- Apply the GC parameters of the candidate to the running Lua state
+--- @param c measure.gctune.candidate
+local function apply(c)
+    local params = c.params
+    if c.mode == 'generational' then
+        collectgarbage('generational', params.minormul, params.majormul)
+    elseif c.mode == 'incremental' then
+        if _VERSION == 'Lua 5.4' then
+            collectgarbage('incremental', params.pause, params.stepmul)
+        else
+            collectgarbage('setpause', params.pause)
+            collectgarbage('setstepmul', params.stepmul)
+        end
+    end
+end
+
+--- Select the best point under the memory limit, and the points on the
+--- trade-off curve between the objective and the peak memory.
+--- @param points table[] The measured points with the objective field and
+---                       the peak_kb field
+--- @param objective string The field to minimize (e.g. "mean" or "p99")
+--- @param max_kb number? The limit of the peak memory in KB
+--- @return integer? best The index of the best point, or nil if no point is
+---                       under the limit
+--- @return integer[] curve The indices of the points that are not beaten on
+---                         both the objective and the peak memory, in the
+---                         ascending order of the peak memory
+local function select_best(points, objective, max_kb)
+    local best
+    local order = {}
+    for i, p in ipairs(points) do
+        order[i] = i
+        if not max_kb or p.peak_kb <= max_kb then
+            if not best or p[objective] < points[best][objective] then
+                best = i
+            end
+        end
+    end
+
+    sort(order, function(a, b)
+        local pa, pb = points[a], points[b]
+        if pa.peak_kb ~= pb.peak_kb then
+            return pa.peak_kb < pb.peak_kb
+        elseif pa[objective] ~= pb[objective] then
+            return pa[objective] < pb[objective]
+        end
+        return a < b
+    end)
+    local curve = {}
+    local min
+    for _, i in ipairs(order) do
+        local v = points[i][objective]
+        if not min or v < min then
+            curve[#curve + 1] = i
+            min = v
+        end
+    end
+    return best, curve
+end
+
+return {
+    candidates = candidates,
+    apply = apply,
+    select_best = select_best,
+}
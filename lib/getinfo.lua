@@ -33,9 +33,7 @@ local open = io.open
 local error = error
 local concat = table.concat
 local realpath = require('measure.realpath')
-
--- Get current working directory
-local PWD = assert(io.popen('pwd'):read('*l'))
+local getcwd = require('measure.getcwd')
 
 --- Read source code from file
 --- @param pathname string The file path
@@ -79,15 +77,16 @@ end
 
 --- Extract filename from source path
 --- @param source string The source path
+--- @param cwd string The current working directory
 --- @return string name The filename
 --- @return string pathname The full pathname
-local function extract_filename(source)
+local function extract_filename(source, cwd)
     -- get basename from source
     local name = match(source, '([^/\\]+)$')
     local pathname = gsub(source, '^@', '')
     if sub(pathname, 1, 1) ~= '/' then
-        -- if pathname is not absolute, prepend PWD
-        pathname = PWD .. '/' .. pathname
+        -- if pathname is not absolute, prepend the working directory
+        pathname = cwd .. '/' .. pathname
     end
     pathname = realpath(pathname)
     return name, pathname
@@ -97,13 +96,15 @@ end
 --- @param info table The debug information table
 --- @return table file The structured file information
 local function getinfo_file(info)
+    -- relative source is resolved against the current working directory
+    local cwd = assert(getcwd())
     -- Extract filename and pathname from source
-    local name, pathname = extract_filename(info.source)
+    local name, pathname = extract_filename(info.source, cwd)
     return {
         source = info.source,
         name = name,
         pathname = pathname,
-        basedir = PWD,
+        basedir = cwd,
     }
 end
 
@@ -0,0 +1,246 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.jittrace
+-- This module records the trace events of the LuaJIT compiler and the VM
+-- states sampled by the profiler of LuaJIT in each phase of a benchmark
+--
+local type = type
+local pairs = pairs
+local pcall = pcall
+local tostring = tostring
+local rawget = rawget
+local require = require
+local setmetatable = setmetatable
+local format = string.format
+local sort = table.sort
+
+--- Names of the VM states of jit.profile
+local VMSTATES = {
+    N = 'compiled',
+    I = 'interpreted',
+    C = 'c',
+    G = 'gc',
+    J = 'compiler',
+}
+
+--- @class measure.jittrace.phase
+--- @field started integer Number of traces started
+--- @field completed integer Number of traces completed
+--- @field aborted integer Number of traces aborted
+--- @field flushed integer Number of flushes of the trace cache
+--- @field vmstates table<string, integer>? Number of the profiler samples in
+---                                          each VM state
+
+--- @class measure.jittrace
+--- @field protected jit table The jit module
+--- @field protected util table The jit.util module
+--- @field protected vmdef table The jit.vmdef module
+--- @field protected profile table? The jit.profile module if available
+--- @field protected handler function? The attached trace handler
+--- @field protected phase string The current phase
+--- @field protected phases table<string, measure.jittrace.phase>
+--- @field protected aborts table<string, table> The aborts by reason and
+---                                                location
+local JITTrace = require('measure.metatable')('measure.jittrace')
+
+--- Get the location of the function and the bytecode position like jit.dump
+--- @param self measure.jittrace
+--- @param func any The function
+--- @param pc integer? The bytecode position
+--- @return string location
+local function location(self, func, pc)
+    if type(func) ~= 'function' then
+        return '(?)'
+    end
+    local fi = self.util.funcinfo(func, pc)
+    if fi.loc then
+        return fi.loc
+    elseif fi.ffid then
+        return self.vmdef.ffnames[fi.ffid] or '(?)'
+    elseif fi.addr then
+        return format('C:%x', fi.addr)
+    end
+    return '(?)'
+end
+
+--- Get the reason of the abort like jit.dump
+--- @param self measure.jittrace
+--- @param err any The error number or message
+--- @param info any The information of the error
+--- @return string reason
+local function reason(self, err, info)
+    if type(err) ~= 'number' then
+        return tostring(err)
+    end
+    local msg = self.vmdef.traceerr[err]
+    if not msg then
+        return format('error %d', err)
+    end
+    if type(info) == 'function' then
+        info = location(self, info)
+    end
+    local ok, res = pcall(format, msg, info)
+    return ok and res or msg
+end
+
+--- Get the counters of the current phase
+--- @return measure.jittrace.phase
+function JITTrace:current()
+    local p = self.phases[self.phase]
+    if not p then
+        p = {
+            started = 0,
+            completed = 0,
+            aborted = 0,
+            flushed = 0,
+        }
+        self.phases[self.phase] = p
+    end
+    return p
+end
+
+--- Set the phase of the following events
+--- @param phase string The name of the phase (e.g. 'warmup', 'sampling')
+function JITTrace:set_phase(phase)
+    self.phase = phase
+end
+
+--- Record a trace event
+--- @param what string The event ('start', 'stop', 'abort' or 'flush')
+--- @param func any The function of the start or abort of the trace
+--- @param pc integer? The bytecode position of the start or abort
+--- @param otr any The error of the abort
+--- @param oex any The information of the error of the abort
+function JITTrace:trace(what, func, pc, otr, oex)
+    local p = self:current()
+    if what == 'start' then
+        p.started = p.started + 1
+    elseif what == 'stop' then
+        p.completed = p.completed + 1
+    elseif what == 'flush' then
+        p.flushed = p.flushed + 1
+    elseif what == 'abort' then
+        p.aborted = p.aborted + 1
+        local r = reason(self, otr, oex)
+        local loc = location(self, func, pc)
+        local key = self.phase .. '\0' .. r .. '\0' .. loc
+        local v = self.aborts[key]
+        if not v then
+            v = {
+                phase = self.phase,
+                reason = r,
+                location = loc,
+                count = 0,
+            }
+            self.aborts[key] = v
+        end
+        v.count = v.count + 1
+    end
+end
+
+--- Start recording the trace events and the VM states
+function JITTrace:start()
+    self.handler = function(what, _, func, pc, otr, oex)
+        self:trace(what, func, pc, otr, oex)
+    end
+    self.jit.attach(self.handler, 'trace')
+
+    if self.profile then
+        -- sample the VM state every millisecond
+        self.profile.start('i1', function(_, samples, vmstate)
+            local p = self:current()
+            local states = p.vmstates or {}
+            p.vmstates = states
+            local name = VMSTATES[vmstate] or vmstate
+            states[name] = (states[name] or 0) + samples
+        end)
+    end
+end
+
+--- @class measure.jittrace.result
+--- @field phases table<string, measure.jittrace.phase> The counters by phase
+--- @field aborts table[] The aborts in descending order of the count
+
+--- Stop recording and get the result
+--- @return measure.jittrace.result result
+function JITTrace:stop()
+    if self.profile then
+        self.profile.stop()
+    end
+    if self.handler then
+        self.jit.attach(self.handler)
+        self.handler = nil
+    end
+
+    local aborts = {}
+    for _, v in pairs(self.aborts) do
+        aborts[#aborts + 1] = v
+    end
+    sort(aborts, function(a, b)
+        if a.count ~= b.count then
+            return a.count > b.count
+        elseif a.phase ~= b.phase then
+            return a.phase > b.phase
+        elseif a.reason ~= b.reason then
+            return a.reason < b.reason
+        end
+        return a.location < b.location
+    end)
+    return {
+        phases = self.phases,
+        aborts = aborts,
+    }
+end
+
+--- Create a new recorder of the trace events
+--- @return measure.jittrace? recorder The new recorder
+--- @return string? err Error message if the runtime is not LuaJIT
+local function new()
+    local jit = rawget(_G, 'jit')
+    if type(jit) ~= 'table' or type(jit.attach) ~= 'function' then
+        return nil, 'the runtime is not LuaJIT'
+    end
+    local ok, util = pcall(require, 'jit.util')
+    if not ok then
+        return nil, util
+    end
+    local vmdef
+    ok, vmdef = pcall(require, 'jit.vmdef')
+    if not ok then
+        return nil, vmdef
+    end
+    -- jit.profile is available since LuaJIT 2.1
+    local profile
+    ok, profile = pcall(require, 'jit.profile')
+
+    return setmetatable({
+        jit = jit,
+        util = util,
+        vmdef = vmdef,
+        profile = ok and profile or nil,
+        phase = 'warmup',
+        phases = {},
+        aborts = {},
+    }, JITTrace)
+end
+
+return new
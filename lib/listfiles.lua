@@ -20,20 +20,55 @@
 -- THE SOFTWARE.
 --
 local type = type
-local find = string.find
+local ipairs = ipairs
 local format = string.format
-local popen = io.popen
 local getfiletype = require('measure.getfiletype')
+local walkdir = require('measure.walkdir')
+
+--- Default pattern of the benchmark files
+local DEFAULT_INCLUDE = {
+    '*_bench.lua',
+}
+
+--- Verify that the value is a list of glob patterns
+--- @param name string The name of the option
+--- @param v any The value to verify
+local function verify_patterns(name, v)
+    if v == nil then
+        return
+    elseif type(v) ~= 'table' then
+        error(format('opts.%s must be a table', name), 3)
+    end
+    for i, pattern in ipairs(v) do
+        if type(pattern) ~= 'string' then
+            error(format('opts.%s#%d must be a string', name, i), 3)
+        end
+    end
+end
+
+--- @class measure.listfiles.options
+--- @field recursive boolean? Whether to search subdirectories recursively.
+--- @field include string[]? Glob patterns of the files to list (default: `*_bench.lua`).
+--- @field exclude string[]? Glob patterns of the files and directories to skip.
 
 --- List benchmark files from the specified pathname.
+--- The patterns are matched against the file name, or against the pathname
+--- relative to the specified directory if the pattern contains a slash.
 --- @param pathname string The pathname to load the benchmark files from.
---- @return string[]? pathnames A list of benchmark file pathnames.
+--- @param opts measure.listfiles.options? The options for listing files.
+--- @return string[]? pathnames A sorted list of benchmark file pathnames.
 --- @return string? err An error message if loading failed, nil otherwise.
 --- @throws error if the pathname is not a string.
-local function listfiles(pathname)
+local function listfiles(pathname, opts)
     if type(pathname) ~= 'string' then
         error('pathname must be a string', 2)
+    elseif opts == nil then
+        opts = {}
+    elseif type(opts) ~= 'table' then
+        error('opts must be a table', 2)
     end
+    verify_patterns('include', opts.include)
+    verify_patterns('exclude', opts.exclude)
 
     local t = getfiletype(pathname)
     if t == 'file' then
@@ -44,21 +79,13 @@ local function listfiles(pathname)
     end
 
     if t == 'directory' then
-        -- if pathname is pointing to a directory, retrieve the all entries
-        local pathnames = {}
-        -- Escape pathname for shell command
-        local escaped_path = pathname:gsub("'", "'\\''")
-        local ls, err = popen("ls -1 '" .. escaped_path .. "'")
-        if not ls then
+        -- if pathname is pointing to a directory, retrieve the matched files
+        local pathnames, err = walkdir(pathname, opts.recursive == true,
+                                       opts.include or DEFAULT_INCLUDE,
+                                       opts.exclude)
+        if not pathnames then
             return nil, format('failed to list directory %s: %s', pathname, err)
         end
-
-        -- collect all files that match the pattern
-        for entry in ls:lines() do
-            if find(entry, '_bench.lua$') then
-                pathnames[#pathnames + 1] = pathname .. '/' .. entry
-            end
-        end
         return pathnames
     end
 
@@ -24,28 +24,109 @@ local sub = string.sub
 local format = string.format
 local concat = table.concat
 local pcall = pcall
+local ipairs = ipairs
+local unpack = unpack or table.unpack
 local loadfile = loadfile
 local pairs = pairs
+local gsub = string.gsub
+local gmatch = string.gmatch
+local open = io.open
 local realpath = require('measure.realpath')
 local registry = require('measure.registry')
 
+--- Find the pathname of a Lua module in the package.path.
+--- @param modname string The name of the module.
+--- @return string? pathname The pathname of the module file if found.
+local searchpath = package.searchpath and function(modname)
+    return (package.searchpath(modname, package.path))
+end or function(modname)
+    -- Lua 5.1 does not have package.searchpath
+    local name = gsub(modname, '%.', '/')
+    for tmpl in gmatch(package.path, '[^;]+') do
+        local pathname = gsub(tmpl, '%?', name)
+        local f = open(pathname, 'r')
+        if f then
+            f:close()
+            return pathname
+        end
+    end
+end
+
+--- Dependencies of the modules that have been loaded via require().
+--- A module is loaded only once, so the dependencies observed at the first
+--- load are remembered to report them for the subsequent files.
+--- @type table<string, table<string, string>>
+local MODULE_DEPS = {}
+
+--- Add the dependencies of a module to all modules in the loading stack.
+--- @param stack table<string, string>[] The dependencies of the loading modules.
+--- @param mdeps table<string, string> The dependencies of the module.
+local function add_deps(stack, mdeps)
+    for _, deps in ipairs(stack) do
+        for k, v in pairs(mdeps) do
+            deps[k] = v
+        end
+    end
+end
+
 --- Evaluate a Lua file and catch any errors.
+--- The Lua modules that are required while evaluating the file are recorded
+--- as the dependencies of the file.
 --- @param pathname string The pathname of the Lua file to evaluate.
 --- @return boolean ok true if the file was evaluated successfully, false otherwise.
---- @return string|nil err An error message if the evaluation failed, nil otherwise.
+--- @return string|table err An error message if the evaluation failed, or the dependencies of the file.
 local function evalfile(pathname)
     local f, err = loadfile(pathname)
     if not f then
         return false, err
     end
 
+    -- hook require() to record the modules that the file depends on
+    local require = _G.require
+    local deps = {}
+    local stack = {
+        deps,
+    }
+    _G.require = function(modname, ...)
+        if type(modname) ~= 'string' or modname == 'measure' or
+            sub(modname, 1, 8) == 'measure.' or package.loaded[modname] ~=
+            nil then
+            -- measure itself and already loaded modules are not tracked
+            -- except for the dependencies recorded at the first load
+            if MODULE_DEPS[modname] then
+                add_deps(stack, MODULE_DEPS[modname])
+            end
+            return require(modname, ...)
+        end
+
+        local mdeps = {}
+        local modpath = searchpath(modname)
+        stack[#stack + 1] = mdeps
+        local res = {
+            pcall(require, modname, ...),
+        }
+        stack[#stack] = nil
+        if not res[1] then
+            error(res[2], 0)
+        end
+
+        if modpath then
+            -- only Lua modules can be reloaded
+            mdeps[modname] = modpath
+        end
+        MODULE_DEPS[modname] = mdeps
+        add_deps(stack, mdeps)
+        return unpack(res, 2, 3)
+    end
+
     -- execute the file and catch any errors
     local ok
     ok, err = pcall(f)
+    _G.require = require
     if not ok then
         return false, err
     end
-    return true
+    return true, deps
 end
 
 --- Load benchmark file and return the registered benchmark spec.
@@ -58,9 +139,9 @@ local function loadfiles(pathname)
     end
 
     local filename = realpath(pathname)
-    local ok, err = evalfile(filename)
+    local ok, res = evalfile(filename)
     if not ok then
-        return nil, err
+        return nil, res
     end
 
     -- check if the file registered a benchmark spec
@@ -79,6 +160,7 @@ local function loadfiles(pathname)
             return {
                 filename = filename,
                 spec = spec,
+                deps = res,
             }
         end
     end
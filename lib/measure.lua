@@ -31,6 +31,7 @@ local new_spec = require('measure.spec')
 local registry_get = require('measure.registry').get
 local registry_add = require('measure.registry').add
 local new_options = require('measure.options')
+local new_mmap = require('measure.mmap')
 
 --- @alias add_describe_fn fun(name: string): measure.describe
 
@@ -55,7 +56,8 @@ local function new_describe_proxy(desc, source, options)
 
             if method == 'describe' then
                 -- creates a new describe object with the same options
-                if desc.spec.run or desc.spec.run_with_timer then
+                if desc.spec.run or desc.spec.run_with_timer or
+                    desc.spec.require then
                     return new_describe(source, options)
                 end
                 -- If the run or run_with_timer is not defined, it is not allowed to create a new describe
@@ -165,6 +167,8 @@ local function allow_new_describe(_, key)
             return new_describe(info.file.source)
         elseif key == 'options' then
             return set_options
+        elseif key == 'mmap' then
+            return new_mmap
         end
     end
     error(format('Attempt to access measure as a table: %q', tostring(key)), 2)
@@ -0,0 +1,88 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.ab
+-- Compare two versions of the modules used by the describe
+--
+local ipairs = ipairs
+local type = type
+local format = string.format
+local merge_samples = require('measure.samples').merge
+local stats_paired = require('measure.stats.paired')
+local runner = require('measure.runner')
+local with_opts = runner.with_opts
+local sample_variant = runner.variant
+local printf = runner.printf
+
+-- default number of rounds and samples per round
+local AB_ROUNDS = 10
+local AB_SAMPLES = 100
+
+--- Compare the two versions of the modules used by the describe.
+--- The variants run in alternating rounds (ABBA order) so that the drift of
+--- the host affects both variants equally, and the round means are compared
+--- in pairs.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param ab table The ab option
+--- @return measure.samples[]? list The merged samples of the variants A and B
+--- @return any err Error message if failed
+--- @return table? result The paired comparison
+local function sample_ab(desc, opts, ab)
+    local name = desc.spec.name
+    local rounds = ab.rounds or AB_ROUNDS
+    local round_opts = with_opts(opts, {
+        sample_size = ab.samples or AB_SAMPLES,
+    })
+
+    local list = {
+        a = {},
+        b = {},
+    }
+    for i = 1, rounds do
+        local order = i % 2 == 1 and {
+            'a',
+            'b',
+        } or {
+            'b',
+            'a',
+        }
+        for _, k in ipairs(order) do
+            printf('  - Round %d/%d: %s', i, rounds, k:upper())
+            local samples, err = sample_variant(desc, round_opts, ab[k])
+            if not samples then
+                return nil, format('ERROR: round %d of %s: %s', i, k:upper(),
+                                   err)
+            end
+            list[k][i] = samples
+        end
+    end
+
+    local result = stats_paired(list.a, list.b)
+    result.a = type(ab.a) == 'string' and ab.a or 'custom'
+    result.b = type(ab.b) == 'string' and ab.b or 'custom'
+    return {
+        merge_samples(name .. ' [A]', list.a),
+        merge_samples(name .. ' [B]', list.b),
+    }, nil, result
+end
+
+return sample_ab
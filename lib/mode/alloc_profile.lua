@@ -0,0 +1,77 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.alloc_profile
+-- List the source lines that allocate the most memory in the describe
+--
+local ipairs = ipairs
+local allocprof = require('measure.allocprof')
+local runner = require('measure.runner')
+local profile_describe = runner.profile
+
+-- default number of runs and sites to report
+local ALLOC_PROFILE_RUNS = 100
+local ALLOC_PROFILE_TOP = 10
+
+--- List the source lines that allocate the most memory in the describe
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param c table The alloc_profile option
+--- @return table? result The allocation sites
+--- @return any err Error message if failed
+local function alloc_profile_describe(desc, opts, c)
+    local list
+    local runs = c.runs or ALLOC_PROFILE_RUNS
+    local ok, err = profile_describe(desc, opts, runs, 'Allocation profile', {
+        start = function()
+            assert(allocprof.start())
+        end,
+        stop = function()
+            list = assert(allocprof.stop())
+        end,
+    })
+    if not ok then
+        -- restore the allocator if the run failed during the profile
+        allocprof.stop()
+        return nil, err
+    end
+
+    local total = {
+        count = 0,
+        bytes = 0,
+    }
+    local sites = {}
+    for _, v in ipairs(list) do
+        total.count = total.count + v.count
+        total.bytes = total.bytes + v.bytes
+        if #sites < (c.top or ALLOC_PROFILE_TOP) then
+            sites[#sites + 1] = v
+        end
+    end
+    return {
+        runs = runs,
+        count = total.count,
+        bytes = total.bytes,
+        sites = sites,
+    }
+end
+
+return alloc_profile_describe
@@ -0,0 +1,60 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.allocators
+-- Run the describe under each allocator in the child processes
+--
+local ipairs = ipairs
+local format = string.format
+local merge_samples = require('measure.samples').merge
+local allocator = require('measure.allocator')
+local runner = require('measure.runner')
+local fork_describe = runner.fork
+
+--- Run the describe under each allocator in the child processes.
+--- The allocator of the child process is replaced before setup(), so the
+--- blocks allocated by the describe come from the allocator.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param kinds string[] The allocators to run the describe under
+--- @return measure.samples[]? list The samples of each allocator
+--- @return any err Error message if failed
+--- @return string[]? kinds The allocators
+local function sample_allocators(desc, opts, kinds)
+    local name = desc.spec.name
+    local list = {}
+    for _, kind in ipairs(kinds) do
+        local samples, err = fork_describe(desc, opts, opts.forks or 1,
+                                           'Allocator ' .. kind, function()
+            local ok, aerr = allocator.use(kind)
+            if not ok then
+                error(aerr, 0)
+            end
+        end)
+        if not samples then
+            return nil, err
+        end
+        list[#list + 1] = merge_samples(format('%s [%s]', name, kind), samples)
+    end
+    return list, nil, kinds
+end
+
+return sample_allocators
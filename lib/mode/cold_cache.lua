@@ -0,0 +1,77 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.cold_cache
+-- Run the describe with the warm and the cold CPU caches in the child
+-- processes
+--
+local ipairs = ipairs
+local format = string.format
+local merge_samples = require('measure.samples').merge
+local hostinfo = require('measure.hostinfo')
+local runner = require('measure.runner')
+local with_opts = runner.with_opts
+local fork_describe = runner.fork
+
+-- size of the eviction buffer relative to the last-level cache, and the
+-- size in KB if the cache size is unknown
+local COLD_CACHE_LLC_RATIO = 2
+local COLD_CACHE_DEFAULT_KB = 64 * 1024
+
+--- Run the describe with the warm and the cold CPU caches in the child
+--- processes. The cold samples start after a buffer larger than the
+--- last-level cache is read outside the timed region.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param c table The cold_cache option
+--- @return measure.samples[]? list The samples of the hot and the cold caches
+--- @return any err Error message if failed
+--- @return table? result The sizes of the last-level cache and the buffer
+local function sample_cold_cache(desc, opts, c)
+    local info = hostinfo() or {}
+    local llc_kb = info.cpu and info.cpu.llc_kb
+    local evict_kb = c.size_kb or (llc_kb and llc_kb * COLD_CACHE_LLC_RATIO) or
+                         COLD_CACHE_DEFAULT_KB
+
+    local name = desc.spec.name
+    local list = {}
+    for _, kind in ipairs({
+        'hot',
+        'cold',
+    }) do
+        local cache_opts = with_opts(opts, {
+            evict_kb = kind == 'cold' and evict_kb or nil,
+        })
+
+        local samples, err = fork_describe(desc, cache_opts, opts.forks or 1,
+                                           'Cache ' .. kind)
+        if not samples then
+            return nil, err
+        end
+        list[#list + 1] = merge_samples(format('%s [%s]', name, kind), samples)
+    end
+    return list, nil, {
+        llc_kb = llc_kb,
+        evict_kb = evict_kb,
+    }
+end
+
+return sample_cold_cache
@@ -0,0 +1,50 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.cold_start
+-- Measure the first invocations of the describe in fresh child processes
+--
+local runner = require('measure.runner')
+local with_opts = runner.with_opts
+local fork_describe = runner.fork
+
+-- number of fresh processes to measure the cold start without forks option
+local COLD_START_RUNS = 10
+
+--- Measure the first invocations of the describe in fresh child processes.
+--- The child processes are forked before the describe is run in the current
+--- process, so they start from the state right after before_all().
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param count integer The number of invocations to measure
+--- @return measure.samples[]? list The samples collected in each child process
+--- @return any err Error message if failed
+local function cold_start_describe(desc, opts, count)
+    local cold_opts = with_opts(opts, {
+        -- measure the first invocations without warmup
+        warmup = 0,
+        sample_size = count,
+    })
+    return fork_describe(desc, cold_opts, opts.forks or COLD_START_RUNS,
+                         'Cold start')
+end
+
+return cold_start_describe
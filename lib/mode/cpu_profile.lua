@@ -0,0 +1,105 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.cpu_profile
+-- Sample the call stacks of the describe with the CPU time timer
+--
+local format = string.format
+local max = math.max
+local min = math.min
+local ceil = math.ceil
+local cpuprof = require('measure.cpuprof')
+local folded = require('measure.folded')
+local runner = require('measure.runner')
+local profile_describe = runner.profile
+
+-- default duration in seconds, sampling interval in microseconds, number of
+-- functions to report and output directory
+local CPU_PROFILE_DURATION = 1
+local CPU_PROFILE_INTERVAL = 1000
+local CPU_PROFILE_TOP = 10
+local CPU_PROFILE_DIR = 'measure_records/profile'
+-- maximum number of runs
+local CPU_PROFILE_MAX_RUNS = 100000
+
+--- Sample the call stacks of the describe with the CPU time timer and write
+--- them as the folded stacks for the flame graph tools.
+--- The number of runs is chosen from the mean time of the steady state so
+--- that the profile lasts about the duration of the option.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param c table The cpu_profile option
+--- @param samples measure.samples The samples of the steady state
+--- @return table? result The sampled functions and the pathname of the file
+--- @return any err Error message if failed
+local function cpu_profile_describe(desc, opts, c, samples)
+    local duration = c.duration or CPU_PROFILE_DURATION
+    local interval = c.interval or CPU_PROFILE_INTERVAL
+    local runs = CPU_PROFILE_MAX_RUNS
+    local mean = samples:mean()
+    if mean > 0 then
+        runs = max(1, min(runs, ceil(duration * 1e9 / mean)))
+    end
+
+    local res
+    local ok, err = profile_describe(desc, opts, runs, 'CPU profile', {
+        start = function()
+            assert(cpuprof.start(interval))
+        end,
+        stop = function()
+            res = assert(cpuprof.stop())
+        end,
+    })
+    if not ok then
+        -- stop the timer if the run failed during the profile
+        cpuprof.stop()
+        return nil, err
+    end
+
+    -- remove the frames of this command above the describe
+    local stacks = folded.strip(res.stacks, runner.caller_sources())
+    local dir = c.dir or CPU_PROFILE_DIR
+    local pathname = format('%s/%s.folded', dir,
+                            (desc.spec.name:gsub('[^%w%-%.]+', '_')))
+    local rc = os.execute(format("mkdir -p '%s'", (dir:gsub("'", "'\\''"))))
+    -- Lua 5.1 returns the exit status, and Lua 5.2 or later returns true
+    if rc ~= true and rc ~= 0 then
+        return nil, format('failed to create the directory %q', dir)
+    end
+    local f
+    f, err = io.open(pathname, 'w')
+    if not f then
+        return nil, err
+    end
+    f:write(folded.encode(stacks))
+    f:close()
+
+    return {
+        runs = runs,
+        interval = interval,
+        samples = res.samples,
+        dropped = res.dropped,
+        pathname = pathname,
+        frames = folded.summarize(stacks, c.top or CPU_PROFILE_TOP),
+    }
+end
+
+return cpu_profile_describe
@@ -0,0 +1,134 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.gc_modes
+-- Run the describe under each GC mode of Lua 5.4 in the child processes
+--
+local ipairs = ipairs
+local type = type
+local collectgarbage = collectgarbage
+local format = string.format
+local concat = table.concat
+local unpack = table.unpack or unpack
+local merge_samples = require('measure.samples').merge
+local runner = require('measure.runner')
+local with_opts = runner.with_opts
+local fork_describe = runner.fork
+local GC_STEP_AUTO = runner.GC_STEP_AUTO
+
+-- version of the running Lua runtime
+local RUNTIME_VERSION = _G.jit and _G.jit.version or _VERSION
+-- GC modes in the order to run and their parameters
+local GC_MODES = {
+    {
+        'incremental',
+        {
+            'pause',
+            'stepmul',
+            'stepsize',
+        },
+    },
+    {
+        'generational',
+        {
+            'minormul',
+            'majormul',
+        },
+    },
+}
+-- number of samples to measure with the GC stopped
+local GC_STOPPED_SAMPLES = 100
+
+--- Run the describe under each GC mode of Lua 5.4 in the child processes.
+--- The describe is also run with the GC stopped to estimate the share of the
+--- GC in the time of each mode.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param modes table The gc_modes option
+--- @return measure.samples[]? list The samples of each GC mode
+--- @return any err Error message if failed
+--- @return table? result The parameters of each mode, and the mean time and
+---                       the allocation with the GC stopped
+local function sample_gc_modes(desc, opts, modes)
+    if _VERSION ~= 'Lua 5.4' then
+        return nil, format('ERROR: gc_modes option requires Lua 5.4: %s',
+                           RUNTIME_VERSION)
+    end
+
+    -- let the GC run by itself, so the samples include the work of each mode
+    -- instead of the full GC before each sample
+    local mode_opts = with_opts(opts, {
+        gc_step = GC_STEP_AUTO,
+    })
+
+    local name = desc.spec.name
+    local list = {}
+    local result = {
+        modes = {},
+    }
+    for _, v in ipairs(GC_MODES) do
+        local mode, names = v[1], v[2]
+        local params = modes[mode]
+        if params then
+            -- zero leaves the parameter unchanged
+            local args = {}
+            local labels = {}
+            for i, k in ipairs(names) do
+                local p = type(params) == 'table' and params[k]
+                args[i] = p or 0
+                if p then
+                    labels[#labels + 1] = format('%s=%d', k, p)
+                end
+            end
+
+            local samples, err = fork_describe(desc, mode_opts,
+                                               opts.forks or 1,
+                                               'GC mode ' .. mode, function()
+                collectgarbage(mode, unpack(args))
+            end)
+            if not samples then
+                return nil, err
+            end
+            list[#list + 1] = merge_samples(format('%s [%s]', name, mode),
+                                            samples)
+            result.modes[#result.modes + 1] = {
+                mode = mode,
+                params = #labels > 0 and concat(labels, ' ') or 'default',
+            }
+        end
+    end
+
+    local stopped_opts = with_opts(opts, {
+        gc_step = 0,
+        gc_stopped = true,
+        sample_size = GC_STOPPED_SAMPLES,
+    })
+    local stopped, err = fork_describe(desc, stopped_opts, 1, 'GC stopped')
+    if not stopped then
+        return nil, err
+    end
+    result.stopped_mean = stopped[1]:mean()
+    -- the collections during the samples of each mode hide the allocation
+    result.alloc_op = stopped[1]:memstat().alloc_op
+    return list, nil, result
+end
+
+return sample_gc_modes
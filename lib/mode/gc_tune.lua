@@ -0,0 +1,98 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.gc_tune
+-- Search the GC parameters that minimize the time of the describe
+--
+local ipairs = ipairs
+local format = string.format
+local merge_samples = require('measure.samples').merge
+local gctune = require('measure.gctune')
+local runner = require('measure.runner')
+local with_opts = runner.with_opts
+local fork_describe = runner.fork
+local GC_STEP_AUTO = runner.GC_STEP_AUTO
+
+-- default number of samples of each candidate
+local GC_TUNE_SAMPLES = 100
+
+--- Search the GC parameters that minimize the time of the describe.
+--- Each candidate runs in a child process with the fixed number of samples,
+--- and the GC runs by itself during the sampling, without the full GC before
+--- each sample.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param tune table The gc_tune option
+--- @return measure.samples[]? list The samples of the default and the best
+---                                 parameters
+--- @return any err Error message if failed
+--- @return table? result The measured points and the best of them
+local function sample_gc_tune(desc, opts, tune)
+    local name = desc.spec.name
+    local objective = tune.objective or 'mean'
+    local tune_opts = with_opts(opts, {
+        gc_step = GC_STEP_AUTO,
+        sample_size = tune.samples or GC_TUNE_SAMPLES,
+    })
+
+    local list = {}
+    local points = {}
+    local cands = gctune.candidates(_VERSION == 'Lua 5.4')
+    for i, c in ipairs(cands) do
+        local samples, err = fork_describe(desc, tune_opts, 1,
+                                           format('GC tune %d/%d: %s', i,
+                                                  #cands, c.label), function()
+            gctune.apply(c)
+        end)
+        if not samples then
+            return nil, err
+        end
+        list[i] = samples[1]
+        points[i] = {
+            label = c.label,
+            mean = samples[1]:mean(),
+            p99 = samples[1]:percentile(99),
+            peak_kb = samples[1]:memstat().peak_memory,
+        }
+    end
+
+    local best, curve = gctune.select_best(points, objective, tune.max_memory)
+    local result = {
+        objective = objective,
+        max_memory = tune.max_memory,
+        points = points,
+        best = best,
+        curve = curve,
+    }
+    local samples = {
+        merge_samples(name .. ' [default]', {
+            list[1],
+        }),
+    }
+    if best then
+        samples[2] = merge_samples(name .. ' [best]', {
+            list[best],
+        })
+    end
+    return samples, nil, result
+end
+
+return sample_gc_tune
@@ -0,0 +1,80 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.heap_census
+-- Compare the objects reachable before and after the runs of the describe
+--
+local ipairs = ipairs
+local collectgarbage = collectgarbage
+local census = require('measure.census')
+local runner = require('measure.runner')
+local profile_describe = runner.profile
+
+-- default number of runs and sites to report
+local CENSUS_RUNS = 100
+local CENSUS_TOP = 10
+
+--- Compare the objects reachable before and after the runs of the describe
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param c table The heap_census option
+--- @return table? result The differences by type and by site
+--- @return any err Error message if failed
+local function census_describe(desc, opts, c)
+    -- the describe and the context are held only by the locals of this
+    -- command
+    local roots = {
+        describe = desc.spec,
+        context = opts.context,
+    }
+    local before, after
+    local runs = c.runs or CENSUS_RUNS
+    local ok, err = profile_describe(desc, opts, runs, 'Heap census', {
+        start = function()
+            collectgarbage('collect')
+            before = census.census(roots)
+        end,
+        stop = function()
+            collectgarbage('collect')
+            after = census.census(roots)
+        end,
+    })
+    if not ok then
+        return nil, err
+    end
+
+    local res = census.diff(before, after)
+    local sites = {}
+    for _, v in ipairs(res.sites) do
+        if #sites == (c.top or CENSUS_TOP) then
+            break
+        elseif v.count > 0 or v.size > 0 then
+            sites[#sites + 1] = v
+        end
+    end
+    return {
+        runs = runs,
+        types = res.types,
+        sites = sites,
+    }
+end
+
+return census_describe
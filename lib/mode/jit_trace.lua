@@ -0,0 +1,51 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.jit_trace
+-- Run the describe with the trace events of LuaJIT recorded
+--
+local runner = require('measure.runner')
+local with_opts = runner.with_opts
+local sample_describe = runner.sample
+
+--- Run the describe with the trace events of LuaJIT recorded.
+--- The events of setup() are counted in the warmup phase.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param recorder measure.jittrace The recorder of the trace events
+--- @return measure.samples? samples The samples object with collected data
+--- @return any err Error message if failed
+--- @return measure.jittrace.result? result The trace events by phase
+local function jit_trace_describe(desc, opts, recorder)
+    local trace_opts = with_opts(opts, {
+        jit_trace = recorder,
+    })
+
+    recorder:start()
+    local samples, err = sample_describe(desc, trace_opts)
+    local result = recorder:stop()
+    if not samples then
+        return nil, err
+    end
+    return samples, nil, result
+end
+
+return jit_trace_describe
@@ -0,0 +1,70 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.leak_check
+-- Test whether the describe retains memory on each invocation
+--
+local floor = math.floor
+local stats_leak = require('measure.stats.leak')
+local runner = require('measure.runner')
+local with_opts = runner.with_opts
+local sample_describe = runner.sample
+local printf = runner.printf
+local GC_STEP_AUTO = runner.GC_STEP_AUTO
+
+-- default number of samples and probe interval
+local LEAK_SAMPLES = 200
+local LEAK_INTERVAL = 1
+
+--- Test whether the describe retains memory on each invocation.
+--- The describe runs again in this process with the fixed number of samples
+--- and without the full GC before each sample, and the heap size after a
+--- full GC is probed every interval invocations.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param check table The leak_check option
+--- @return table? result The growth of the heap per invocation
+--- @return any err Error message if failed
+local function leak_describe(desc, opts, check)
+    local leak_opts = with_opts(opts, {
+        gc_step = GC_STEP_AUTO,
+        sample_size = check.samples or LEAK_SAMPLES,
+        heap_interval = check.interval or LEAK_INTERVAL,
+    })
+    -- allocate the probes in advance, so that recording them does not grow
+    -- the heap
+    local heap = {}
+    for i = 1, floor(leak_opts.sample_size / leak_opts.heap_interval) do
+        heap[i] = 0
+    end
+    leak_opts.heap = heap
+
+    printf('    - Leak check %d samples (probe every %d)',
+           leak_opts.sample_size, leak_opts.heap_interval)
+    local samples, err = sample_describe(desc, leak_opts)
+    if not samples then
+        return nil, err
+    end
+    return stats_leak(leak_opts.heap, leak_opts.heap_interval,
+                      opts.confidence_level)
+end
+
+return leak_describe
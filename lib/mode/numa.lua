@@ -0,0 +1,98 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.numa
+-- Run the describe in the child processes bound to the NUMA nodes
+--
+local ipairs = ipairs
+local error = error
+local format = string.format
+local merge_samples = require('measure.samples').merge
+local numa = require('measure.numa')
+local runner = require('measure.runner')
+local fork_describe = runner.fork
+
+--- Run the describe in the child processes bound to the NUMA nodes: with the
+--- CPU and the memory on the same node, and with the memory on the remote
+--- node if set.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param c table The numa option
+--- @return measure.samples[]? list The samples of each placement
+--- @return any err Error message if failed
+--- @return table? result The placements and the number of the nodes
+local function sample_numa(desc, opts, c)
+    local nodes, err = numa.nodes()
+    if not nodes then
+        return nil, format('ERROR: numa option is not available: %s', err)
+    end
+    local by_node = {}
+    for _, node in ipairs(nodes) do
+        by_node[node.node] = node
+    end
+    if not by_node[c.node] or #by_node[c.node].cpus == 0 then
+        return nil, format('ERROR: numa node %d has no CPUs', c.node)
+    elseif c.remote and not by_node[c.remote] then
+        return nil, format('ERROR: numa node %d is not found', c.remote)
+    end
+
+    local placements = {
+        {
+            kind = 'local',
+            cpu_node = c.node,
+            mem_node = c.node,
+            ncpu = #by_node[c.node].cpus,
+        },
+    }
+    if c.remote then
+        placements[2] = {
+            kind = 'remote',
+            cpu_node = c.node,
+            mem_node = c.remote,
+            ncpu = #by_node[c.node].cpus,
+        }
+    end
+
+    local name = desc.spec.name
+    local list = {}
+    for _, placement in ipairs(placements) do
+        local samples
+        samples, err = fork_describe(desc, opts, opts.forks or 1,
+                                     'NUMA ' .. placement.kind, function()
+            -- bind before setup() so that its allocations are placed too
+            local ok, berr = numa.bind(placement.cpu_node, placement.mem_node)
+            if not ok then
+                error(berr, 0)
+            end
+        end)
+        if not samples then
+            return nil, err
+        end
+        list[#list + 1] = merge_samples(format('%s [%s]', name,
+                                               placement.kind), samples)
+    end
+    return list, nil, {
+        nodes = #nodes,
+        placements = placements,
+    }
+end
+
+return sample_numa
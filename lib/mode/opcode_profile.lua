@@ -0,0 +1,154 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.opcode_profile
+-- Count the VM instructions executed by the describe by opcode class and by
+-- function
+--
+local ipairs = ipairs
+local pairs = pairs
+local format = string.format
+local min = math.min
+local sort = table.sort
+local bytecode = require('measure.bytecode')
+local vmprof = require('measure.vmprof')
+local runner = require('measure.runner')
+local profile_describe = runner.profile
+local NOOP = runner.NOOP
+
+-- default number of runs and functions to report
+local OPCODE_PROFILE_RUNS = 10
+local OPCODE_PROFILE_TOP = 10
+
+--- Count the VM instructions executed by the describe by opcode class and by
+--- function. The count hook tells only the line of each instruction, so the
+--- instructions of a line are divided among the classes of the opcodes of
+--- the line in proportion to their number in the bytecode.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param c table The opcode_profile option
+--- @return table? result The instructions by class and by function
+--- @return any err Error message if failed
+local function opcode_profile_describe(desc, opts, c)
+    -- confirm that the bytecode of this runtime can be decoded
+    local ok, err = bytecode.line_classes(NOOP)
+    if not ok then
+        return nil, format('opcode_profile is not available: %s', err)
+    end
+
+    local res
+    local runs = c.runs or OPCODE_PROFILE_RUNS
+    ok, err = profile_describe(desc, opts, runs, 'Opcode profile', {
+        start = function()
+            assert(vmprof.start())
+        end,
+        stop = function()
+            res = assert(vmprof.stop())
+        end,
+    })
+    if not ok then
+        -- remove the hook if the run failed during the profile
+        vmprof.stop()
+        return nil, err
+    end
+
+    -- the instructions of this command are not counted
+    local srcs = runner.caller_sources()
+    local total = 0
+    local classes = {}
+    local functions = {}
+    local list = {}
+    for _, l in ipairs(res.lines) do
+        if not srcs[l.source] then
+            local key = l.source .. ':' .. l.linedefined
+            local f = functions[key]
+            if not f then
+                f = {
+                    source = l.source,
+                    linedefined = l.linedefined,
+                    count = 0,
+                    classes = {},
+                    lines = bytecode.line_classes(res.functions[key]) or {},
+                }
+                functions[key] = f
+                list[#list + 1] = f
+            end
+
+            local weights = f.lines[l.line] or {
+                other = 1,
+            }
+            local n = 0
+            for _, w in pairs(weights) do
+                n = n + w
+            end
+            for class, w in pairs(weights) do
+                local v = l.count * w / n
+                classes[class] = (classes[class] or 0) + v
+                f.classes[class] = (f.classes[class] or 0) + v
+            end
+            f.count = f.count + l.count
+            total = total + l.count
+        end
+    end
+
+    local by_class = {}
+    for class, v in pairs(classes) do
+        by_class[#by_class + 1] = {
+            class = class,
+            count = v,
+        }
+    end
+    sort(by_class, function(a, b)
+        return a.count > b.count
+    end)
+
+    sort(list, function(a, b)
+        return a.count > b.count
+    end)
+    local by_function = {}
+    for i = 1, min(#list, c.top or OPCODE_PROFILE_TOP) do
+        local f = list[i]
+        local top
+        for class, v in pairs(f.classes) do
+            if not top or v > f.classes[top] or
+                (v == f.classes[top] and class < top) then
+                top = class
+            end
+        end
+        by_function[i] = {
+            source = f.source,
+            linedefined = f.linedefined,
+            count = f.count,
+            class = top,
+            class_count = f.classes[top],
+        }
+    end
+
+    return {
+        runs = runs,
+        count = total,
+        dropped = res.dropped,
+        classes = by_class,
+        functions = by_function,
+    }
+end
+
+return opcode_profile_describe
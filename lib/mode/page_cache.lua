@@ -0,0 +1,93 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.page_cache
+-- Run the describe with the fixture files warm and evicted from the page
+-- cache in the child processes
+--
+local ipairs = ipairs
+local error = error
+local format = string.format
+local merge_samples = require('measure.samples').merge
+local pagecache = require('measure.pagecache')
+local runner = require('measure.runner')
+local with_opts = runner.with_opts
+local fork_describe = runner.fork
+
+--- Run the describe with the fixture files warm and evicted from the page
+--- cache in the child processes. The files are read or evicted before each
+--- sample, outside the timed region.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param files string[] The page_cache option
+--- @return measure.samples[]? list The samples of the warm and the cold files
+--- @return any err Error message if failed
+--- @return table? result The total size of the files and the share of their
+---                       pages evicted from the page cache
+local function sample_page_cache(desc, opts, files)
+    -- confirm that the files can be evicted before forking
+    local size = 0
+    local resident = 0
+    for _, pathname in ipairs(files) do
+        local ok, err = pagecache.evict(pathname)
+        if not ok then
+            return nil, format('ERROR: failed to evict %q: %s', pathname, err)
+        end
+        local bytes, nbyte = pagecache.resident(pathname)
+        if bytes then
+            size = size + nbyte
+            resident = resident + bytes
+        end
+    end
+
+    local name = desc.spec.name
+    local list = {}
+    for _, kind in ipairs({
+        'warm',
+        'cold',
+    }) do
+        local prepare = kind == 'warm' and pagecache.warm or pagecache.evict
+        local cache_opts = with_opts(opts, {
+            before = function()
+                for _, pathname in ipairs(files) do
+                    local ok, err = prepare(pathname)
+                    if not ok then
+                        error(format('failed to prepare %q: %s', pathname,
+                                     err))
+                    end
+                end
+            end,
+        })
+
+        local samples, err = fork_describe(desc, cache_opts, opts.forks or 1,
+                                           'Page cache ' .. kind)
+        if not samples then
+            return nil, err
+        end
+        list[#list + 1] = merge_samples(format('%s [%s]', name, kind), samples)
+    end
+    return list, nil, {
+        size = size,
+        evicted = size > 0 and (size - resident) / size or 1,
+    }
+end
+
+return sample_page_cache
@@ -0,0 +1,137 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.mode.require
+-- Measure the cost of require() of a module in fresh child processes
+--
+local ipairs = ipairs
+local assert = assert
+local format = string.format
+local max = math.max
+local sort = table.sort
+local new_samples = require('measure.samples').new
+local stats_ci = require('measure.stats.ci')
+local forkrun = require('measure.forkrun')
+local loadcost = require('measure.loadcost')
+local serialize = require('measure.serialize')
+local runner = require('measure.runner')
+local printf = runner.printf
+
+--- Calculate the mean of the values
+--- @param values number[] The values
+--- @return number? mean The mean or nil if no values
+local function mean_of(values)
+    if #values == 0 then
+        return nil
+    end
+    local sum = 0
+    for _, v in ipairs(values) do
+        sum = sum + v
+    end
+    return sum / #values
+end
+
+--- Measure the cost of require() of the module.
+--- Each sample forks a child process that loads the module into a new Lua
+--- state, so only the Lua-side package.loaded state is fresh in each sample.
+--- The C libraries already loaded by the parent process stay mapped in the
+--- child, so their cost is excluded.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @return measure.samples? samples The load time and the Lua heap growth
+--- @return any err Error message if failed
+--- @return table? result The memory footprint and the loaded modules
+local function sample_require(desc, opts)
+    local modname = desc.spec.require
+    local path, cpath = package.path, package.cpath
+    local dump = {
+        name = desc.spec.name,
+        capacity = 1,
+        count = 0,
+        gc_step = opts.gc_step,
+        cl = opts.confidence_level,
+        rciw = opts.rciw,
+        base_kb = 1,
+        time_ns = {},
+        before_kb = {},
+        after_kb = {},
+    }
+    local allocated = {}
+    local retained = {}
+    local rss = {}
+    local modules
+
+    local samples
+    local iteration = 1
+    local sample_size = 30
+    while sample_size do
+        printf('    - Sampling %d samples (iteration %d)', sample_size,
+               iteration)
+        for i = dump.count + 1, sample_size do
+            local src, err = forkrun(function()
+                local res = assert(loadcost(modname, path, cpath))
+                return assert(serialize.encode(res))
+            end)
+            if not src then
+                return nil, format('ERROR: require(%q): %s', modname, err)
+            end
+
+            local res
+            res, err = serialize.decode(src)
+            if not res then
+                return nil, format('ERROR: require(%q): %s', modname, err)
+            end
+            dump.time_ns[i] = res.time_ns
+            dump.before_kb[i] = res.before_kb
+            dump.after_kb[i] = res.after_kb
+            allocated[#allocated + 1] = res.after_kb - res.before_kb
+            retained[#retained + 1] = res.retained_kb
+            rss[#rss + 1] = res.rss_kb
+            modules = modules or res.modules
+        end
+        dump.count = sample_size
+        dump.capacity = sample_size
+        dump.base_kb = max(dump.before_kb[1], 1)
+        samples = assert(new_samples(dump))
+
+        sample_size = stats_ci(samples, opts.max_sample_size).resample_size
+        iteration = iteration + 1
+    end
+
+    -- list the modules loaded by the module except itself
+    local deps = {}
+    for _, v in ipairs(modules) do
+        if v ~= modname then
+            deps[#deps + 1] = v
+        end
+    end
+    sort(deps)
+
+    return samples, nil, {
+        module = modname,
+        modules = deps,
+        allocated_kb = mean_of(allocated),
+        retained_kb = mean_of(retained),
+        rss_kb = mean_of(rss),
+    }
+end
+
+return sample_require
@@ -23,6 +23,8 @@
 -- This is the main entry point for the measure benchmarking library
 --
 local type = type
+local pairs = pairs
+local ipairs = ipairs
 local tostring = tostring
 local format = string.format
 local error = error
@@ -36,6 +38,21 @@ local INF_NEG = -INF_POS
 --- @field gc_step number|nil Garbage collection step size for sampling (default: 0 = full GC)
 --- @field confidence_level number|nil confidence level in percentage (0-100, default: 95)
 --- @field rciw number|nil relative confidence interval width in percentage (0-100, default: 5)
+--- @field forks integer|nil number of child processes to run the benchmark in (1-100, default: nil = run in the current process)
+--- @field cold_start integer|nil number of first invocations to measure in fresh child processes (1-10000, default: nil = disabled)
+--- @field ab table|nil A/B comparison of two module versions: { a = root|{path, cpath}, b = root|{path, cpath}, rounds = 10, samples = 100 }
+--- @field gc_modes table|nil GC modes of Lua 5.4 to run the benchmark under: { incremental = true|{pause, stepmul, stepsize}, generational = true|{minormul, majormul} }
+--- @field gc_tune table|nil GC parameter tuning: { objective = "mean"|"p99", max_memory = KB, samples = 100 }
+--- @field leak_check boolean|table|nil leak detection after the sampling: true or { interval = 1, samples = 200 }
+--- @field heap_census boolean|table|nil heap census before and after the runs: true or { runs = 100, top = 10 }
+--- @field alloc_profile boolean|table|nil allocation sites of the runs: true or { runs = 100, top = 10 }
+--- @field cold_cache boolean|table|nil samples with the CPU caches evicted: true or { size_kb = 2 * LLC }
+--- @field page_cache string[]|nil fixture files to read warm and evicted from the page cache before each sample
+--- @field numa table|nil NUMA nodes to bind the benchmark to: { node = 0, remote = 1 }
+--- @field jit_trace boolean|nil record the trace events of LuaJIT during the warmup and the sampling
+--- @field opcode_profile boolean|table|nil VM instructions of the runs by class: true or { runs = 10, top = 10 }
+--- @field cpu_profile boolean|table|nil sampled stacks of the runs: true or { duration = 1, interval = 1000, top = 10, dir = 'measure_records/profile' }
+--- @field allocators string[]|nil allocators to run the benchmark under ("system", "arena" or "pool"), the first one is the baseline
 
 --- Prevent modification of measure.options
 --- @param _ table The table being modified
@@ -44,10 +61,341 @@ local function prevent_new_index(_, key)
     error(format('Attempt to modify measure.options: %q', tostring(key)), 2)
 end
 
+--- Options that run the describe as the variants of their own, so only one
+--- of them can be set for a describe
+local VARIANT_OPTIONS = {
+    'ab',
+    'gc_modes',
+    'gc_tune',
+    'cold_cache',
+    'page_cache',
+    'numa',
+    'allocators',
+}
+
+--- Options that measure or analyze the steady state of the describe, which is
+--- not run when a variant option is set
+local STEADY_STATE_OPTIONS = {
+    'cold_start',
+    'jit_trace',
+    'leak_check',
+    'heap_census',
+    'alloc_profile',
+    'cpu_profile',
+    'opcode_profile',
+}
+
+--- Variant options that run their own rounds instead of the forks option
+local NO_FORKS_OPTIONS = {
+    ab = true,
+    gc_tune = true,
+}
+
 -- Create the measure.options object
 local Options = require('measure.metatable')('measure.options')
 Options.__newindex = prevent_new_index
 
+--- Validate the variant of the A/B comparison
+--- @param v any The root directory or the table of path and cpath
+--- @return boolean ok True if valid
+local function is_valid_variant(v)
+    local t = type(v)
+    if t == 'string' then
+        return v ~= ''
+    elseif t ~= 'table' then
+        return false
+    end
+    return (type(v.path) == 'string' or type(v.cpath) == 'string') and
+               (v.path == nil or type(v.path) == 'string') and
+               (v.cpath == nil or type(v.cpath) == 'string')
+end
+
+--- Validate the A/B comparison option
+--- @param ab any The ab option
+--- @return boolean ok True if valid
+--- @return string|nil err Error message if invalid
+local function validate_ab(ab)
+    if type(ab) ~= 'table' then
+        return false, 'options.ab must be a table'
+    end
+    for _, k in ipairs({
+        'a',
+        'b',
+    }) do
+        if not is_valid_variant(ab[k]) then
+            return false, format(
+                       'options.ab.%s must be a root directory or a table of path and cpath',
+                       k)
+        end
+    end
+
+    local v = ab.rounds
+    if v ~= nil and
+        (type(v) ~= 'number' or v ~= floor(v) or v < 2 or v > 100) then
+        return false, 'options.ab.rounds must be an integer between 2 and 100'
+    end
+    v = ab.samples
+    if v ~= nil and
+        (type(v) ~= 'number' or v ~= floor(v) or v < 10 or v > 10000) then
+        return false,
+               'options.ab.samples must be an integer between 10 and 10000'
+    end
+    return true
+end
+
+--- Validate the gc_tune option
+--- @param tune any The gc_tune option
+--- @return boolean ok True if valid
+--- @return string|nil err Error message if invalid
+local function validate_gc_tune(tune)
+    if type(tune) ~= 'table' then
+        return false, 'options.gc_tune must be a table'
+    end
+    local v = tune.objective
+    if v ~= nil and v ~= 'mean' and v ~= 'p99' then
+        return false, 'options.gc_tune.objective must be "mean" or "p99"'
+    end
+    v = tune.max_memory
+    if v ~= nil and (type(v) ~= 'number' or not (v > 0) or v == INF_POS) then
+        return false, 'options.gc_tune.max_memory must be a positive number'
+    end
+    v = tune.samples
+    if v ~= nil and
+        (type(v) ~= 'number' or v ~= floor(v) or v < 10 or v > 10000) then
+        return false,
+               'options.gc_tune.samples must be an integer between 10 and 10000'
+    end
+    return true
+end
+
+--- Validate the leak_check option
+--- @param check any The leak_check option
+--- @return boolean ok True if valid
+--- @return string|nil err Error message if invalid
+local function validate_leak_check(check)
+    if check == true then
+        return true
+    elseif type(check) ~= 'table' then
+        return false, 'options.leak_check must be true or a table'
+    end
+    local v = check.interval
+    if v ~= nil and
+        (type(v) ~= 'number' or v ~= floor(v) or v < 1 or v > 1000) then
+        return false,
+               'options.leak_check.interval must be an integer between 1 and 1000'
+    end
+    v = check.samples
+    if v ~= nil and
+        (type(v) ~= 'number' or v ~= floor(v) or v < 10 or v > 100000) then
+        return false,
+               'options.leak_check.samples must be an integer between 10 and 100000'
+    end
+    if (check.samples or 200) < (check.interval or 1) * 3 then
+        return false,
+               'options.leak_check.samples must be at least 3 times the interval'
+    end
+    return true
+end
+
+--- Validate the option of the profiling pass (heap_census, alloc_profile,
+--- opcode_profile)
+--- @param name string The name of the option
+--- @param c any The option
+--- @return boolean ok True if valid
+--- @return string|nil err Error message if invalid
+local function validate_profile(name, c)
+    if c == true then
+        return true
+    elseif type(c) ~= 'table' then
+        return false, format('options.%s must be true or a table', name)
+    end
+    local v = c.runs
+    if v ~= nil and
+        (type(v) ~= 'number' or v ~= floor(v) or v < 1 or v > 100000) then
+        return false, format(
+                   'options.%s.runs must be an integer between 1 and 100000',
+                   name)
+    end
+    v = c.top
+    if v ~= nil and
+        (type(v) ~= 'number' or v ~= floor(v) or v < 1 or v > 100) then
+        return false, format(
+                   'options.%s.top must be an integer between 1 and 100', name)
+    end
+    return true
+end
+
+--- Validate the cold_cache option
+--- @param c any The cold_cache option
+--- @return boolean ok True if valid
+--- @return string|nil err Error message if invalid
+local function validate_cold_cache(c)
+    if c == true then
+        return true
+    elseif type(c) ~= 'table' then
+        return false, 'options.cold_cache must be true or a table'
+    end
+    local v = c.size_kb
+    if v ~= nil and
+        (type(v) ~= 'number' or v ~= floor(v) or v < 64 or v > 16777216) then
+        return false,
+               'options.cold_cache.size_kb must be an integer between 64 and 16777216'
+    end
+    return true
+end
+
+--- Validate the page_cache option
+--- @param c any The page_cache option
+--- @return boolean ok True if valid
+--- @return string|nil err Error message if invalid
+local function validate_page_cache(c)
+    if type(c) ~= 'table' or #c == 0 then
+        return false, 'options.page_cache must be a non-empty list of pathnames'
+    end
+    for i, v in ipairs(c) do
+        if type(v) ~= 'string' or v == '' then
+            return false, format(
+                       'options.page_cache[%d] must be a non-empty string', i)
+        end
+    end
+    return true
+end
+
+--- Validate the numa option
+--- @param c any The numa option
+--- @return boolean ok True if valid
+--- @return string|nil err Error message if invalid
+local function validate_numa(c)
+    if type(c) ~= 'table' then
+        return false, 'options.numa must be a table'
+    end
+    for _, k in ipairs({
+        'node',
+        'remote',
+    }) do
+        local v = c[k]
+        if (v ~= nil or k == 'node') and
+            (type(v) ~= 'number' or v ~= floor(v) or v < 0 or v > 1023) then
+            return false, format(
+                       'options.numa.%s must be an integer between 0 and 1023',
+                       k)
+        end
+    end
+    if c.remote == c.node then
+        return false, 'options.numa.remote must be different from node'
+    end
+    return true
+end
+
+--- Validate the cpu_profile option
+--- @param c any The cpu_profile option
+--- @return boolean ok True if valid
+--- @return string|nil err Error message if invalid
+local function validate_cpu_profile(c)
+    if c == true then
+        return true
+    elseif type(c) ~= 'table' then
+        return false, 'options.cpu_profile must be true or a table'
+    end
+    local v = c.duration
+    if v ~= nil and (type(v) ~= 'number' or not (v >= 0.1 and v <= 60)) then
+        return false,
+               'options.cpu_profile.duration must be a number between 0.1 and 60'
+    end
+    v = c.interval
+    if v ~= nil and
+        (type(v) ~= 'number' or v ~= floor(v) or v < 100 or v > 100000) then
+        return false,
+               'options.cpu_profile.interval must be an integer between 100 and 100000'
+    end
+    v = c.top
+    if v ~= nil and
+        (type(v) ~= 'number' or v ~= floor(v) or v < 1 or v > 100) then
+        return false,
+               'options.cpu_profile.top must be an integer between 1 and 100'
+    end
+    v = c.dir
+    if v ~= nil and (type(v) ~= 'string' or v == '') then
+        return false, 'options.cpu_profile.dir must be a non-empty string'
+    end
+    return true
+end
+
+-- Allocators of the allocators option
+local ALLOCATORS = {
+    system = true,
+    arena = true,
+    pool = true,
+}
+
+--- Validate the allocators option
+--- @param list any The allocators option
+--- @return boolean ok True if valid
+local function is_valid_allocators(list)
+    if type(list) ~= 'table' or #list == 0 then
+        return false
+    end
+    local seen = {}
+    for _, v in ipairs(list) do
+        if not ALLOCATORS[v] or seen[v] then
+            return false
+        end
+        seen[v] = true
+    end
+    return true
+end
+
+-- Parameters of each GC mode of the gc_modes option
+local GC_MODE_PARAMS = {
+    incremental = {
+        pause = true,
+        stepmul = true,
+        stepsize = true,
+    },
+    generational = {
+        minormul = true,
+        majormul = true,
+    },
+}
+
+--- Validate the gc_modes option
+--- @param modes any The gc_modes option
+--- @return boolean ok True if valid
+--- @return string|nil err Error message if invalid
+local function validate_gc_modes(modes)
+    if type(modes) ~= 'table' or
+        (modes.incremental == nil and modes.generational == nil) then
+        return false,
+               'options.gc_modes must be a table of incremental and/or generational'
+    end
+    for mode, params in pairs(modes) do
+        local names = GC_MODE_PARAMS[mode]
+        if not names then
+            return false, format('options.gc_modes.%s is not a GC mode',
+                                 tostring(mode))
+        elseif params ~= true then
+            if type(params) ~= 'table' then
+                return false, format(
+                           'options.gc_modes.%s must be true or a table of parameters',
+                           mode)
+            end
+            for k, v in pairs(params) do
+                if not names[k] then
+                    return false, format(
+                               'options.gc_modes.%s.%s is not a parameter of the mode',
+                               mode, tostring(k))
+                elseif type(v) ~= 'number' or v ~= floor(v) or v < 1 or v >
+                    1000 then
+                    return false, format(
+                               'options.gc_modes.%s.%s must be an integer between 1 and 1000',
+                               mode, k)
+                end
+            end
+        end
+    end
+    return true
+end
+
 --- Validate options table values
 --- @param opts table The options table to validate
 --- @return boolean ok True if valid
@@ -95,9 +443,152 @@ local function validate_options(opts)
         end
     end
 
+    -- Validate forks
+    if opts.forks ~= nil then
+        local v = opts.forks
+        if type(v) ~= 'number' or v ~= floor(v) or v < 1 or v > 100 then
+            return false, 'options.forks must be an integer between 1 and 100'
+        end
+    end
+
+    -- Validate cold_start
+    if opts.cold_start ~= nil then
+        local v = opts.cold_start
+        if type(v) ~= 'number' or v ~= floor(v) or v < 1 or v > 10000 then
+            return false,
+                   'options.cold_start must be an integer between 1 and 10000'
+        end
+    end
+
+    -- Validate ab
+    if opts.ab ~= nil then
+        local ok, err = validate_ab(opts.ab)
+        if not ok then
+            return false, err
+        end
+    end
+
+    -- Validate gc_modes
+    if opts.gc_modes ~= nil then
+        local ok, err = validate_gc_modes(opts.gc_modes)
+        if not ok then
+            return false, err
+        end
+    end
+
+    -- Validate gc_tune
+    if opts.gc_tune ~= nil then
+        local ok, err = validate_gc_tune(opts.gc_tune)
+        if not ok then
+            return false, err
+        end
+    end
+
+    -- Validate leak_check
+    if opts.leak_check ~= nil then
+        local ok, err = validate_leak_check(opts.leak_check)
+        if not ok then
+            return false, err
+        end
+    end
+
+    -- Validate cold_cache
+    if opts.cold_cache ~= nil then
+        local ok, err = validate_cold_cache(opts.cold_cache)
+        if not ok then
+            return false, err
+        end
+    end
+
+    -- Validate page_cache
+    if opts.page_cache ~= nil then
+        local ok, err = validate_page_cache(opts.page_cache)
+        if not ok then
+            return false, err
+        end
+    end
+
+    -- Validate numa
+    if opts.numa ~= nil then
+        local ok, err = validate_numa(opts.numa)
+        if not ok then
+            return false, err
+        end
+    end
+
+    -- Validate jit_trace
+    if opts.jit_trace ~= nil and type(opts.jit_trace) ~= 'boolean' then
+        return false, 'options.jit_trace must be a boolean'
+    end
+
+    -- Validate heap_census, alloc_profile and opcode_profile
+    for _, name in ipairs({
+        'heap_census',
+        'alloc_profile',
+        'opcode_profile',
+    }) do
+        if opts[name] ~= nil then
+            local ok, err = validate_profile(name, opts[name])
+            if not ok then
+                return false, err
+            end
+        end
+    end
+
+    -- Validate cpu_profile
+    if opts.cpu_profile ~= nil then
+        local ok, err = validate_cpu_profile(opts.cpu_profile)
+        if not ok then
+            return false, err
+        end
+    end
+
+    -- Validate allocators
+    if opts.allocators ~= nil and not is_valid_allocators(opts.allocators) then
+        return false,
+               'options.allocators must be a list of unique "system", "arena" or "pool"'
+    end
+
+    -- Validate the combination of the variant options
+    local variant
+    for _, k in ipairs(VARIANT_OPTIONS) do
+        if opts[k] ~= nil then
+            if variant then
+                return false,
+                       format('options.%s cannot be combined with options.%s',
+                              k, variant)
+            end
+            variant = k
+        end
+    end
+    if variant then
+        for _, k in ipairs(STEADY_STATE_OPTIONS) do
+            if opts[k] then
+                return false,
+                       format('options.%s cannot be combined with options.%s',
+                              k, variant)
+            end
+        end
+        if opts.forks and NO_FORKS_OPTIONS[variant] then
+            return false,
+                   format('options.forks cannot be combined with options.%s',
+                          variant)
+        end
+    end
+
     return true
 end
 
+--- Get the option that is true or a table as a table
+--- @param v boolean|table|nil The option
+--- @return table|nil v The option, or an empty table if true
+local function as_table(v)
+    if v == true then
+        return {}
+    end
+    return v
+end
+
 --- Configure benchmark execution parameters
 --- @param opts table The options table
 --- @return measure.options? options The validated options table
@@ -121,6 +612,21 @@ local function new_options(opts)
         gc_step = opts.gc_step or 0,
         confidence_level = opts.confidence_level or 95,
         rciw = opts.rciw or 5,
+        forks = opts.forks,
+        cold_start = opts.cold_start,
+        ab = opts.ab,
+        gc_modes = opts.gc_modes,
+        gc_tune = opts.gc_tune,
+        leak_check = as_table(opts.leak_check),
+        heap_census = as_table(opts.heap_census),
+        alloc_profile = as_table(opts.alloc_profile),
+        cold_cache = as_table(opts.cold_cache),
+        page_cache = opts.page_cache,
+        numa = opts.numa,
+        jit_trace = opts.jit_trace,
+        opcode_profile = as_table(opts.opcode_profile),
+        cpu_profile = as_table(opts.cpu_profile),
+        allocators = opts.allocators,
     }, Options)
 end
 
@@ -27,10 +27,12 @@ local type = type
 local print = print
 local find = string.find
 local format = string.format
+local match = string.match
 local concat = table.concat
 local sort = table.sort
 local stats_summary = require('measure.stats.summary')
 local compare_samples = require('measure.compare')
+local welcht = require('measure.posthoc.welcht')
 local new_table = require('measure.report.table')
 local fmt = require('measure.report.format')
 local report_sysinfo = require('measure.report.sysinfo')
@@ -62,6 +64,7 @@ end
 --- @field protected baseline_summary measure.stat.summary Optional baseline summary
 --- @field protected summaries measure.stat.summary[] List of statistical summaries
 --- @field protected comparisons measure.compare.result Result of sample comparisons
+--- @field protected analyses table Additional analyses keyed by kind (e.g. forks, cold_start, require, ab, allocators, gc_modes, gc_tune, leak, census, alloc_sites, cpu_profile, opcodes, jit_trace, cold_cache, page_cache, numa)
 --- @field protected file? file* Optional file handle for output (defaults to stdout)
 --- @field protected tee boolean If true, also print to stdout when file is given
 local Report = {}
@@ -169,6 +172,10 @@ function Report:memory_analysis()
     tbl:add_column("Peak Memory", true)
     tbl:add_column("Uncollected", true)
     tbl:add_column("Avg Incr.", true)
+    tbl:add_column("Peak RSS", true)
+    tbl:add_column("RSS Growth", true)
+    tbl:add_column("Native", true)
+    tbl:add_column("Malloc Free", true)
 
     -- Sort samples by allocation rate (descending)
     local summaries = self:get_summaries()
@@ -199,13 +206,17 @@ function Report:memory_analysis()
             fmt.memory(memstat.peak_memory),
             fmt.memory(memstat.uncollected),
             fmt.memory(memstat.avg_incr),
+            fmt.memory(memstat.peak_rss),
+            fmt.memory(memstat.rss_growth),
+            fmt.memory(memstat.native_kb),
+            fmt.memory(memstat.malloc_free_kb),
         })
     end
 
     self:print([[
 ### Memory Analysis
 
-*Sorted by Alloc/Op (lower is better).*
+*Sorted by Alloc/Op (lower is better). Peak RSS and RSS Growth are the resident set size of the process after each sample. Native is the growth of the memory in use by malloc during the sampling minus the growth of the Lua heap, i.e. the memory kept by the C code, and Malloc Free is the free memory held by the malloc arenas after it.*
 ]])
     self:print(concat(tbl:render(), '\n'))
 end
@@ -462,6 +473,1095 @@ function Report:cluster_analysis_welcht()
     self:print(concat(tbl:render(), '\n'))
 end
 
+-- Print the confidence intervals that include the between-fork variance
+function Report:fork_analysis()
+    local results = self.analyses.forks
+    if not results then
+        return
+    end
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Forks", true)
+    tbl:add_column("Mean", true)
+    tbl:add_column("CI Level")
+    tbl:add_column("RCIW", true)
+    tbl:add_column("Pooled RCIW", true)
+    tbl:add_column("Between StdDev", true)
+    tbl:add_column("ICC", true)
+
+    for _, samples in ipairs(self.samples_list) do
+        local res = results[samples:name()]
+        if res then
+            tbl:add_rows({
+                samples:name(),
+                tostring(res.forks),
+                fmt.time(res.mean),
+                format("%d%% [%s - %s]", res.level, fmt.time(res.lower),
+                       fmt.time(res.upper)),
+                format("%.1f%%", res.rciw),
+                format("%.1f%%", res.pooled_rciw),
+                fmt.time(res.between_stddev),
+                format("%.2f", res.icc),
+            })
+        end
+    end
+
+    self:print([[
+### Fork Analysis
+
+*RCIW includes the run-to-run variance between the child processes. Pooled RCIW treats all samples as one process. ICC is the share of the variance between the processes.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+end
+
+--- Select the invocation indices to show on the warm-up curve.
+--- All indices are returned up to 10 invocations, otherwise the first five
+--- and then 1-2-5 steps up to the last invocation.
+--- @param n integer The number of invocations
+--- @return integer[] indices
+local function curve_indices(n)
+    local indices = {}
+    for i = 1, n < 10 and n or 5 do
+        indices[#indices + 1] = i
+    end
+    if n >= 10 then
+        local base = 10
+        while base <= n do
+            for _, m in ipairs({
+                1,
+                2,
+                5,
+            }) do
+                if base * m <= n then
+                    indices[#indices + 1] = base * m
+                end
+            end
+            base = base * 10
+        end
+        if indices[#indices] ~= n then
+            indices[#indices + 1] = n
+        end
+    end
+    return indices
+end
+
+-- Print the first-call latency and the warm-up curve of the fresh processes
+function Report:cold_start_analysis()
+    local results = self.analyses.cold_start
+    if not results then
+        return
+    end
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Runs", true)
+    tbl:add_column("First Call", true)
+    tbl:add_column("First Call Max", true)
+    tbl:add_column("Steady Mean", true)
+    tbl:add_column("Slowdown", true)
+    tbl:add_column("Warm After", true)
+
+    -- rows of the warm-up curve
+    local ncall = 0
+    local rows = {}
+    for _, samples in ipairs(self.samples_list) do
+        local res = results[samples:name()]
+        if res then
+            tbl:add_rows({
+                samples:name(),
+                tostring(res.runs),
+                fmt.time(res.first.median),
+                fmt.time(res.first.max),
+                fmt.time(res.steady_mean),
+                res.slowdown == res.slowdown and
+                    format("%.2fx", res.slowdown) or "-",
+                res.warm_after and format("%d calls", res.warm_after) or
+                    format("> %d calls", res.invocations),
+            })
+            rows[#rows + 1] = {
+                name = samples:name(),
+                curve = res.curve,
+            }
+            if res.invocations > ncall then
+                ncall = res.invocations
+            end
+        end
+    end
+
+    local curve = new_table()
+    local indices = curve_indices(ncall)
+    curve:add_column("Name")
+    for _, idx in ipairs(indices) do
+        curve:add_column(format("#%d", idx), true)
+    end
+    for _, row in ipairs(rows) do
+        local cols = {
+            row.name,
+        }
+        for _, idx in ipairs(indices) do
+            local point = row.curve[idx]
+            cols[#cols + 1] = point and fmt.time(point.median) or "-"
+        end
+        curve:add_rows(cols)
+    end
+
+    self:print([[
+### Cold Start Analysis
+
+*First Call is the median time of the first invocation in the fresh processes. Warm After is the first invocation within 10% of the steady mean.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+    self:print([[
+
+*Warm-up curve: median time of the N-th invocation.*
+]])
+    self:print(concat(curve:render(), '\n'))
+end
+
+--- Format the size in KB
+--- @param kb number? The size in KB
+--- @return string
+local function format_kb(kb)
+    if not kb or kb ~= kb then
+        return "-"
+    end
+    return format("%.2f KB", kb)
+end
+
+--- Format the growth in KB as bytes, since the leak of an invocation is
+--- usually smaller than 1 KB
+--- @param kb number The growth in KB
+--- @return string
+local function format_growth(kb)
+    if kb ~= kb then
+        return "-"
+    end
+    return format("%.1f B", kb * 1024)
+end
+
+-- Print the growth of the heap after a full GC per invocation
+function Report:leak_analysis()
+    local results = self.analyses.leak
+    if not results then
+        return
+    end
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Probes", true)
+    tbl:add_column("Heap", true)
+    tbl:add_column("Growth/Op", true)
+    tbl:add_column("Growth CI", true)
+    tbl:add_column("p-value", true)
+    tbl:add_column("Verdict")
+    local level = 95
+    for _, samples in ipairs(self.samples_list) do
+        local res = results[samples:name()]
+        if res then
+            level = res.level
+            local verdict = "-"
+            if res.leaking then
+                verdict = "leaking"
+            elseif res.p_value == res.p_value then
+                verdict = "no leak"
+            end
+            tbl:add_rows({
+                samples:name(),
+                format("%d x %d", res.probes, res.interval),
+                format("%s -> %s", format_kb(res.first_kb),
+                       format_kb(res.last_kb)),
+                format_growth(res.slope_kb),
+                format("[%s, %s]", format_growth(res.lower),
+                       format_growth(res.upper)),
+                res.p_value == res.p_value and format("%.4f", res.p_value) or
+                    "-",
+                verdict,
+            })
+        end
+    end
+
+    self:print(format([[
+### Leak Detection
+
+*Heap is the Lua heap after a full GC at the first and last probe. Growth/Op is the slope of the heap on the number of invocations with its %g%% confidence interval; leaking means the slope is significantly positive.*
+]], level))
+    self:print(concat(tbl:render(), '\n'))
+end
+
+--- Format the difference of the number or the size with the sign
+--- @param v number The difference
+--- @param fn function? The function to format the value
+--- @return string
+local function format_delta(v, fn)
+    local s = fn and fn(v < 0 and -v or v) or tostring(v < 0 and -v or v)
+    if v > 0 then
+        return "+" .. s
+    elseif v < 0 then
+        return "-" .. s
+    end
+    return s
+end
+
+--- Format the size in bytes
+--- @param bytes number The size in bytes
+--- @return string
+local function format_bytes(bytes)
+    return fmt.memory(bytes / 1024)
+end
+
+-- Print the objects retained by the runs by type and by site
+function Report:census_analysis()
+    local results = self.analyses.census
+    if not results then
+        return
+    end
+
+    local types = new_table()
+    types:add_column("Name")
+    types:add_column("Type")
+    types:add_column("Before", true)
+    types:add_column("After", true)
+    types:add_column("Count", true)
+    types:add_column("Size", true)
+    local sites = new_table()
+    sites:add_column("Name")
+    sites:add_column("Type")
+    sites:add_column("Site")
+    sites:add_column("Count", true)
+    sites:add_column("Size", true)
+    sites:add_column("Per Run", true)
+    for _, samples in ipairs(self.samples_list) do
+        local res = results[samples:name()]
+        if res then
+            for _, v in ipairs(res.types) do
+                types:add_rows({
+                    samples:name(),
+                    v.type,
+                    tostring(v.before),
+                    tostring(v.after),
+                    format_delta(v.count),
+                    format_delta(v.size, format_bytes),
+                })
+            end
+            for _, v in ipairs(res.sites) do
+                sites:add_rows({
+                    samples:name(),
+                    v.type,
+                    v.site,
+                    format_delta(v.count),
+                    format_delta(v.size, format_bytes),
+                    format("%.2f", v.count / res.runs),
+                })
+            end
+        end
+    end
+
+    self:print([[
+### Heap Census
+
+*Objects reachable from the registry and the globals after a full GC, before the first and after the last run. Sizes are estimated from the object layout.*
+]])
+    self:print(concat(types:render(), '\n'))
+    self:print([[
+
+*Sites with the most growth: functions by their definition, the other objects by the upvalue, global or registry they are first reached from.*
+]])
+    self:print(concat(sites:render(), '\n'))
+end
+
+-- Print the source lines that allocate the most memory
+function Report:alloc_site_analysis()
+    local results = self.analyses.alloc_sites
+    if not results then
+        return
+    end
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Site")
+    tbl:add_column("Function")
+    tbl:add_column("Allocs/Op", true)
+    tbl:add_column("Bytes/Op", true)
+    tbl:add_column("Share", true)
+    for _, samples in ipairs(self.samples_list) do
+        local res = results[samples:name()]
+        if res then
+            for _, v in ipairs(res.sites) do
+                tbl:add_rows({
+                    samples:name(),
+                    format("%s:%d", v.source, v.line),
+                    v.linedefined == 0 and "main chunk" or
+                        format("%s:%d", v.source, v.linedefined),
+                    format("%.2f", v.count / res.runs),
+                    format_bytes(v.bytes / res.runs),
+                    format("%.1f%%", v.bytes / res.bytes * 100),
+                })
+            end
+        end
+    end
+
+    self:print([[
+### Allocation Sites
+
+*Memory allocated per run by the Lua source line that was running, in descending order. The allocations of C functions are attributed to the line that called them; Function is where the function of the line is defined.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+end
+
+-- Print the functions that take the most CPU time in the sampled stacks
+function Report:cpu_profile_analysis()
+    local results = self.analyses.cpu_profile
+    if not results then
+        return
+    end
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Function")
+    tbl:add_column("Self", true)
+    tbl:add_column("Total", true)
+    local files = {}
+    for _, samples in ipairs(self.samples_list) do
+        local res = results[samples:name()]
+        if res then
+            for _, v in ipairs(res.frames) do
+                tbl:add_rows({
+                    samples:name(),
+                    v.frame,
+                    format("%.1f%%", v.self / res.samples * 100),
+                    format("%.1f%%", v.total / res.samples * 100),
+                })
+            end
+            local dropped = ""
+            if res.dropped > 0 then
+                dropped = format(", %d dropped", res.dropped)
+            end
+            files[#files + 1] = format("- %s: %s (%d samples of %d runs, %d us interval%s)",
+                                       samples:name(), res.pathname,
+                                       res.samples, res.runs, res.interval,
+                                       dropped)
+        end
+    end
+
+    self:print([[
+### CPU Profile
+
+*Share of the CPU time samples in which the function is running (Self) or on the call stack (Total), in descending order of Self. The time of C functions is attributed to the next Lua instruction, and the full stacks are written in the folded format for the flame graph tools.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+    self:print('')
+    self:print(concat(files, '\n'))
+end
+
+-- Print the VM instructions executed by opcode class and by function
+function Report:opcode_analysis()
+    local results = self.analyses.opcodes
+    if not results then
+        return
+    end
+
+    local classes = new_table()
+    classes:add_column("Name")
+    classes:add_column("Class")
+    classes:add_column("Instr/Op", true)
+    classes:add_column("Share", true)
+    local functions = new_table()
+    functions:add_column("Name")
+    functions:add_column("Function")
+    functions:add_column("Instr/Op", true)
+    functions:add_column("Share", true)
+    functions:add_column("Top Class")
+    for _, samples in ipairs(self.samples_list) do
+        local res = results[samples:name()]
+        if res and res.count > 0 then
+            for _, v in ipairs(res.classes) do
+                classes:add_rows({
+                    samples:name(),
+                    v.class,
+                    format("%.1f", v.count / res.runs),
+                    format("%.1f%%", v.count / res.count * 100),
+                })
+            end
+            for _, v in ipairs(res.functions) do
+                functions:add_rows({
+                    samples:name(),
+                    v.linedefined == 0 and format("%s (main chunk)", v.source) or
+                        format("%s:%d", v.source, v.linedefined),
+                    format("%.1f", v.count / res.runs),
+                    format("%.1f%%", v.count / res.count * 100),
+                    format("%s (%.0f%%)", v.class,
+                           v.class_count / v.count * 100),
+                })
+            end
+        end
+    end
+
+    self:print([[
+### VM Instructions
+
+*Lua VM instructions executed per run by opcode class, in descending order. The instructions of a source line are divided among the classes of its opcodes in proportion to their number in the bytecode, so the classes of a line that mixes them are estimates.*
+]])
+    self:print(concat(classes:render(), '\n'))
+    self:print('')
+    self:print([[
+*Instructions executed per run by the function and its share of the total.*
+]])
+    self:print(concat(functions:render(), '\n'))
+end
+
+--- Format the share of the samples of the VM state
+--- @param states table<string, integer>? Number of the samples by VM state
+--- @param name string The VM state
+--- @return string
+local function format_vmstate(states, name)
+    local total = 0
+    for _, n in pairs(states or {}) do
+        total = total + n
+    end
+    if total == 0 then
+        return "N/A"
+    end
+    return format("%.1f%%", (states[name] or 0) / total * 100)
+end
+
+-- Print the trace events of LuaJIT during the warmup and the sampling
+function Report:jit_trace_analysis()
+    local results = self.analyses.jit_trace
+    if not results then
+        return
+    end
+
+    local phases = new_table()
+    phases:add_column("Name")
+    phases:add_column("Phase")
+    phases:add_column("Started", true)
+    phases:add_column("Completed", true)
+    phases:add_column("Aborted", true)
+    phases:add_column("Flushed", true)
+    phases:add_column("Compiled", true)
+    phases:add_column("Interpreted", true)
+    phases:add_column("Stable")
+    local aborts = new_table()
+    aborts:add_column("Name")
+    aborts:add_column("Phase")
+    aborts:add_column("Reason")
+    aborts:add_column("Location")
+    aborts:add_column("Count", true)
+    local naborts = 0
+    for _, samples in ipairs(self.samples_list) do
+        local res = results[samples:name()]
+        if res then
+            for _, phase in ipairs({
+                "warmup",
+                "sampling",
+            }) do
+                local p = res.phases[phase] or {
+                    started = 0,
+                    completed = 0,
+                    aborted = 0,
+                    flushed = 0,
+                }
+                local stable = ""
+                if phase == "sampling" then
+                    -- no trace activity and no interpreted samples
+                    local states = p.vmstates or {}
+                    local quiet = p.started == 0 and p.aborted == 0 and
+                                      p.flushed == 0
+                    stable = (quiet and (states.interpreted or 0) == 0) and
+                                 "yes" or "no"
+                end
+                phases:add_rows({
+                    samples:name(),
+                    phase,
+                    tostring(p.started),
+                    tostring(p.completed),
+                    tostring(p.aborted),
+                    tostring(p.flushed),
+                    format_vmstate(p.vmstates, "compiled"),
+                    format_vmstate(p.vmstates, "interpreted"),
+                    stable,
+                })
+            end
+            for i, v in ipairs(res.aborts) do
+                if i > 10 then
+                    break
+                end
+                naborts = naborts + 1
+                aborts:add_rows({
+                    samples:name(),
+                    v.phase,
+                    v.reason,
+                    v.location,
+                    tostring(v.count),
+                })
+            end
+        end
+    end
+
+    self:print([[
+### JIT Traces
+
+*Trace events of the LuaJIT compiler in the warmup (including setup()) and the sampling, and the share of the VM states sampled every millisecond. Stable is yes when no trace was started, aborted or flushed and no sample was interpreted during the sampling, i.e. the sampling ran in the compiled code only.*
+]])
+    self:print(concat(phases:render(), '\n'))
+    if naborts > 0 then
+        self:print('')
+        self:print([[
+*The most frequent trace aborts by reason and location.*
+]])
+        self:print(concat(aborts:render(), '\n'))
+    end
+end
+
+-- Print the cost of require() of the modules
+function Report:require_analysis()
+    local results = self.analyses.require
+    if not results then
+        return
+    end
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Module")
+    tbl:add_column("Load Time", true)
+    tbl:add_column("p95", true)
+    tbl:add_column("Heap Alloc", true)
+    tbl:add_column("Heap Retained", true)
+    tbl:add_column("RSS Growth", true)
+    tbl:add_column("Modules", true)
+
+    local deps = {}
+    for _, summary in ipairs(self:get_summaries()) do
+        local res = results[summary.name]
+        if res then
+            tbl:add_rows({
+                summary.name,
+                res.module,
+                fmt.time(summary.mean),
+                fmt.time(summary.p95),
+                format_kb(res.allocated_kb),
+                format_kb(res.retained_kb),
+                format_kb(res.rss_kb),
+                tostring(#res.modules),
+            })
+            if #res.modules > 0 then
+                deps[#deps + 1] = format("- %s: %s", res.module,
+                                         concat(res.modules, ', '))
+            end
+        end
+    end
+
+    self:print([[
+### Module Load Analysis
+
+*Cost of require() in a new Lua state of a fresh process. Modules is the number of other modules loaded transitively.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+    if #deps > 0 then
+        self:print('')
+        self:print(concat(deps, '\n'))
+    end
+end
+
+-- Print the paired comparison of the two versions of the modules
+function Report:ab_analysis()
+    local results = self.analyses.ab
+    if not results then
+        return
+    end
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("A")
+    tbl:add_column("B")
+    tbl:add_column("Rounds", true)
+    tbl:add_column("Mean A", true)
+    tbl:add_column("Mean B", true)
+    tbl:add_column("B/A", true)
+    tbl:add_column("CI")
+    tbl:add_column("p-value", true)
+    tbl:add_column("B Faster", true)
+    tbl:add_column("Verdict")
+
+    for _, samples in ipairs(self.samples_list) do
+        local name = match(samples:name(), '^(.*) %[A%]$')
+        local res = name and results[name]
+        if res then
+            local verdict = "no difference"
+            if not (res.p_value == res.p_value) then
+                verdict = "-"
+            elseif res.p_value < 1 - res.level / 100 then
+                verdict = res.ratio < 1 and "B is faster" or "B is slower"
+            end
+            tbl:add_rows({
+                name,
+                res.a,
+                res.b,
+                tostring(res.rounds),
+                fmt.time(res.mean_a),
+                fmt.time(res.mean_b),
+                format("%.3fx", res.ratio),
+                format("%d%% [%.3fx - %.3fx]", res.level, res.lower,
+                       res.upper),
+                format("%.4f", res.p_value),
+                format("%d/%d", res.wins, res.rounds),
+                verdict,
+            })
+        end
+    end
+
+    self:print([[
+### A/B Comparison
+
+*The variants run in alternating rounds in fresh processes. B/A is the geometric mean of the ratios of the round means, tested with the paired t-test.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+end
+
+--- Map the names of the samples to their summaries and samples, to look up
+--- the variants `<name> [<variant>]` of the describes
+--- @return table<string, table> by_name The summary and the samples by name
+function Report:get_variants()
+    local by_name = {}
+    for i, summary in ipairs(self:get_summaries()) do
+        by_name[summary.name] = {
+            summary = summary,
+            samples = self.samples_list[i],
+        }
+    end
+    return by_name
+end
+
+--- List the describes that have been run as the variants in the order of
+--- the samples
+--- @param samples_list measure.samples[] The samples
+--- @param results table The analysis results keyed by describe name
+--- @return string[] names The names of the describes
+local function variant_describes(samples_list, results)
+    local names = {}
+    for _, samples in ipairs(samples_list) do
+        local name = match(samples:name(), '^(.*) %[%a+%]$')
+        if name and results[name] and not names[name] then
+            names[name] = true
+            names[#names + 1] = name
+        end
+    end
+    return names
+end
+
+--- Compare the time of the variant with the baseline variant
+--- @param base table The summary and the samples of the baseline
+--- @param row table The summary and the samples of the variant
+--- @return string relative The relative time
+--- @return string p_value The p-value of Welch's t-test
+local function compare_variant(base, row)
+    return calc_relative_value(base.summary.mean, row.summary.mean, {
+        greater = "slower",
+        less = "faster",
+        equal = "-",
+    }), format("%.4f", welcht({
+        base.samples,
+        row.samples,
+    })[1].p_value)
+end
+
+-- Print the time and the allocation of each describe under the allocators
+function Report:allocator_analysis()
+    local results = self.analyses.allocators
+    if not results then
+        return
+    end
+
+    local by_name = self:get_variants()
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Allocator")
+    tbl:add_column("Mean", true)
+    tbl:add_column("p95", true)
+    tbl:add_column("Max Alloc/Op", true)
+    tbl:add_column("Alloc/Op", true)
+    tbl:add_column("Relative")
+    tbl:add_column("p-value", true)
+
+    local names = variant_describes(self.samples_list, results)
+
+    for _, name in ipairs(names) do
+        local base
+        for _, kind in ipairs(results[name]) do
+            local row = by_name[format("%s [%s]", name, kind)]
+            if row then
+                local summary = row.summary
+                local relative, p_value = "baseline", "-"
+                if base then
+                    relative, p_value = compare_variant(base, row)
+                else
+                    base = row
+                end
+                tbl:add_rows({
+                    name,
+                    kind,
+                    fmt.time(summary.mean),
+                    fmt.time(summary.p95),
+                    fmt.memory(summary.memstat.max_alloc_op) .. "/op",
+                    fmt.memory(summary.memstat.alloc_op) .. "/op",
+                    relative,
+                    p_value,
+                })
+            end
+        end
+    end
+
+    self:print([[
+### Allocator Sensitivity
+
+*Each allocator runs in a fresh process and is compared with the first one by Welch's t-test. The difference of the time is the cost of the allocator.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+end
+
+-- Print the time of the describes with the warm and the cold caches
+function Report:cold_cache_analysis()
+    local results = self.analyses.cold_cache
+    if not results then
+        return
+    end
+
+    local by_name = self:get_variants()
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Cache")
+    tbl:add_column("Mean", true)
+    tbl:add_column("p95", true)
+    tbl:add_column("Buffer", true)
+    tbl:add_column("Relative")
+    tbl:add_column("p-value", true)
+
+    local names = variant_describes(self.samples_list, results)
+
+    for _, name in ipairs(names) do
+        local res = results[name]
+        local hot = by_name[format("%s [hot]", name)]
+        local cold = by_name[format("%s [cold]", name)]
+        if hot and cold then
+            local relative, p_value = compare_variant(hot, cold)
+            tbl:add_rows({
+                name,
+                "hot",
+                fmt.time(hot.summary.mean),
+                fmt.time(hot.summary.p95),
+                "-",
+                "baseline",
+                "-",
+            })
+            tbl:add_rows({
+                name,
+                "cold",
+                fmt.time(cold.summary.mean),
+                fmt.time(cold.summary.p95),
+                fmt.memory(res.evict_kb),
+                relative,
+                p_value,
+            })
+        end
+    end
+
+    self:print([[
+### Cache Sensitivity
+
+*The cold samples start after a buffer larger than the last-level cache is read outside the timed region, so the code and the data of the describe are evicted from the CPU caches. The difference from the hot samples, which run back to back, is the cost of the cache misses.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+end
+
+-- Print the time of the describes with the fixture files warm and evicted
+-- from the page cache
+function Report:page_cache_analysis()
+    local results = self.analyses.page_cache
+    if not results then
+        return
+    end
+
+    local by_name = self:get_variants()
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Files")
+    tbl:add_column("Mean", true)
+    tbl:add_column("p95", true)
+    tbl:add_column("Size", true)
+    tbl:add_column("Evicted", true)
+    tbl:add_column("Relative")
+    tbl:add_column("p-value", true)
+
+    local names = variant_describes(self.samples_list, results)
+
+    for _, name in ipairs(names) do
+        local res = results[name]
+        local warm = by_name[format("%s [warm]", name)]
+        local cold = by_name[format("%s [cold]", name)]
+        if warm and cold then
+            local relative, p_value = compare_variant(warm, cold)
+            tbl:add_rows({
+                name,
+                "warm",
+                fmt.time(warm.summary.mean),
+                fmt.time(warm.summary.p95),
+                fmt.memory(res.size / 1024),
+                "-",
+                "baseline",
+                "-",
+            })
+            tbl:add_rows({
+                name,
+                "cold",
+                fmt.time(cold.summary.mean),
+                fmt.time(cold.summary.p95),
+                fmt.memory(res.size / 1024),
+                format("%.1f%%", res.evicted * 100),
+                relative,
+                p_value,
+            })
+        end
+    end
+
+    self:print([[
+### Page Cache
+
+*The fixture files are read into the page cache before each warm sample and evicted with `posix_fadvise(POSIX_FADV_DONTNEED)` before each cold sample, outside the timed region. The difference is the cost of reading the files from the storage. Evicted is the share of the pages that left the page cache when checked before the sampling; pages mapped by other processes stay resident.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+end
+
+-- Print the time of the describes bound to the local and the remote NUMA
+-- nodes
+function Report:numa_analysis()
+    local results = self.analyses.numa
+    if not results then
+        return
+    end
+
+    local by_name = self:get_variants()
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Placement")
+    tbl:add_column("CPU Node", true)
+    tbl:add_column("Memory Node", true)
+    tbl:add_column("CPUs", true)
+    tbl:add_column("Mean", true)
+    tbl:add_column("p95", true)
+    tbl:add_column("Relative")
+    tbl:add_column("p-value", true)
+
+    local names = variant_describes(self.samples_list, results)
+
+    local nnode
+    for _, name in ipairs(names) do
+        local res = results[name]
+        nnode = res.nodes
+        local base = by_name[format("%s [local]", name)]
+        for _, placement in ipairs(res.placements) do
+            local v = by_name[format("%s [%s]", name, placement.kind)]
+            if v and base then
+                local relative, p_value = "baseline", "-"
+                if v ~= base then
+                    relative, p_value = compare_variant(base, v)
+                end
+                tbl:add_rows({
+                    name,
+                    placement.kind,
+                    tostring(placement.cpu_node),
+                    tostring(placement.mem_node),
+                    tostring(placement.ncpu),
+                    fmt.time(v.summary.mean),
+                    fmt.time(v.summary.p95),
+                    relative,
+                    p_value,
+                })
+            end
+        end
+    end
+
+    self:print(format([[
+### NUMA Placement
+
+*Each placement runs in a fresh process bound to the CPUs of the CPU node by `sched_setaffinity()`, with its new memory allocated only from the memory node by `set_mempolicy(MPOL_BIND)`. The process is bound before `setup()`, so only the memory allocated after that follows the policy; the data loaded by `before_all()` stays where the parent process allocated it. The difference of the remote placement from the local one is the cost of accessing the memory of the other node. The host has %d NUMA node(s).*
+]], nnode or 0))
+    self:print(concat(tbl:render(), '\n'))
+end
+
+-- Print the time, the allocation and the share of the GC of each GC mode
+function Report:gc_mode_analysis()
+    local results = self.analyses.gc_modes
+    if not results then
+        return
+    end
+
+    local by_name = self:get_variants()
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Mode")
+    tbl:add_column("Parameters")
+    tbl:add_column("Mean", true)
+    tbl:add_column("p95", true)
+    tbl:add_column("Alloc/Op", true)
+    tbl:add_column("GC Share", true)
+    tbl:add_column("Relative")
+    tbl:add_column("p-value", true)
+
+    local names = variant_describes(self.samples_list, results)
+
+    for _, name in ipairs(names) do
+        local res = results[name]
+        local base
+        for _, v in ipairs(res.modes) do
+            local row = by_name[format("%s [%s]", name, v.mode)]
+            if row then
+                local summary = row.summary
+                local relative, p_value = "baseline", "-"
+                if base then
+                    relative, p_value = compare_variant(base, row)
+                else
+                    base = row
+                end
+                local share = (summary.mean - res.stopped_mean) / summary.mean
+                tbl:add_rows({
+                    name,
+                    v.mode,
+                    v.params,
+                    fmt.time(summary.mean),
+                    fmt.time(summary.p95),
+                    fmt.memory(res.alloc_op or summary.memstat.alloc_op) ..
+                        "/op",
+                    format("%.1f%%", (share > 0 and share or 0) * 100),
+                    relative,
+                    p_value,
+                })
+            end
+        end
+    end
+
+    self:print([[
+### GC Mode Comparison
+
+*Each GC mode runs in a fresh process without the full GC before each sample, so the samples include the collection work of the mode, and is compared with the first one by Welch's t-test. GC Share is the extra time over the same describe run with the GC stopped, and Alloc/Op is measured in that run, because the collections during the samples hide the allocation.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+end
+
+-- Print the best GC parameters and the trade-off curve of the time and the
+-- peak memory
+function Report:gc_tune_analysis()
+    local results = self.analyses.gc_tune
+    if not results then
+        return
+    end
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Objective")
+    tbl:add_column("Memory Limit", true)
+    tbl:add_column("Best Parameters")
+    tbl:add_column("Best", true)
+    tbl:add_column("Default", true)
+    tbl:add_column("Relative")
+
+    local curve = new_table()
+    curve:add_column("Name")
+    curve:add_column("Parameters")
+    curve:add_column("Mean", true)
+    curve:add_column("p99", true)
+    curve:add_column("Peak Memory", true)
+    curve:add_column("Note")
+
+    -- list the describes in the order of the samples
+    local names = {}
+    for _, samples in ipairs(self.samples_list) do
+        local name = match(samples:name(), '^(.*) %[default%]$')
+        if name and results[name] then
+            names[#names + 1] = name
+        end
+    end
+
+    for _, name in ipairs(names) do
+        local res = results[name]
+        local points = res.points
+        local default = points[1]
+        local best = res.best and points[res.best]
+        tbl:add_rows({
+            name,
+            res.objective,
+            res.max_memory and format_kb(res.max_memory) or "-",
+            best and best.label or "none under the limit",
+            best and fmt.time(best[res.objective]) or "-",
+            fmt.time(default[res.objective]),
+            best and calc_relative_value(default[res.objective],
+                                         best[res.objective], {
+                greater = "slower",
+                less = "faster",
+                equal = "-",
+            }) or "-",
+        })
+
+        -- the points on the curve, the default and the best
+        local rows = {}
+        for _, i in ipairs(res.curve) do
+            rows[i] = true
+        end
+        rows[1] = true
+        if res.best then
+            rows[res.best] = true
+        end
+        local indices = {}
+        for i in pairs(rows) do
+            indices[#indices + 1] = i
+        end
+        sort(indices, function(a, b)
+            if points[a].peak_kb ~= points[b].peak_kb then
+                return points[a].peak_kb < points[b].peak_kb
+            end
+            return a < b
+        end)
+        for _, i in ipairs(indices) do
+            local p = points[i]
+            local notes = {}
+            if i == res.best then
+                notes[#notes + 1] = "best"
+            end
+            if i == 1 then
+                notes[#notes + 1] = "default"
+            end
+            if res.max_memory and p.peak_kb > res.max_memory then
+                notes[#notes + 1] = "over limit"
+            end
+            curve:add_rows({
+                name,
+                p.label,
+                fmt.time(p.mean),
+                fmt.time(p.p99),
+                format_kb(p.peak_kb),
+                concat(notes, ", "),
+            })
+        end
+    end
+
+    self:print([[
+### GC Tuning
+
+*Each GC parameter set runs in a fresh process with the GC running by itself. Best minimizes the objective under the peak memory limit.*
+]])
+    self:print(concat(tbl:render(), '\n'))
+    self:print([[
+
+*Trade-off curve: the parameters that no other parameters beat on both the objective and the peak memory.*
+]])
+    self:print(concat(curve:render(), '\n'))
+end
+
 --- Render the full report
 function Report:render()
     -- Sampling details
@@ -480,13 +1580,110 @@ function Report:render()
     self:performance_analysis()
     self:print('')
 
+    -- Fork analysis (if applicable)
+    if self.analyses.forks then
+        self:fork_analysis()
+        self:print('')
+    end
+
+    -- Module load analysis (if applicable)
+    if self.analyses.require then
+        self:require_analysis()
+        self:print('')
+    end
+
+    -- GC tuning (if applicable)
+    if self.analyses.gc_tune then
+        self:gc_tune_analysis()
+        self:print('')
+    end
+
+    -- GC mode comparison (if applicable)
+    if self.analyses.gc_modes then
+        self:gc_mode_analysis()
+        self:print('')
+    end
+
+    -- Allocator sensitivity (if applicable)
+    if self.analyses.allocators then
+        self:allocator_analysis()
+        self:print('')
+    end
+
+    -- Cache sensitivity (if applicable)
+    if self.analyses.cold_cache then
+        self:cold_cache_analysis()
+        self:print('')
+    end
+
+    -- Page cache (if applicable)
+    if self.analyses.page_cache then
+        self:page_cache_analysis()
+        self:print('')
+    end
+
+    -- NUMA placement (if applicable)
+    if self.analyses.numa then
+        self:numa_analysis()
+        self:print('')
+    end
+
+    -- A/B comparison (if applicable)
+    if self.analyses.ab then
+        self:ab_analysis()
+        self:print('')
+    end
+
+    -- Cold start analysis (if applicable)
+    if self.analyses.cold_start then
+        self:cold_start_analysis()
+        self:print('')
+    end
+
+    -- Leak detection (if applicable)
+    if self.analyses.leak then
+        self:leak_analysis()
+        self:print('')
+    end
+
+    -- Heap census (if applicable)
+    if self.analyses.census then
+        self:census_analysis()
+        self:print('')
+    end
+
+    -- Allocation sites (if applicable)
+    if self.analyses.alloc_sites then
+        self:alloc_site_analysis()
+        self:print('')
+    end
+
+    -- JIT traces (if applicable)
+    if self.analyses.jit_trace then
+        self:jit_trace_analysis()
+        self:print('')
+    end
+
+    -- CPU profile (if applicable)
+    if self.analyses.cpu_profile then
+        self:cpu_profile_analysis()
+        self:print('')
+    end
+
+    -- VM instructions (if applicable)
+    if self.analyses.opcodes then
+        self:opcode_analysis()
+        self:print('')
+    end
+
     -- Clustering analysis (if applicable)
     self:cluster_analysis()
 end
 
 --- Create a new Report instance
 --- @param samples_list measure.samples[] List of samples to include in the report
-local function new(samples_list)
+--- @param analyses table? Additional analyses keyed by kind (e.g. forks, cold_start, require, ab, allocators, gc_modes, gc_tune, leak, census, alloc_sites, cpu_profile, opcodes, jit_trace, cold_cache, page_cache, numa)
+local function new(samples_list, analyses)
     -- Validate input
     if not samples_list or type(samples_list) ~= "table" or #samples_list < 1 then
         error("Error: At least one sample required for comparison", 2)
@@ -495,6 +1692,7 @@ local function new(samples_list)
     return setmetatable({
         samples_list = samples_list,
         sysinfo = report_sysinfo(),
+        analyses = analyses or {},
     }, Report)
 end
 
@@ -0,0 +1,83 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+--- Table of the revisions tested by the bisect command
+---
+--- Example usage:
+---   local render_bisect = require('measure.report.bisect')
+---   print(render_bisect({
+---       { revision = 'a1b2c3d', subject = 'Fix parser', samples = ... },
+---       { revision = 'e4f5a6b', subject = 'Add cache', samples = ...,
+---         ratio = 1.25, p_value = 0.001, bad = true },
+---   }))
+---
+local ipairs = ipairs
+local format = string.format
+local sub = string.sub
+local concat = table.concat
+local new_table = require('measure.report.table')
+local fmt = require('measure.report.format')
+
+--- Maximum length of the subject of the commit
+local MAX_SUBJECT_LEN = 50
+
+--- Render the table of the tested revisions
+--- The first step is the good revision that the others are compared with.
+--- @param steps table[] The tested revisions in the order of the commits.
+---                      Each entry has the revision, subject and samples
+---                      fields, and the ratio, p_value and bad fields of
+---                      the judgement except for the good revision.
+--- @return string table The rendered table
+local function render_bisect(steps)
+    local tbl = new_table()
+    tbl:add_column("Revision")
+    tbl:add_column("Subject")
+    tbl:add_column("Mean", true)
+    tbl:add_column("StdDev", true)
+    tbl:add_column("Ratio", true)
+    tbl:add_column("p-value", true)
+    tbl:add_column("Verdict")
+
+    for i, step in ipairs(steps) do
+        local subject = step.subject or ""
+        if #subject > MAX_SUBJECT_LEN then
+            subject = sub(subject, 1, MAX_SUBJECT_LEN - 3) .. "..."
+        end
+        local ratio, p_value, verdict = "baseline", "-", "good"
+        if i > 1 then
+            ratio = format("%.3fx", step.ratio)
+            p_value = format("%.4f", step.p_value)
+            verdict = step.bad and "bad" or "good"
+        end
+        tbl:add_rows({
+            step.revision,
+            subject,
+            fmt.time(step.samples:mean()),
+            fmt.time(step.samples:stddev()),
+            ratio,
+            p_value,
+            verdict,
+        })
+    end
+    return concat(tbl:render(), '\n')
+end
+
+return render_bisect
@@ -0,0 +1,98 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+--- Diff table of the benchmark results between two runs
+--- Used by the watch mode to show how a change affected each benchmark
+---
+--- Example usage:
+---   local render_diff = require('measure.report.diff')
+---   print(render_diff(previous_results, current_results))
+---
+local ipairs = ipairs
+local format = string.format
+local concat = table.concat
+local welcht = require('measure.posthoc.welcht')
+local new_table = require('measure.report.table')
+local fmt = require('measure.report.format')
+
+--- Format the relative change of the mean
+--- @param prev number The previous mean
+--- @param curr number The current mean
+--- @return string change The relative change in percent
+local function format_change(prev, curr)
+    if prev <= 0 then
+        return "N/A"
+    end
+    return format("%+.2f%%", (curr - prev) / prev * 100)
+end
+
+--- Render the diff table of the results
+--- The results of the current run are compared with the results of the
+--- previous run that have the same name.
+--- @param prev_list measure.samples[] The results of the previous run
+--- @param curr_list measure.samples[] The results of the current run
+--- @return string? diff The rendered table, or nil if nothing to compare
+local function render_diff(prev_list, curr_list)
+    local prev_map = {}
+    for _, samples in ipairs(prev_list) do
+        prev_map[samples:name()] = samples
+    end
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Previous", true)
+    tbl:add_column("Current", true)
+    tbl:add_column("Change", true)
+    tbl:add_column("p-value", true)
+    tbl:add_column("Significance")
+
+    local nrow = 0
+    for _, curr in ipairs(curr_list) do
+        local prev = prev_map[curr:name()]
+        if prev then
+            local res = welcht({
+                prev,
+                curr,
+            })[1]
+            local significant = "[ ]"
+            if res.p_value < 0.05 then
+                significant = curr:mean() < prev:mean() and "[x] faster" or
+                                  "[x] slower"
+            end
+            tbl:add_rows({
+                curr:name(),
+                fmt.time(prev:mean()),
+                fmt.time(curr:mean()),
+                format_change(prev:mean(), curr:mean()),
+                format("%.3f", res.p_value),
+                significant,
+            })
+            nrow = nrow + 1
+        end
+    end
+
+    if nrow == 0 then
+        return nil
+    end
+    return concat(tbl:render(), '\n')
+end
+
+return render_diff
@@ -0,0 +1,123 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+--- Comparison table of the benchmark results across the Lua runtimes
+--- Used by the --lua option to compare the same benchmarks run under
+--- several interpreters
+---
+--- Example usage:
+---   local render_matrix = require('measure.report.matrix')
+---   print(render_matrix({
+---       { runtime = 'lua5.1', version = 'Lua 5.1', results = {...} },
+---       { runtime = 'luajit', version = 'LuaJIT 2.1', results = {...} },
+---   }))
+---
+local ipairs = ipairs
+local format = string.format
+local concat = table.concat
+local welcht = require('measure.posthoc.welcht')
+local new_table = require('measure.report.table')
+local fmt = require('measure.report.format')
+
+--- Format the speed ratio to the baseline
+--- @param base number The mean of the baseline runtime
+--- @param mean number The mean of the runtime
+--- @return string relative
+local function format_relative(base, mean)
+    if base <= 0 or mean <= 0 then
+        return "N/A"
+    elseif mean < base then
+        return format("%.2fx faster", base / mean)
+    elseif mean > base then
+        return format("%.2fx slower", mean / base)
+    end
+    return "-"
+end
+
+--- Render the comparison table of the runtimes
+--- The results of each describe are compared with the results of the same
+--- describe under the first runtime that ran it.
+--- @param columns table[] The results of each runtime in the order of the
+---                        --lua option. Each entry has the runtime, version
+---                        and results (measure.samples[]) fields.
+--- @return string? matrix The rendered table, or nil if nothing to compare
+local function render_matrix(columns)
+    -- list the describe names in the order of appearance
+    local names = {}
+    local by_name = {}
+    for _, col in ipairs(columns) do
+        for _, samples in ipairs(col.results) do
+            local name = samples:name()
+            if not by_name[name] then
+                names[#names + 1] = name
+                by_name[name] = {}
+            end
+            by_name[name][#by_name[name] + 1] = {
+                col = col,
+                samples = samples,
+            }
+        end
+    end
+    if #names == 0 then
+        return nil
+    end
+
+    local tbl = new_table()
+    tbl:add_column("Name")
+    tbl:add_column("Runtime")
+    tbl:add_column("Version")
+    tbl:add_column("Mean", true)
+    tbl:add_column("StdDev", true)
+    tbl:add_column("Relative")
+    tbl:add_column("p-value", true)
+    tbl:add_column("Significance")
+
+    for _, name in ipairs(names) do
+        local rows = by_name[name]
+        local base = rows[1].samples
+        for i, row in ipairs(rows) do
+            local samples = row.samples
+            local relative, p_value, significant = "baseline", "-", ""
+            if i > 1 then
+                relative = format_relative(base:mean(), samples:mean())
+                local res = welcht({
+                    base,
+                    samples,
+                })[1]
+                p_value = format("%.3f", res.p_value)
+                significant = res.p_value < 0.05 and "[x]" or "[ ]"
+            end
+            tbl:add_rows({
+                name,
+                row.col.runtime,
+                row.col.version,
+                fmt.time(samples:mean()),
+                fmt.time(samples:stddev()),
+                relative,
+                p_value,
+                significant,
+            })
+        end
+    end
+    return concat(tbl:render(), '\n')
+end
+
+return render_matrix
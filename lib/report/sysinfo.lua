@@ -23,8 +23,63 @@
 -- Provides high-quality output formatting similar to Criterion.rs and BenchmarkDotNet
 local format = string.format
 local concat = table.concat
+local find = string.find
 local sysinfo = require('measure.sysinfo')
 
+--- 1-minute load average per online CPU above which the host is considered
+--- busy enough to disturb the measurements
+local HIGH_LOAD_PER_CPU = 0.5
+
+--- Format the CPU tuning state
+--- @param tuning table The tuning information of sysinfo
+--- @return string? tuning The formatted tuning state
+local function format_tuning(tuning)
+    local parts = {}
+    if tuning.governor then
+        parts[#parts + 1] = format('governor=%s', tuning.governor)
+    end
+    if tuning.boost ~= nil then
+        parts[#parts + 1] = format('boost=%s', tuning.boost and 'on' or 'off')
+    end
+    if tuning.smt then
+        parts[#parts + 1] = format('smt=%s', tuning.smt)
+    end
+    if tuning.isolated and tuning.isolated ~= '' then
+        parts[#parts + 1] = format('isolated=%s', tuning.isolated)
+    end
+    if tuning.loadavg then
+        parts[#parts + 1] = format('load=%s', concat({
+            format('%.2f', tuning.loadavg[1] or 0),
+            format('%.2f', tuning.loadavg[2] or 0),
+            format('%.2f', tuning.loadavg[3] or 0),
+        }, '/'))
+    end
+    if #parts > 0 then
+        return concat(parts, ', ')
+    end
+end
+
+--- Check the environment that is unsuitable for benchmarking
+--- @param tuning table The tuning information of sysinfo
+--- @return string? warning The warnings joined with semicolon
+local function check_tuning(tuning)
+    local warnings = {}
+    if tuning.governor and find(tuning.governor, 'powersave', 1, true) then
+        warnings[#warnings + 1] =
+            'CPU governor is powersave, use performance governor'
+    end
+    local load = tuning.loadavg and tuning.loadavg[1]
+    local online = tuning.online or 1
+    if load and load > online * HIGH_LOAD_PER_CPU then
+        warnings[#warnings + 1] = format(
+                                      'high load average %.2f on %d CPUs, results may be noisy',
+                                      load, online)
+    end
+    if #warnings > 0 then
+        return concat(warnings, '; ')
+    end
+end
+
 -- Format system information for display (compact format)
 local function report_sysinfo()
     local info = sysinfo()
@@ -84,6 +139,12 @@ local function report_sysinfo()
         result.Runtime = concat(runtime_parts, ', ')
     end
 
+    -- Tuning and Warning lines: CPU frequency scaling, SMT and load
+    if info.tuning then
+        result.Tuning = format_tuning(info.tuning)
+        result.Warning = check_tuning(info.tuning)
+    end
+
     -- Date line
     if info.timestamp then
         result.Date = info.timestamp
@@ -0,0 +1,470 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+--
+-- Module: measure.runner
+-- This module loads the benchmark files and runs the setup(), run() and
+-- teardown() of a describe to collect the samples in this process or in the
+-- child processes
+--
+local pcall = pcall
+local pairs = pairs
+local ipairs = ipairs
+local type = type
+local print = print
+local find = string.find
+local format = string.format
+local match = string.match
+local unpack = table.unpack or unpack
+local debug_getinfo = debug.getinfo
+local chdir = require('chdir')
+local getcwd = require('measure.getcwd')
+local loadfile = require('measure.loadfile')
+local new_samples = require('measure.samples').new
+local sampler = require('measure.sampler')
+local stats_ci = require('measure.stats.ci')
+local forkrun = require('measure.forkrun')
+local serialize = require('measure.serialize')
+-- current working directory
+local PWD = assert(getcwd())
+-- short_src of this module
+local SOURCE = debug_getinfo(1, 'S').short_src
+-- gc_step that never triggers the step GC, so the GC runs only by itself
+local GC_STEP_AUTO = 0x7fffffff
+-- modules loaded by the command, which are kept when the benchmark file is
+-- reloaded with the module search paths of a variant
+local BASE_MODULES = {}
+for k in pairs(package.loaded) do
+    BASE_MODULES[k] = true
+end
+
+--- Print formatted output
+--- @param ... any Arguments to format
+local function printf(...)
+    print(format(...))
+end
+
+--- Change directory, execute function, and return to original directory
+--- @param dir string Working directory to change
+--- @param fn function Function to execute
+--- @param ... any Arguments to pass to the function
+--- @return ... Results of the function execution
+local function pcall_in_dir(dir, fn, ...)
+    assert(chdir(dir))
+    local res = {
+        pcall(fn, ...),
+    }
+    assert(chdir(PWD))
+    if not res[1] then
+        error(res[2])
+    end
+    return unpack(res, 2, 10)
+end
+
+--- Get the directory name from a given pathname
+--- @param pathname string The full pathname
+--- @return string dirname The directory part of the pathname
+--- @return string filename The filename part of the pathname
+local function dirname(pathname)
+    local dir, file = match(pathname, '^(.-)([^/]+)$')
+    return dir ~= '' and dir or '.', file
+end
+
+--- Load the benchmark file
+--- @param pathname string The pathname of the benchmark file
+--- @return table? file The loaded benchmark file
+--- @return any err Error message if failed
+local function load_file(pathname)
+    local dir, filename = dirname(pathname)
+    local file, err = pcall_in_dir(dir, loadfile, filename)
+    if not file then
+        return nil, err
+    end
+    file.pathname = pathname
+    file.dirname = dir
+    return file
+end
+
+--- Copy the options and override some of them
+--- @param opts table The options with defaults
+--- @param overrides table The options to override
+--- @return table opts The copy of the options with the overrides
+local function with_opts(opts, overrides)
+    local copy = {}
+    for k, v in pairs(opts) do
+        copy[k] = v
+    end
+    for k, v in pairs(overrides) do
+        copy[k] = v
+    end
+    return copy
+end
+
+--- Safely call a function with error handling
+--- @param msg string Error message prefix
+--- @param fn function Function to call
+--- @param ... any Arguments to pass to the function
+--- @return boolean ok True if the function executed successfully
+--- @return any ... results of the function or an error message if failed
+local function safecall(msg, fn, ...)
+    local res = {
+        pcall(fn, ...),
+    }
+    if not res[1] then
+        return false, format('ERROR: %s: %s', msg, res[2])
+    end
+    return true, unpack(res, 2, 10)
+end
+
+--- Run the sampling function with warmup
+--- @param name string The name of the benchmark
+--- @param fn function The function to sample
+--- @param ctx table The context object for the sampling function
+--- @return measure.samples? samples The samples object with collected data
+--- @return any err Error message if failed
+local function do_sampling(name, fn, ctx)
+    if ctx.gc_stopped then
+        -- stop the GC only while the function runs, so the memory freed by
+        -- the full GC before each sample is reused as usual
+        local run = fn
+        fn = function(...)
+            collectgarbage('stop')
+            local ok, err = pcall(run, ...)
+            -- restart the GC even if the function fails, or it stays stopped
+            -- for the following describes
+            collectgarbage('restart')
+            if not ok then
+                error(err, 0)
+            end
+        end
+    end
+
+    if ctx.jit_trace then
+        -- tell the phase of the following trace events
+        local run = fn
+        local recorder = ctx.jit_trace
+        fn = function(is_warmup, ...)
+            recorder:set_phase(is_warmup and 'warmup' or 'sampling')
+            run(is_warmup, ...)
+        end
+    end
+
+    if ctx.heap then
+        -- run the full GC after every interval invocations and record the
+        -- heap size that is still reachable
+        local run = fn
+        local heap = ctx.heap
+        local interval = ctx.heap_interval
+        local nprobe = 0
+        local ncall = 0
+        fn = function(is_warmup, ...)
+            run(is_warmup, ...)
+            if not is_warmup then
+                ncall = ncall + 1
+                if ncall % interval == 0 then
+                    collectgarbage('collect')
+                    nprobe = nprobe + 1
+                    heap[nprobe] = collectgarbage('count')
+                end
+            end
+        end
+    end
+
+    if ctx.profile then
+        -- start the profile before the first and stop it after the last
+        -- invocation
+        local run = fn
+        local profile = ctx.profile
+        local nrun = ctx.sample_size
+        local ncall = 0
+        fn = function(is_warmup, ...)
+            if not is_warmup then
+                ncall = ncall + 1
+                if ncall == 1 then
+                    profile.start()
+                end
+            end
+            run(is_warmup, ...)
+            if not is_warmup and ncall == nrun then
+                profile.stop()
+            end
+        end
+    end
+
+    if ctx.sample_size then
+        -- collect the fixed number of samples
+        local samples = new_samples(name, ctx.sample_size, ctx.gc_step,
+                                    ctx.confidence_level, ctx.rciw)
+        local ok, err = sampler(fn, samples, ctx.warmup, nil, ctx.evict_kb,
+                                ctx.before)
+        if not ok then
+            error(err, 2)
+        end
+        return samples
+    end
+
+    local iteration = 1
+    local sample_size = 30
+    local warmup = ctx.warmup
+    local samples = new_samples(name, sample_size, ctx.gc_step,
+                                ctx.confidence_level, ctx.rciw)
+
+    printf('    - Sampling %d samples (iteration %d, warmup %d sec)',
+           sample_size, iteration, warmup)
+    while sample_size do
+        local ok, err = sampler(fn, samples, warmup, nil, ctx.evict_kb,
+                                ctx.before)
+        if not ok then
+            error(err, 2)
+        end
+
+        local ci = stats_ci(samples, ctx.max_sample_size)
+        sample_size = ci.resample_size
+        if sample_size then
+            iteration = iteration + 1
+            warmup = nil -- no warmup for subsequent iterations
+            samples:capacity(sample_size - #samples)
+            printf('    - Sampling %d samples (iteration %d)', sample_size,
+                   iteration)
+        end
+    end
+
+    return samples
+end
+
+--- Do nothing, in place of the hooks that are not defined
+local function NOOP()
+end
+
+--- Run the setup(), run() and teardown() of the describe
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @return measure.samples? samples The samples object with collected data
+--- @return any err Error message if failed
+local function sample_describe(desc, opts)
+    -- execute setup() function if defined
+    local ok, res = safecall('setup()', desc.spec.setup or NOOP, opts.context)
+    if not ok then
+        return nil, res
+    end
+
+    -- execute run() or run_with_timer() function
+    local bench_ok, bench_res
+    if desc.spec.run then
+        bench_ok, bench_res = safecall('run()', function()
+            return do_sampling(desc.spec.name, desc.spec.run, opts)
+        end)
+    else
+        bench_ok, bench_res = safecall('run_with_timer()',
+                                       desc.spec.run_with_timer, function(fn)
+            return do_sampling(desc.spec.name, fn, opts)
+        end)
+    end
+
+    -- execute teardown() function if defined
+    ok, res = safecall('teardown()', desc.spec.teardown or NOOP, opts.context)
+    if not ok then
+        return nil, res
+    end
+
+    if not bench_ok then
+        -- benchmarking failed
+        return nil, bench_res
+    end
+    return bench_res
+end
+
+--- Run the describe in the child processes one after another.
+--- Each child process runs setup(), run() and teardown() and sends the
+--- collected samples back to the parent process.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param nproc integer The number of child processes
+--- @param label string The label of the progress message
+--- @param prepare function? The function to prepare the child process
+--- @return measure.samples[]? list The samples collected in each child process
+--- @return any err Error message if failed
+local function fork_describe(desc, opts, nproc, label, prepare)
+    local list = {}
+    for i = 1, nproc do
+        printf('  - %s %d/%d', label, i, nproc)
+        local src, err = forkrun(function()
+            if prepare then
+                prepare()
+            end
+            local samples, serr = sample_describe(desc, opts)
+            if not samples then
+                error(serr, 0)
+            end
+            return assert(serialize.encode(samples:dump()))
+        end)
+        if not src then
+            return nil, format('ERROR: %s %d: %s', label, i, err)
+        end
+
+        local dump
+        dump, err = serialize.decode(src)
+        if not dump then
+            return nil, format('ERROR: %s %d: %s', label, i, err)
+        end
+        list[i] = new_samples(dump)
+    end
+    return list
+end
+
+--- Run the describe again in this process under the profile.
+--- The describe runs with the fixed number of samples and without the full GC
+--- before each sample, and the profile is started before the first and
+--- stopped after the last run.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param runs integer The number of runs
+--- @param label string The label of the progress message
+--- @param profile table The start() and stop() functions of the profile
+--- @return boolean ok True if successful
+--- @return any err Error message if failed
+local function profile_describe(desc, opts, runs, label, profile)
+    local profile_opts = with_opts(opts, {
+        gc_step = GC_STEP_AUTO,
+        sample_size = runs,
+        profile = profile,
+    })
+
+    printf('    - %s of %d runs', label, runs)
+    local samples, err = sample_describe(desc, profile_opts)
+    if not samples then
+        return false, err
+    end
+    return true
+end
+
+--- Get the module search paths of the variant of the A/B comparison
+--- @param v string|table The root directory or the table of path and cpath
+--- @return string? path The search path of the Lua modules
+--- @return string? cpath The search path of the C modules
+local function variant_paths(v)
+    if type(v) == 'string' then
+        return v .. '/?.lua;' .. v .. '/?/init.lua', v .. '/?.so'
+    end
+    return v.path, v.cpath
+end
+
+--- Run the describe with the module search paths of the variant in a child
+--- process. The benchmark file is reloaded in the child process after the
+--- modules it loaded are unloaded, so the describe uses the modules found in
+--- the search paths of the variant.
+--- @param desc measure.describe The describe to run
+--- @param opts table The options with defaults
+--- @param variant string|table The variant of the A/B comparison
+--- @return measure.samples? samples The samples object with collected data
+--- @return any err Error message if failed
+local function sample_variant(desc, opts, variant)
+    local name = desc.spec.name
+    local pathname = desc.fileinfo.pathname
+    local path, cpath = variant_paths(variant)
+    local src, err = forkrun(function()
+        -- unload the modules except the ones used by this command
+        for k in pairs(package.loaded) do
+            if not BASE_MODULES[k] and k ~= 'measure' and
+                not find(k, '^measure%.') then
+                package.loaded[k] = nil
+            end
+        end
+        if path then
+            package.path = path .. ';' .. package.path
+        end
+        if cpath then
+            package.cpath = cpath .. ';' .. package.cpath
+        end
+
+        local file = assert(load_file(pathname))
+        return pcall_in_dir(file.dirname, function()
+            local vdesc
+            for _, v in ipairs(file.spec.describes) do
+                if v.spec.name == name then
+                    vdesc = v
+                end
+            end
+            if not vdesc then
+                error(format('describe %q not found', name), 0)
+            end
+
+            local hooks = file.spec.hooks
+            local ok, res = safecall('before_all()', hooks.before_all or NOOP)
+            if not ok then
+                error(res, 0)
+            end
+            local samples, serr = sample_describe(vdesc, opts)
+            ok, res = safecall('after_all()', hooks.after_all or NOOP,
+                               res or {})
+            if not samples then
+                error(serr, 0)
+            elseif not ok then
+                error(res, 0)
+            end
+            return assert(serialize.encode(samples:dump()))
+        end)
+    end)
+    if not src then
+        return nil, err
+    end
+
+    local dump
+    dump, err = serialize.decode(src)
+    if not dump then
+        return nil, err
+    end
+    return new_samples(dump)
+end
+
+--- Get the short_src of the functions on the call stack and of this module,
+--- which are the frames above the describe run by profile()
+--- @return table<string, boolean> srcs The set of the short_src
+local function caller_sources()
+    local srcs = {
+        [SOURCE] = true,
+    }
+    local level = 2
+    local info = debug_getinfo(level, 'S')
+    while info do
+        if info.what ~= 'C' then
+            srcs[info.short_src] = true
+        end
+        level = level + 1
+        info = debug_getinfo(level, 'S')
+    end
+    return srcs
+end
+
+return {
+    GC_STEP_AUTO = GC_STEP_AUTO,
+    NOOP = NOOP,
+    printf = printf,
+    pcall_in_dir = pcall_in_dir,
+    load_file = load_file,
+    with_opts = with_opts,
+    safecall = safecall,
+    sample = sample_describe,
+    fork = fork_describe,
+    profile = profile_describe,
+    variant = sample_variant,
+    caller_sources = caller_sources,
+}
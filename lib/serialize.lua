@@ -0,0 +1,170 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.serialize
+-- This module serializes the plain values into the Lua source code to pass
+-- them between the processes
+--
+local type = type
+local pairs = pairs
+local ipairs = ipairs
+local pcall = pcall
+local tostring = tostring
+local error = error
+local load = load
+local setfenv = setfenv
+local loadstring = loadstring or load
+local format = string.format
+local concat = table.concat
+local sort = table.sort
+local math_type = math.type
+local INF_POS = math.huge
+local INF_NEG = -INF_POS
+
+--- Encode a number so that it is restored to the same value
+--- @param v number
+--- @return string
+local function encode_number(v)
+    if v ~= v then
+        return '0/0'
+    elseif v == INF_POS then
+        return '1/0'
+    elseif v == INF_NEG then
+        return '-1/0'
+    elseif math_type and math_type(v) == 'integer' then
+        return format('%d', v)
+    end
+    return format('%.17g', v)
+end
+
+--- Compare the keys of different types
+--- @param a any
+--- @param b any
+--- @return boolean
+local function compare_keys(a, b)
+    local ta, tb = type(a), type(b)
+    if ta ~= tb then
+        return ta < tb
+    end
+    return a < b
+end
+
+--- Encode a value into the Lua expression
+--- @param v any
+--- @param visited table<table, boolean>
+--- @param buf string[]
+local function encode_value(v, visited, buf)
+    local t = type(v)
+    if t == 'nil' or t == 'boolean' then
+        buf[#buf + 1] = tostring(v)
+    elseif t == 'number' then
+        buf[#buf + 1] = encode_number(v)
+    elseif t == 'string' then
+        buf[#buf + 1] = format('%q', v)
+    elseif t ~= 'table' then
+        error(format('cannot serialize a %s value', t), 0)
+    elseif visited[v] then
+        error('cannot serialize a table with cycles', 0)
+    else
+        visited[v] = true
+        buf[#buf + 1] = '{'
+        -- array part
+        local n = #v
+        for i = 1, n do
+            encode_value(v[i], visited, buf)
+            buf[#buf + 1] = ','
+        end
+        -- hash part in sorted order to produce the same output
+        local keys = {}
+        for k in pairs(v) do
+            local kt = type(k)
+            if kt == 'number' then
+                if k < 1 or k > n or k % 1 ~= 0 then
+                    keys[#keys + 1] = k
+                end
+            elseif kt == 'string' or kt == 'boolean' then
+                keys[#keys + 1] = k
+            else
+                error(format('cannot serialize a %s key', kt), 0)
+            end
+        end
+        sort(keys, compare_keys)
+        for _, k in ipairs(keys) do
+            buf[#buf + 1] = '['
+            encode_value(k, visited, buf)
+            buf[#buf + 1] = ']='
+            encode_value(v[k], visited, buf)
+            buf[#buf + 1] = ','
+        end
+        buf[#buf + 1] = '}'
+        visited[v] = nil
+    end
+end
+
+--- Serialize a value into the Lua expression.
+--- Only nil, boolean, number, string and the tables of them can be serialized.
+--- @param v any The value to serialize
+--- @return string? src The Lua expression
+--- @return any err Error message if failed
+local function encode(v)
+    local buf = {}
+    local ok, err = pcall(encode_value, v, {}, buf)
+    if not ok then
+        return nil, err
+    end
+    return concat(buf)
+end
+
+--- Deserialize a value from the Lua expression created by encode().
+--- The expression is evaluated in an empty environment.
+--- @param src string The Lua expression
+--- @return any v The deserialized value
+--- @return any err Error message if failed
+local function decode(src)
+    if type(src) ~= 'string' then
+        error('src must be a string', 2)
+    end
+
+    local fn, err
+    if setfenv then
+        -- Lua 5.1
+        fn, err = loadstring('return ' .. src, '=serialize')
+        if fn then
+            setfenv(fn, {})
+        end
+    else
+        fn, err = load('return ' .. src, '=serialize', 't', {})
+    end
+    if not fn then
+        return nil, err
+    end
+
+    local ok, v = pcall(fn)
+    if not ok then
+        return nil, v
+    end
+    return v
+end
+
+return {
+    encode = encode,
+    decode = decode,
+}
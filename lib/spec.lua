@@ -80,7 +80,7 @@ function Spec:verify_describes()
     local errs = {}
     for _, desc in ipairs(self.describes) do
         if type(desc.spec.run) ~= 'function' and type(desc.spec.run_with_timer) ~=
-            'function' then
+            'function' and type(desc.spec.require) ~= 'string' then
             -- Collect error message for invalid describe
             errs[#errs + 1] = format(
                                   '%s:%d: %s has not defined a run() or run_with_timer() function',
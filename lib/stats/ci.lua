@@ -30,6 +30,7 @@ local quantile = require('measure.quantile')
 -- Constants for statistical calculations
 local STATS_EPSILON = 1e-15
 local MIN_SAMPLE_SIZE = 30 -- Minimum sample size (CLT threshold)
+local MAX_SAMPLE_SIZE = 5000 -- Default absolute cap of the sample size
 
 -- Quality assessment thresholds based on RCIW (%)
 local QUALITY_EXCELLENT = 2.0 -- RCIW ≤ 2% indicates excellent precision
@@ -89,9 +90,11 @@ end
 --- @param confidence_level number Confidence level in ratio format (e.g., 0.97)
 --- @param current_mean number Current mean of samples
 --- @param current_stderr number Current standard error
+--- @param max_sample_size number Absolute cap of the sample size
 --- @return number|nil recommended sample size (nil if target achieved)
 local function calculate_resample_size(samples, target_rciw, confidence_level,
-                                       current_mean, current_stderr)
+                                       current_mean, current_stderr,
+                                       max_sample_size)
     local current_n = #samples
 
     -- Basic validation
@@ -143,7 +146,7 @@ local function calculate_resample_size(samples, target_rciw, confidence_level,
     -- Apply minimum and reasonable upper bound
     local estimated_n = max(ceil(scaled_estimated_n), current_n + 10) -- At least 10 more samples
     estimated_n = min(estimated_n, current_n * 20) -- Cap at 20x current size
-    estimated_n = min(estimated_n, 5000) -- Absolute cap at 5000 samples
+    estimated_n = min(estimated_n, max_sample_size) -- Absolute cap
 
     -- Only recommend if larger than current sample size
     return estimated_n > current_n and estimated_n or nil
@@ -152,8 +155,9 @@ end
 --- Calculate confidence interval for the mean using t-distribution
 --- Uses appropriate t-values based on degrees of freedom for all sample sizes
 --- @param samples measure.samples An instance of measure.samples with cl() and rciw() methods
+--- @param max_sample_size number? Absolute cap of the recommended sample size (default: 5000)
 --- @return table confidence interval result with quality metrics and resampling recommendations
-local function confidence_interval(samples)
+local function confidence_interval(samples, max_sample_size)
     -- Use confidence_level from options if provided, otherwise from samples
     local level = samples:cl()
     -- Use target_rciw from options if provided, otherwise from samples
@@ -212,7 +216,8 @@ local function confidence_interval(samples)
     result.quality = classify_quality(result.rciw)
     result.resample_size = calculate_resample_size(samples, target_rciw,
                                                    confidence_level, mean_val,
-                                                   stderr_val)
+                                                   stderr_val, max_sample_size or
+                                                       MAX_SAMPLE_SIZE)
 
     return result
 end
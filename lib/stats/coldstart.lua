@@ -0,0 +1,131 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a
+-- copy of this software and associated documentation files (the "Software"),
+-- to deal in the Software without restriction, including without limitation
+-- the rights to use, copy, modify, merge, publish, distribute, sublicense,
+-- and/or sell copies of the Software, and to permit persons to whom the
+-- Software is furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+-- THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+-- FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+-- DEALINGS IN THE SOFTWARE.
+--
+-- Module: measure.stats.coldstart
+-- Statistics of the first invocations of a benchmark function measured in
+-- fresh processes: the first-call latency and the warm-up curve.
+--
+local ipairs = ipairs
+local ceil = math.ceil
+local sort = table.sort
+
+-- Ratio to the steady-state mean under which an invocation is considered warm
+local WARM_THRESHOLD = 1.1
+
+-- NaN value for error handling
+local NaN = 0 / 0
+
+--- Calculate the median of the values
+--- @param values number[] The values (sorted in place)
+--- @return number median
+local function median(values)
+    local n = #values
+    if n == 0 then
+        return NaN
+    end
+    sort(values)
+    if n % 2 == 1 then
+        return values[ceil(n / 2)]
+    end
+    return (values[n / 2] + values[n / 2 + 1]) / 2
+end
+
+--- Calculate the mean of the values
+--- @param values number[] The values
+--- @return number mean
+local function mean(values)
+    local n = #values
+    if n == 0 then
+        return NaN
+    end
+    local sum = 0
+    for _, v in ipairs(values) do
+        sum = sum + v
+    end
+    return sum / n
+end
+
+--- Analyze the first invocations measured in fresh processes.
+--- The i-th sample of each process is the i-th invocation of the function
+--- since the process started, so the values at the same index are combined
+--- across the processes to draw the warm-up curve.
+--- @param samples_list measure.samples[] The samples collected in each process
+--- @param steady measure.samples? The samples of the steady state
+--- @return table result The cold start statistics
+local function coldstart(samples_list, steady)
+    local times = {}
+    local invocations = 0
+    for i, samples in ipairs(samples_list) do
+        times[i] = samples:dump().time_ns
+        if #times[i] > invocations then
+            invocations = #times[i]
+        end
+    end
+
+    -- warm-up curve: the median and mean time of each invocation
+    local curve = {}
+    for idx = 1, invocations do
+        local values = {}
+        for _, list in ipairs(times) do
+            values[#values + 1] = list[idx]
+        end
+        curve[idx] = {
+            mean = mean(values),
+            median = median(values),
+        }
+    end
+
+    -- first-call latency
+    local first = {}
+    for _, list in ipairs(times) do
+        first[#first + 1] = list[1]
+    end
+    sort(first)
+
+    local result = {
+        runs = #samples_list, -- Number of fresh processes
+        invocations = invocations, -- Number of invocations measured per process
+        first = {
+            mean = mean(first),
+            median = median(first),
+            min = first[1] or NaN,
+            max = first[#first] or NaN,
+        },
+        curve = curve,
+        steady_mean = steady and steady:mean() or NaN,
+        slowdown = NaN, -- First-call median to steady-state mean ratio
+        warm_after = nil, -- First invocation within 10% of the steady state
+    }
+
+    local steady_mean = result.steady_mean
+    if steady_mean == steady_mean and steady_mean > 0 then
+        result.slowdown = result.first.median / steady_mean
+        for idx, point in ipairs(curve) do
+            if point.median <= steady_mean * WARM_THRESHOLD then
+                result.warm_after = idx
+                break
+            end
+        end
+    end
+    return result
+end
+
+return coldstart
@@ -0,0 +1,144 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a
+-- copy of this software and associated documentation files (the "Software"),
+-- to deal in the Software without restriction, including without limitation
+-- the rights to use, copy, modify, merge, publish, distribute, sublicense,
+-- and/or sell copies of the Software, and to permit persons to whom the
+-- Software is furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+-- THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+-- FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+-- DEALINGS IN THE SOFTWARE.
+--
+-- Module: measure.stats.hierarchical
+-- Confidence interval of the mean over the samples collected in multiple
+-- processes (forks). Each fork is treated as a random effect, so the interval
+-- includes the run-to-run variance that a single process cannot observe.
+--
+local ipairs = ipairs
+local sqrt = math.sqrt
+local max = math.max
+local quantile = require('measure.quantile')
+local t_critical_value = require('measure.stats.tdist').critical_value
+
+-- NaN value for error handling
+local NaN = 0 / 0
+
+--- Checks if a value is NaN (Not a Number)
+--- @param v any The value to check
+--- @return boolean ok true if the value is NaN, false otherwise
+local function is_nan(v)
+    return not v or v ~= v
+end
+
+--- Calculate the confidence interval of the mean with a one-way random
+--- effects model.
+---
+--- The grand mean is the mean of the fork means, and its standard error is
+--- derived from the variance of the fork means with k-1 degrees of freedom,
+--- which contains both the within-fork and the between-fork variance.
+--- @param samples_list measure.samples[] The samples collected in each fork
+--- @return table result The confidence interval and the variance components
+local function hierarchical(samples_list)
+    local k = #samples_list
+    local level = samples_list[1]:cl()
+    local result = {
+        forks = k, -- Number of forks
+        sample_size = 0, -- Total number of samples
+        level = level, -- Confidence level (e.g., 95 for 95%)
+        mean = NaN, -- Grand mean of the fork means
+        lower = NaN, -- Lower bound of the confidence interval
+        upper = NaN, -- Upper bound of the confidence interval
+        rciw = NaN, -- Relative confidence interval width (%)
+        pooled_rciw = NaN, -- RCIW if all samples were from one process (%)
+        within_stddev = NaN, -- Pooled standard deviation within forks
+        between_stddev = NaN, -- Standard deviation between forks
+        icc = NaN, -- Intraclass correlation (share of the between-fork variance)
+        means = {}, -- Mean of each fork
+    }
+
+    -- collect the statistics of each fork
+    local sizes = {}
+    local sum = 0
+    local weighted_sum = 0
+    local sum_inv_n = 0
+    local within_ss = 0
+    local within_df = 0
+    for i, samples in ipairs(samples_list) do
+        local n = #samples
+        if n < 2 then
+            return result
+        end
+        local mean = samples:mean()
+        result.means[i] = mean
+        result.sample_size = result.sample_size + n
+        sizes[i] = n
+        sum = sum + mean
+        weighted_sum = weighted_sum + mean * n
+        sum_inv_n = sum_inv_n + 1 / n
+        within_ss = within_ss + samples:variance() * (n - 1)
+        within_df = within_df + n - 1
+    end
+
+    local mean = sum / k
+    local within_var = within_ss / within_df
+    result.mean = mean
+    result.within_stddev = sqrt(within_var)
+    if is_nan(mean) or mean == 0 then
+        return result
+    end
+
+    local confidence_level = level / 100.0
+    -- RCIW of the naive interval that ignores the fork boundaries
+    local total_n = result.sample_size
+    local total_mean = weighted_sum / total_n
+    local total_ss = within_ss
+    for i, m in ipairs(result.means) do
+        total_ss = total_ss + sizes[i] * (m - total_mean) ^ 2
+    end
+    local pooled_se = sqrt(total_ss / (total_n - 1) / total_n)
+    result.pooled_rciw = 2 * quantile(confidence_level) * pooled_se /
+                             total_mean * 100
+
+    if k < 2 then
+        -- the between-fork variance cannot be estimated from a single fork
+        local margin = quantile(confidence_level) * pooled_se
+        result.lower = mean - margin
+        result.upper = mean + margin
+        result.rciw = result.pooled_rciw
+        return result
+    end
+
+    -- variance of the fork means
+    local means_ss = 0
+    for _, m in ipairs(result.means) do
+        means_ss = means_ss + (m - mean) ^ 2
+    end
+    local means_var = means_ss / (k - 1)
+
+    -- variance components: Var(mean_i) = between_var + within_var / n_i
+    local between_var = max(0, means_var - within_var * sum_inv_n / k)
+    result.between_stddev = sqrt(between_var)
+    if between_var + within_var > 0 then
+        result.icc = between_var / (between_var + within_var)
+    else
+        result.icc = 0
+    end
+
+    local margin = t_critical_value(confidence_level, k - 1) * sqrt(means_var / k)
+    result.lower = mean - margin
+    result.upper = mean + margin
+    result.rciw = 2 * margin / mean * 100
+    return result
+end
+
+return hierarchical
@@ -0,0 +1,94 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a
+-- copy of this software and associated documentation files (the "Software"),
+-- to deal in the Software without restriction, including without limitation
+-- the rights to use, copy, modify, merge, publish, distribute, sublicense,
+-- and/or sell copies of the Software, and to permit persons to whom the
+-- Software is furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+-- THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+-- FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+-- DEALINGS IN THE SOFTWARE.
+--
+-- Module: measure.stats.leak
+-- Leak test of a benchmark function: the linear regression of the heap size
+-- after a full GC on the number of invocations.
+--
+local ipairs = ipairs
+local sqrt = math.sqrt
+local t = require('measure.stats.tdist')
+
+-- NaN value for error handling
+local NaN = 0 / 0
+
+--- Test whether the heap size after a full GC grows with the invocations.
+--- @param heap_kb number[] The heap size in KB after a full GC, measured
+---                         every interval invocations
+--- @param interval integer The number of invocations between the measurements
+--- @param level number The confidence level (e.g., 95 for 95%)
+--- @return table result The growth per invocation with its confidence
+---                      interval and p-value
+local function leak(heap_kb, interval, level)
+    local n = #heap_kb
+    local result = {
+        probes = n, -- Number of heap measurements
+        interval = interval, -- Invocations between the measurements
+        level = level, -- Confidence level (e.g., 95 for 95%)
+        first_kb = heap_kb[1] or NaN, -- Heap size at the first measurement
+        last_kb = heap_kb[n] or NaN, -- Heap size at the last measurement
+        slope_kb = NaN, -- Growth of the heap per invocation in KB
+        lower = NaN, -- Lower bound of the growth
+        upper = NaN, -- Upper bound of the growth
+        p_value = NaN, -- Two-sided p-value of the slope
+        leaking = false, -- True if the growth is significantly positive
+    }
+    if n < 3 then
+        return result
+    end
+
+    -- x is the number of invocations before the measurement
+    local mean_x = (n - 1) * interval / 2
+    local mean_y = 0
+    for _, y in ipairs(heap_kb) do
+        mean_y = mean_y + y
+    end
+    mean_y = mean_y / n
+
+    local sxx, sxy = 0, 0
+    for i, y in ipairs(heap_kb) do
+        local dx = (i - 1) * interval - mean_x
+        sxx = sxx + dx * dx
+        sxy = sxy + dx * (y - mean_y)
+    end
+    local slope = sxy / sxx
+    result.slope_kb = slope
+
+    local sse = 0
+    for i, y in ipairs(heap_kb) do
+        local fit = mean_y + slope * ((i - 1) * interval - mean_x)
+        sse = sse + (y - fit) ^ 2
+    end
+    local se = sqrt(sse / (n - 2) / sxx)
+    local margin = t.critical_value(level / 100, n - 2) * se
+    result.lower = slope - margin
+    result.upper = slope + margin
+    if se > 0 then
+        result.p_value = t.p_value(slope / se, n - 2)
+    else
+        -- the heap grows exactly linearly
+        result.p_value = slope == 0 and 1 or 0
+    end
+    result.leaking = slope > 0 and result.p_value < 1 - level / 100
+    return result
+end
+
+return leak
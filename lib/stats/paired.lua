@@ -0,0 +1,97 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a
+-- copy of this software and associated documentation files (the "Software"),
+-- to deal in the Software without restriction, including without limitation
+-- the rights to use, copy, modify, merge, publish, distribute, sublicense,
+-- and/or sell copies of the Software, and to permit persons to whom the
+-- Software is furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+-- THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+-- FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+-- DEALINGS IN THE SOFTWARE.
+--
+-- Module: measure.stats.paired
+-- Paired comparison of two variants measured in alternating rounds.
+-- The variants are compared round by round, so the drift of the host that
+-- affects both variants in the same round is cancelled out.
+--
+local ipairs = ipairs
+local exp = math.exp
+local log = math.log
+local sqrt = math.sqrt
+local t = require('measure.stats.tdist')
+
+-- NaN value for error handling
+local NaN = 0 / 0
+
+--- Compare the two variants with the paired t-test on the log ratio of the
+--- round means.
+--- @param list_a measure.samples[] The samples of the variant A in each round
+--- @param list_b measure.samples[] The samples of the variant B in each round
+--- @return table result The ratio of B to A with its confidence interval
+local function paired(list_a, list_b)
+    local n = #list_a
+    local level = list_a[1]:cl()
+    local result = {
+        rounds = n, -- Number of rounds
+        level = level, -- Confidence level (e.g., 95 for 95%)
+        mean_a = NaN, -- Mean of the round means of A
+        mean_b = NaN, -- Mean of the round means of B
+        ratio = NaN, -- Geometric mean of B/A of the rounds
+        lower = NaN, -- Lower bound of the ratio
+        upper = NaN, -- Upper bound of the ratio
+        p_value = NaN, -- Two-sided p-value of the paired t-test
+        wins = 0, -- Number of rounds where B was faster than A
+    }
+
+    local sum_a, sum_b, sum_d = 0, 0, 0
+    local diffs = {}
+    for i, a in ipairs(list_a) do
+        local ma = a:mean()
+        local mb = list_b[i]:mean()
+        if not (ma > 0 and mb > 0) then
+            return result
+        end
+        sum_a = sum_a + ma
+        sum_b = sum_b + mb
+        diffs[i] = log(mb / ma)
+        sum_d = sum_d + diffs[i]
+        if mb < ma then
+            result.wins = result.wins + 1
+        end
+    end
+    result.mean_a = sum_a / n
+    result.mean_b = sum_b / n
+
+    local mean_d = sum_d / n
+    result.ratio = exp(mean_d)
+    if n < 2 then
+        return result
+    end
+
+    local ss = 0
+    for _, d in ipairs(diffs) do
+        ss = ss + (d - mean_d) ^ 2
+    end
+    local se = sqrt(ss / (n - 1) / n)
+    local margin = t.critical_value(level / 100, n - 1) * se
+    result.lower = exp(mean_d - margin)
+    result.upper = exp(mean_d + margin)
+    if se > 0 then
+        result.p_value = t.p_value(mean_d / se, n - 1)
+    else
+        result.p_value = mean_d == 0 and 1 or 0
+    end
+    return result
+end
+
+return paired
@@ -29,6 +29,8 @@ local floor = math.floor
 local open = io.open
 local popen = io.popen
 local format = require('string.format')
+local uname = require('measure.uname')
+local hostinfo = require('measure.hostinfo')
 
 --- Execute shell command and capture output
 --- @param cmd string shell command to execute
@@ -47,6 +49,18 @@ local function exec_command(cmd)
     return result
 end
 
+--- Cache for the result of uname(2)
+local UNAME = nil
+
+--- Get the system name and version information via uname(2)
+--- @return table uname Table with sysname, release, version and machine fields
+local function get_uname()
+    if not UNAME then
+        UNAME = uname() or {}
+    end
+    return UNAME
+end
+
 --- Detect the operating system type
 --- @return string|nil OS type ('Linux', 'OSX', 'BSD', etc.) or nil if detection fails
 local function detect_os_type()
@@ -55,44 +69,47 @@ local function detect_os_type()
         os_type = jit.os
     end
     if not os_type then
-        local handle = popen('uname 2>/dev/null')
-        if handle then
-            local uname = handle:read('*l')
-            handle:close()
-            if uname == 'Darwin' then
-                os_type = 'OSX'
-            else
-                os_type = uname
-            end
+        os_type = get_uname().sysname
+        if os_type == 'Darwin' then
+            os_type = 'OSX'
         end
     end
     return os_type
 end
 
---- Get OS information for Linux systems
+--- Get the basic OS information from uname(2)
 --- @return table OS information with name, version, kernel, and arch fields
-local function get_os_info_linux()
-    local info = {
-        name = exec_command('uname -s') or 'Unknown',
-        version = exec_command('uname -r') or 'Unknown',
-        kernel = exec_command('uname -v') or 'Unknown',
-        arch = exec_command('uname -m') or 'Unknown',
+local function get_os_info_uname()
+    local u = get_uname()
+    return {
+        name = u.sysname or 'Unknown',
+        version = u.release or 'Unknown',
+        kernel = u.version or 'Unknown',
+        arch = u.machine or 'Unknown',
     }
+end
 
-    -- Get detailed OS version
-    local lsb_release = exec_command('lsb_release -d 2>/dev/null')
-    if lsb_release then
-        info.version = lsb_release:match('Description:%s*(.+)') or info.version
+--- Get OS information for Linux systems
+--- @return table OS information with name, version, kernel, and arch fields
+local function get_os_info_linux()
+    local info = get_os_info_uname()
+
+    -- Get detailed OS version from /etc/os-release
+    local pretty_name
+    local os_release = open('/etc/os-release', 'r')
+    if os_release then
+        local content = os_release:read('*a')
+        os_release:close()
+        pretty_name = content:match('PRETTY_NAME="([^"]+)"')
+    end
+    if pretty_name then
+        info.version = pretty_name
     else
-        -- Try /etc/os-release
-        local os_release = open('/etc/os-release', 'r')
-        if os_release then
-            local content = os_release:read('*a')
-            os_release:close()
-            local pretty_name = content:match('PRETTY_NAME="([^"]+)"')
-            if pretty_name then
-                info.version = pretty_name
-            end
+        -- Fallback to lsb_release command
+        local lsb_release = exec_command('lsb_release -d 2>/dev/null')
+        if lsb_release then
+            info.version = lsb_release:match('Description:%s*(.+)') or
+                               info.version
         end
     end
 
@@ -102,12 +119,7 @@ end
 --- Get OS information for macOS systems
 --- @return table OS information with name, version, kernel, and arch fields
 local function get_os_info_macos()
-    local info = {
-        name = exec_command('uname -s') or 'Unknown',
-        version = exec_command('uname -r') or 'Unknown',
-        kernel = exec_command('uname -v') or 'Unknown',
-        arch = exec_command('uname -m') or 'Unknown',
-    }
+    local info = get_os_info_uname()
 
     -- Get macOS version
     local sw_vers = exec_command('sw_vers -productVersion')
@@ -121,12 +133,7 @@ end
 --- Get OS information for BSD systems
 --- @return table OS information with name, version, kernel, and arch fields
 local function get_os_info_bsd()
-    return {
-        name = exec_command('uname -s') or 'Unknown',
-        version = exec_command('uname -r') or 'Unknown',
-        kernel = exec_command('uname -v') or 'Unknown',
-        arch = exec_command('uname -m') or 'Unknown',
-    }
+    return get_os_info_uname()
 end
 
 --- Get OS information based on detected platform
@@ -150,54 +157,31 @@ local function get_os_info()
     end
 end
 
+--- Cache for the host information read from /proc and sysfs
+local HOSTINFO = nil
+
+--- Get the host information read from /proc and sysfs
+--- @return table hostinfo Host information or empty table if not available
+local function get_hostinfo()
+    if not HOSTINFO then
+        HOSTINFO = hostinfo() or {}
+    end
+    return HOSTINFO
+end
+
 --- Get CPU information for Linux systems
 --- @return table CPU information with model, cores, threads, and frequency fields
 local function get_cpu_info_linux()
+    local cpu = get_hostinfo().cpu or {}
     local info = {
-        model = 'Unknown',
-        cores = 'Unknown',
-        threads = 'Unknown',
+        model = cpu.model or 'Unknown',
+        cores = cpu.cores and tostring(cpu.cores) or 'Unknown',
+        threads = cpu.threads and tostring(cpu.threads) or 'Unknown',
         frequency = 'Unknown',
     }
-
-    local cpuinfo = open('/proc/cpuinfo', 'r')
-    if cpuinfo then
-        local content = cpuinfo:read('*a')
-        cpuinfo:close()
-
-        -- Get CPU model
-        info.model = content:match('model name%s*:%s*([^\n]+)') or 'Unknown'
-
-        -- Count physical cores and threads
-        local physical_ids = {}
-        local processor_count = 0
-        for line in content:gmatch('[^\n]+') do
-            if line:match('^processor%s*:') then
-                processor_count = processor_count + 1
-            end
-            local physical_id = line:match('physical id%s*:%s*(%d+)')
-            if physical_id then
-                physical_ids[physical_id] = true
-            end
-        end
-
-        info.threads = tostring(processor_count)
-        local core_count = 0
-        for _ in pairs(physical_ids) do
-            core_count = core_count + 1
-        end
-        if core_count == 0 then
-            core_count = processor_count
-        end
-        info.cores = tostring(core_count)
-
-        -- Get CPU frequency
-        local freq = content:match('cpu MHz%s*:%s*([%d%.]+)')
-        if freq then
-            info.frequency = format('%.2f GHz', tonumber(freq) / 1000)
-        end
+    if cpu.mhz then
+        info.frequency = format('%.2f GHz', cpu.mhz / 1000)
     end
-
     return info
 end
 
@@ -248,38 +232,17 @@ end
 --- Get memory information for Linux systems
 --- @return table Memory information with total and available fields
 local function get_memory_info_linux()
+    local memory = get_hostinfo().memory or {}
     local info = {
         total = 'Unknown',
         available = 'Unknown',
     }
-
-    local meminfo = open('/proc/meminfo', 'r')
-    if meminfo then
-        local content = meminfo:read('*a')
-        meminfo:close()
-
-        local total_kb = content:match('MemTotal:%s*(%d+)')
-        local available_kb = content:match('MemAvailable:%s*(%d+)')
-        if not available_kb then
-            -- Fallback for older kernels
-            local free_kb = content:match('MemFree:%s*(%d+)')
-            local buffers_kb = content:match('Buffers:%s*(%d+)')
-            local cached_kb = content:match('Cached:%s*(%d+)')
-            if free_kb and buffers_kb and cached_kb then
-                available_kb = tonumber(free_kb) + tonumber(buffers_kb) +
-                                   tonumber(cached_kb)
-            end
-        end
-
-        if total_kb then
-            info.total = format('%.2f GB', tonumber(total_kb) / 1024 / 1024)
-        end
-        if available_kb then
-            info.available = format('%.2f GB',
-                                    tonumber(available_kb) / 1024 / 1024)
-        end
+    if memory.total_kb then
+        info.total = format('%.2f GB', memory.total_kb / 1024 / 1024)
+    end
+    if memory.available_kb then
+        info.available = format('%.2f GB', memory.available_kb / 1024 / 1024)
     end
-
     return info
 end
 
@@ -332,6 +295,25 @@ local function get_memory_info()
     end
 end
 
+--- Get the CPU tuning state that affects the stability of the measurements
+--- @return table? tuning Table with governor, boost, smt, isolated, online and loadavg fields, or nil if not available
+local function get_tuning_info()
+    if detect_os_type() ~= 'Linux' then
+        return nil
+    end
+
+    local info = get_hostinfo()
+    return {
+        governor = info.governor,
+        boost = info.boost,
+        smt = info.smt,
+        smt_active = info.smt_active,
+        isolated = info.isolated,
+        online = info.online,
+        loadavg = info.loadavg,
+    }
+end
+
 --- Get Lua runtime information
 --- @return table Lua runtime information with version and JIT status
 local function get_lua_info()
@@ -407,6 +389,10 @@ local function get_all()
     if CACHED_INFO then
         -- Only update timestamp for each call
         CACHED_INFO.timestamp = timestamp
+        if CACHED_INFO.tuning then
+            -- load average changes over time
+            CACHED_INFO.tuning.loadavg = (hostinfo() or {}).loadavg
+        end
         return CACHED_INFO
     end
 
@@ -416,6 +402,7 @@ local function get_all()
         cpu = get_cpu_info(),
         memory = get_memory_info(),
         lua = get_lua_info(),
+        tuning = get_tuning_info(),
         timestamp = timestamp,
     }
 
@@ -0,0 +1,360 @@
+--
+-- Copyright (C) 2025 Masatoshi Fukunaga
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the "Software"), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+-- copies of the Software, and to permit persons to whom the Software is
+-- furnished to do so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in
+-- all copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+-- IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+-- FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+-- AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+-- LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+-- OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+-- THE SOFTWARE.
+--
+-- Module: measure.watch
+-- This module watches benchmark files and their dependencies for changes
+--
+local type = type
+local pairs = pairs
+local ipairs = ipairs
+local setmetatable = setmetatable
+local tostring = tostring
+local format = string.format
+local match = string.match
+local find = string.find
+local sub = string.sub
+local concat = table.concat
+local sort = table.sort
+local open = io.open
+local debug_getinfo = debug.getinfo
+local realpath = require('measure.realpath')
+local new_inotify = require('measure.inotify')
+
+--- Interval to wait for further events after the first change is detected.
+--- Editors usually emit several events per save, so they are coalesced.
+local SETTLE_SEC = 0.1
+
+--- @class measure.watch
+--- @field protected inotify measure.inotify The inotify instance
+--- @field protected dirs table<string, integer> Directory to watch descriptor
+--- @field protected wds table<integer, string> Watch descriptor to directory
+--- @field protected files table<string, integer> Watched file pathnames and
+---                                                the number of their adds
+local Watch = require('measure.metatable')('measure.watch')
+
+--- Split a pathname into the directory and filename
+--- @param pathname string
+--- @return string dirname
+--- @return string filename
+local function split(pathname)
+    local dir, file = match(pathname, '^(.-)/?([^/]+)$')
+    if not dir or dir == '' then
+        dir = sub(pathname, 1, 1) == '/' and '/' or '.'
+    end
+    return dir, file
+end
+
+--- Add a file to the watch list.
+--- The parent directory of the file is watched instead of the file itself so
+--- that the file can be replaced by rename. A file added more than once is
+--- watched until it is removed as many times.
+--- @param pathname string The pathname of the file to watch
+--- @return boolean ok True if successful
+--- @return string? err Error message if failed
+function Watch:add(pathname)
+    if type(pathname) ~= 'string' then
+        error('pathname must be a string', 2)
+    end
+
+    local dir, file = split(realpath(pathname))
+    if not self.dirs[dir] then
+        local wd, err = self.inotify:watch(dir)
+        if not wd then
+            return false, format('failed to watch %q: %s', dir, err)
+        end
+        self.dirs[dir] = wd
+        self.wds[wd] = dir
+    end
+    local key = realpath(dir .. '/' .. file)
+    self.files[key] = (self.files[key] or 0) + 1
+    return true
+end
+
+--- Remove a file from the watch list.
+--- The parent directory stops being watched when none of its files are
+--- watched.
+--- @param pathname string The pathname of the file to remove
+--- @return boolean ok True if successful
+--- @return string? err Error message if failed
+function Watch:remove(pathname)
+    if type(pathname) ~= 'string' then
+        error('pathname must be a string', 2)
+    end
+
+    local dir, file = split(realpath(pathname))
+    local key = realpath(dir .. '/' .. file)
+    local n = self.files[key]
+    if not n then
+        return true
+    elseif n > 1 then
+        self.files[key] = n - 1
+        return true
+    end
+    self.files[key] = nil
+
+    -- keep watching the directory if it has other files
+    for v in pairs(self.files) do
+        if split(v) == dir then
+            return true
+        end
+    end
+    local wd = self.dirs[dir]
+    if wd then
+        self.dirs[dir] = nil
+        self.wds[wd] = nil
+        local ok, err = self.inotify:unwatch(wd)
+        if not ok then
+            return false, format('failed to unwatch %q: %s', dir, err)
+        end
+    end
+    return true
+end
+
+--- Check whether the file is being watched
+--- @param pathname string The pathname of the file
+--- @return boolean
+function Watch:has(pathname)
+    return self.files[realpath(pathname)] ~= nil
+end
+
+--- Collect changed files from the inotify events
+--- @param events table[] The list of inotify events
+--- @param changed table<string, boolean> The set of changed pathnames
+--- @return boolean overflow True if the event queue overflowed
+function Watch:collect(events, changed)
+    local overflow = false
+    for _, ev in ipairs(events) do
+        local dir = self.wds[ev.wd]
+        if ev.event == 'overflow' then
+            overflow = true
+        elseif ev.event == 'ignored' then
+            -- the directory is no longer watched
+            if dir then
+                self.dirs[dir] = nil
+                self.wds[ev.wd] = nil
+            end
+        elseif dir and ev.name then
+            local pathname = realpath(dir .. '/' .. ev.name)
+            if self.files[pathname] then
+                changed[pathname] = true
+            end
+        end
+    end
+    return overflow
+end
+
+--- Wait for changes of the watched files.
+--- @param timeout number? Timeout in seconds (nil to wait forever)
+--- @return string[]? pathnames The sorted list of changed file pathnames
+--- @return string? err Error message if failed
+function Watch:wait(timeout)
+    local changed = {}
+    local events, err = self.inotify:read(timeout)
+    while events and #events == 0 and not timeout do
+        -- interrupted by a signal, so wait again
+        events, err = self.inotify:read(timeout)
+    end
+    if not events then
+        return nil, err
+    end
+
+    local overflow = self:collect(events, changed)
+    while #events > 0 do
+        -- coalesce the burst of events caused by a single save
+        events, err = self.inotify:read(SETTLE_SEC)
+        if not events then
+            return nil, err
+        end
+        overflow = self:collect(events, changed) or overflow
+    end
+
+    local list = {}
+    if overflow then
+        -- events are lost, so consider all files changed
+        for pathname in pairs(self.files) do
+            list[#list + 1] = pathname
+        end
+    else
+        for pathname in pairs(changed) do
+            list[#list + 1] = pathname
+        end
+    end
+    sort(list)
+    return list
+end
+
+--- Stop watching all files
+function Watch:close()
+    self.inotify:close()
+end
+
+--- Create a new watch object
+--- @return measure.watch? watch The new watch object
+--- @return string? err Error message if failed
+local function new()
+    local inotify, err = new_inotify()
+    if not inotify then
+        return nil, err
+    end
+
+    return setmetatable({
+        inotify = inotify,
+        dirs = {},
+        wds = {},
+        files = {},
+    }, Watch)
+end
+
+--- Cache of source file contents split into lines
+--- @type table<string, string[]>
+local SOURCE_LINES = {}
+
+--- Read the lines of the source file
+--- @param pathname string
+--- @return string[]? lines
+local function read_lines(pathname)
+    local lines = SOURCE_LINES[pathname]
+    if not lines then
+        local f = open(pathname, 'r')
+        if not f then
+            return nil
+        end
+        lines = {}
+        for line in f:lines() do
+            lines[#lines + 1] = line
+        end
+        f:close()
+        SOURCE_LINES[pathname] = lines
+    end
+    return lines
+end
+
+--- Get the fingerprint of a function definition.
+--- The fingerprint is the source code of the function, so it does not change
+--- when only the surrounding code of the function is modified.
+--- @param fn function The function
+--- @return string fingerprint
+local function fingerprint_function(fn)
+    local info = debug_getinfo(fn, 'S')
+    if info.what == 'C' then
+        return tostring(fn)
+    end
+
+    local source = info.source
+    if sub(source, 1, 1) == '@' then
+        local lines = read_lines(sub(source, 2))
+        if lines then
+            return concat(lines, '\n', info.linedefined, info.lastlinedefined)
+        end
+    end
+    return format('%s:%d-%d', source, info.linedefined, info.lastlinedefined)
+end
+
+--- Get the fingerprint of a value.
+--- Functions are identified by their source code and tables by the
+--- fingerprints of their fields, so the values that are created again by
+--- reloading the file have the same fingerprint if their definitions are not
+--- changed.
+--- @param v any The value
+--- @param visited table<table, boolean>? The tables already visited
+--- @return string fingerprint
+local function fingerprint(v, visited)
+    local t = type(v)
+    if t == 'function' then
+        return fingerprint_function(v)
+    elseif t == 'string' then
+        return format('%q', v)
+    elseif t ~= 'table' then
+        return tostring(v)
+    end
+
+    visited = visited or {}
+    if visited[v] then
+        return '<cycle>'
+    end
+    visited[v] = true
+
+    local list = {}
+    for k, val in pairs(v) do
+        list[#list + 1] = fingerprint(k, visited) .. '=' ..
+                              fingerprint(val, visited)
+    end
+    sort(list)
+    visited[v] = nil
+    return '{' .. concat(list, ',') .. '}'
+end
+
+--- Get the fingerprint of the source code outside the given functions.
+--- The file-level locals, the shared helpers and the constants that the
+--- functions capture as upvalues are defined outside of them, so a change of
+--- this fingerprint means that any of the functions may behave differently.
+--- Blank lines and comment lines are ignored.
+--- @param fns function[] The functions
+--- @return string fingerprint
+local function fingerprint_outside(fns)
+    -- the line ranges of the functions in each source file
+    local ranges = {}
+    local sources = {}
+    for _, fn in ipairs(fns) do
+        local info = debug_getinfo(fn, 'S')
+        local source = info.source
+        if info.what ~= 'C' and sub(source, 1, 1) == '@' then
+            local skip = ranges[source]
+            if not skip then
+                skip = {}
+                ranges[source] = skip
+                sources[#sources + 1] = source
+            end
+            for i = info.linedefined, info.lastlinedefined do
+                skip[i] = true
+            end
+        end
+    end
+    sort(sources)
+
+    local list = {}
+    for _, source in ipairs(sources) do
+        local skip = ranges[source]
+        list[#list + 1] = source
+        for i, line in ipairs(read_lines(sub(source, 2)) or {}) do
+            if not skip[i] and not find(line, '^%s*$') and
+                not find(line, '^%s*%-%-') then
+                list[#list + 1] = match(line, '^(.-)%s*$')
+            end
+        end
+    end
+    return concat(list, '\n')
+end
+
+--- Forget the cached source lines so that the next fingerprint() reads the
+--- latest source code
+local function clear_cache()
+    for k in pairs(SOURCE_LINES) do
+        SOURCE_LINES[k] = nil
+    end
+end
+
+return {
+    new = new,
+    fingerprint = fingerprint,
+    fingerprint_outside = fingerprint_outside,
+    clear_cache = clear_cache,
+}
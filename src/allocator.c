@@ -0,0 +1,362 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE // for dladdr()
+#endif
+#include <dlfcn.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+/*
+ * Allocators that replace the allocator of the running lua_State.
+ *
+ * The allocator of the lua_State is replaced while the state already holds
+ * the blocks allocated by the original allocator. So the replacement owns two
+ * address ranges reserved at the first use (the arena and the pool), and any
+ * block outside of them is passed back to the original allocator. Switching
+ * the kind only changes where the new blocks come from, so it is safe to
+ * switch at any time.
+ */
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+# define MAP_ANONYMOUS MAP_ANON
+#endif
+#if !defined(MAP_NORESERVE)
+# define MAP_NORESERVE 0
+#endif
+
+// size of the reserved address range of the arena and the pool
+#define REGION_SIZE      ((size_t)1 << 30)
+// alignment of the blocks
+#define BLOCK_ALIGN      16
+// the arena is a list of chunks, and each chunk is reset when all blocks in
+// it are freed
+#define ARENA_CHUNK_SIZE ((size_t)256 * 1024)
+#define ARENA_NCHUNK     (REGION_SIZE / ARENA_CHUNK_SIZE)
+#define ARENA_MAX_BLOCK  (ARENA_CHUNK_SIZE / 4)
+// the pool is a list of pages, and each page is carved into the blocks of a
+// size class
+#define POOL_PAGE_SIZE   ((size_t)64 * 1024)
+#define POOL_NPAGE       (REGION_SIZE / POOL_PAGE_SIZE)
+#define POOL_NCLASS      16
+#define POOL_MAX_BLOCK   (POOL_NCLASS * BLOCK_ALIGN)
+
+enum {
+    KIND_SYSTEM = 0,
+    KIND_ARENA,
+    KIND_POOL,
+};
+
+static const char *const KIND_NAMES[] = {"system", "arena", "pool", NULL};
+
+typedef struct pool_block_t {
+    struct pool_block_t *next;
+} pool_block_t;
+
+typedef struct {
+    // original allocator
+    lua_Alloc f;
+    void *ud;
+    // kind of the allocator for the new blocks
+    int kind;
+
+    // arena
+    char *arena;
+    size_t arena_cur;                    // index of the current chunk
+    size_t arena_top;                    // offset in the current chunk
+    uint32_t arena_live[ARENA_NCHUNK];   // number of live blocks per chunk
+
+    // pool
+    char *pool;
+    size_t pool_npage;                   // number of pages carved
+    uint8_t pool_class[POOL_NPAGE];      // size class of each page
+    char *pool_top[POOL_NCLASS];         // next unused block of the class
+    char *pool_end[POOL_NCLASS];         // end of the current page
+    pool_block_t *pool_free[POOL_NCLASS];
+} measure_alloc_t;
+
+// the allocator is shared by the process, because only the lua_State of the
+// measure command is replaced
+static measure_alloc_t *ALLOC = NULL;
+
+static inline int in_region(const char *base, const void *ptr)
+{
+    return base && (const char *)ptr >= base &&
+           (const char *)ptr < base + REGION_SIZE;
+}
+
+static void *arena_alloc(measure_alloc_t *a, size_t size)
+{
+    size = (size + BLOCK_ALIGN - 1) & ~(size_t)(BLOCK_ALIGN - 1);
+    if (size > ARENA_MAX_BLOCK) {
+        return NULL;
+    }
+
+    if (a->arena_top + size > ARENA_CHUNK_SIZE) {
+        // move to the next empty chunk
+        size_t i = a->arena_cur;
+        do {
+            i = (i + 1) % ARENA_NCHUNK;
+            if (a->arena_live[i] == 0) {
+                a->arena_cur = i;
+                a->arena_top = 0;
+                break;
+            }
+        } while (i != a->arena_cur);
+        if (a->arena_top != 0) {
+            // all chunks are in use
+            return NULL;
+        }
+    }
+
+    void *ptr = a->arena + a->arena_cur * ARENA_CHUNK_SIZE + a->arena_top;
+    a->arena_top += size;
+    a->arena_live[a->arena_cur]++;
+    return ptr;
+}
+
+static void arena_free(measure_alloc_t *a, void *ptr)
+{
+    size_t i = (size_t)((char *)ptr - a->arena) / ARENA_CHUNK_SIZE;
+    if (--a->arena_live[i] == 0 && i == a->arena_cur) {
+        // reset the current chunk
+        a->arena_top = 0;
+    }
+}
+
+static void *pool_alloc(measure_alloc_t *a, size_t size)
+{
+    if (size > POOL_MAX_BLOCK) {
+        return NULL;
+    }
+
+    size_t c = (size - 1) / BLOCK_ALIGN;
+    if (a->pool_free[c]) {
+        pool_block_t *blk = a->pool_free[c];
+        a->pool_free[c]   = blk->next;
+        return blk;
+    }
+
+    size_t bsize = (c + 1) * BLOCK_ALIGN;
+    if (!a->pool_top[c] || a->pool_top[c] + bsize > a->pool_end[c]) {
+        // carve a new page for the class
+        if (a->pool_npage == POOL_NPAGE) {
+            return NULL;
+        }
+        a->pool_class[a->pool_npage] = (uint8_t)c;
+        a->pool_top[c] = a->pool + a->pool_npage * POOL_PAGE_SIZE;
+        a->pool_end[c] = a->pool_top[c] + POOL_PAGE_SIZE;
+        a->pool_npage++;
+    }
+
+    void *ptr = a->pool_top[c];
+    a->pool_top[c] += bsize;
+    return ptr;
+}
+
+static inline size_t pool_class_of(measure_alloc_t *a, void *ptr)
+{
+    return a->pool_class[(size_t)((char *)ptr - a->pool) / POOL_PAGE_SIZE];
+}
+
+static void pool_free(measure_alloc_t *a, void *ptr)
+{
+    pool_block_t *blk = ptr;
+    size_t c          = pool_class_of(a, ptr);
+    blk->next         = a->pool_free[c];
+    a->pool_free[c]   = blk;
+}
+
+static void release(measure_alloc_t *a, void *ptr, size_t osize)
+{
+    if (in_region(a->arena, ptr)) {
+        arena_free(a, ptr);
+    } else if (in_region(a->pool, ptr)) {
+        pool_free(a, ptr);
+    } else {
+        a->f(a->ud, ptr, osize, 0);
+    }
+}
+
+static void *acquire(measure_alloc_t *a, size_t size)
+{
+    void *ptr = NULL;
+
+    switch (a->kind) {
+    case KIND_ARENA:
+        ptr = arena_alloc(a, size);
+        break;
+    case KIND_POOL:
+        ptr = pool_alloc(a, size);
+        break;
+    }
+    // fallback to the original allocator for the large blocks
+    return ptr ? ptr : a->f(a->ud, NULL, 0, size);
+}
+
+static void *alloc_fn(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+    measure_alloc_t *a = (measure_alloc_t *)ud;
+    void *newptr       = NULL;
+
+    if (nsize == 0) {
+        if (ptr) {
+            release(a, ptr, osize);
+        }
+        return NULL;
+    } else if (!ptr) {
+        return acquire(a, nsize);
+    }
+
+    if (in_region(a->arena, ptr)) {
+        if (nsize <= osize) {
+            // shrink in place
+            return ptr;
+        }
+    } else if (in_region(a->pool, ptr)) {
+        if (nsize <= (pool_class_of(a, ptr) + 1) * BLOCK_ALIGN) {
+            // fits in the block of the size class
+            return ptr;
+        }
+    } else if (a->kind == KIND_SYSTEM) {
+        return a->f(a->ud, ptr, osize, nsize);
+    }
+
+    // move the block to the new allocator
+    newptr = acquire(a, nsize);
+    if (!newptr) {
+        if (!in_region(a->arena, ptr) && !in_region(a->pool, ptr)) {
+            return a->f(a->ud, ptr, osize, nsize);
+        }
+        return NULL;
+    }
+    memcpy(newptr, ptr, osize < nsize ? osize : nsize);
+    release(a, ptr, osize);
+    return newptr;
+}
+
+/**
+ * @brief keep this library loaded until the process exits.
+ * lua_close() unloads the C modules before it frees the rest of the state
+ * through the allocator, so the allocator must outlive the module.
+ * @return int 0 on success, -1 on failure.
+ */
+static int pin_library(void)
+{
+    Dl_info info;
+
+    if (!dladdr((void *)alloc_fn, &info) || !info.dli_fname) {
+        return -1;
+    }
+    return dlopen(info.dli_fname, RTLD_NOW | RTLD_NODELETE) ? 0 : -1;
+}
+
+static char *reserve_region(void)
+{
+    void *ptr = mmap(NULL, REGION_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return (ptr == MAP_FAILED) ? NULL : ptr;
+}
+
+static int use_lua(lua_State *L)
+{
+    int kind = luaL_checkoption(L, 1, NULL, KIND_NAMES);
+
+    if (!ALLOC) {
+        void *ud    = NULL;
+        lua_Alloc f = lua_getallocf(L, &ud);
+
+        if (pin_library() != 0) {
+            const char *err = dlerror();
+            lua_pushnil(L);
+            lua_pushfstring(L, "failed to pin the allocator module: %s",
+                            err ? err : "library not found");
+            return 2;
+        }
+        ALLOC = calloc(1, sizeof(measure_alloc_t));
+        if (!ALLOC) {
+            lua_pushnil(L);
+            lua_pushstring(L, strerror(errno));
+            return 2;
+        }
+        ALLOC->f  = f;
+        ALLOC->ud = ud;
+        lua_setallocf(L, alloc_fn, ALLOC);
+        if (lua_getallocf(L, NULL) != alloc_fn) {
+            // e.g. LuaJIT on 64-bit platforms
+            free(ALLOC);
+            ALLOC = NULL;
+            lua_pushnil(L);
+            lua_pushliteral(L,
+                            "the allocator of this runtime cannot be replaced");
+            return 2;
+        }
+    }
+
+    // reserve the address range at the first use
+    if (kind == KIND_ARENA && !ALLOC->arena) {
+        if (!(ALLOC->arena = reserve_region())) {
+            lua_pushnil(L);
+            lua_pushstring(L, strerror(errno));
+            return 2;
+        }
+    } else if (kind == KIND_POOL && !ALLOC->pool) {
+        if (!(ALLOC->pool = reserve_region())) {
+            lua_pushnil(L);
+            lua_pushstring(L, strerror(errno));
+            return 2;
+        }
+    }
+    ALLOC->kind = kind;
+
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int current_lua(lua_State *L)
+{
+    lua_pushstring(L, KIND_NAMES[ALLOC ? ALLOC->kind : KIND_SYSTEM]);
+    return 1;
+}
+
+LUALIB_API int luaopen_measure_allocator(lua_State *L)
+{
+    struct luaL_Reg funcs[] = {
+        {"use",     use_lua    },
+        {"current", current_lua},
+        {NULL,      NULL       }
+    };
+
+    lua_createtable(L, 0, 2);
+    for (struct luaL_Reg *ptr = funcs; ptr->name; ptr++) {
+        lua_pushcfunction(L, ptr->func);
+        lua_setfield(L, -2, ptr->name);
+    }
+    return 1;
+}
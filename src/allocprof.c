@@ -0,0 +1,319 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+/*
+ * Allocation-site profiler.
+ *
+ * The allocator of the lua_State is wrapped to count the blocks and the bytes
+ * allocated, and they are attributed to the Lua source line that was running
+ * at that time. The Lua API cannot be called from the allocator, since the
+ * allocator is also called while the stack is being reallocated, so a line
+ * and return hook keeps track of the current line instead and the allocator
+ * only increments the counters of it. Allocations made by the C functions are
+ * attributed to the Lua line that called them.
+ */
+
+// initial number of buckets of the site table
+#define SITE_NBUCKET 256
+
+typedef struct site_t {
+    struct site_t *next;     // next site in the same bucket
+    char source[LUA_IDSIZE]; // short source of the function
+    int line;                // current line
+    int linedefined;         // line where the function is defined
+    size_t count;            // number of allocations
+    size_t bytes;            // number of bytes allocated
+} site_t;
+
+typedef struct {
+    lua_Alloc f;     // wrapped allocator
+    void *ud;        // user data of the wrapped allocator
+    lua_State *L;    // thread the hook is set to
+    lua_Hook hook;   // hook of the thread before the profile
+    int hookmask;    // mask of the hook before the profile
+    int hookcount;   // count of the hook before the profile
+    site_t *current; // site of the running line
+    site_t **buckets;
+    size_t nbucket;
+    size_t nsite;
+} allocprof_t;
+
+// the running profile (only one profile at a time)
+static allocprof_t *PROF = NULL;
+
+static void *alloc_fn(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+    allocprof_t *p = (allocprof_t *)ud;
+
+    // osize is the type of the object when ptr is NULL
+    if (!ptr) {
+        osize = 0;
+    }
+    if (nsize > osize && p->current) {
+        p->current->count++;
+        p->current->bytes += nsize - osize;
+    }
+    return p->f(p->ud, ptr, osize, nsize);
+}
+
+static uint32_t site_hash(const char *source, int line, int linedefined)
+{
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)source; *c; c++) {
+        h = (h ^ *c) * 16777619u;
+    }
+    h = (h ^ (uint32_t)line) * 16777619u;
+    h = (h ^ (uint32_t)linedefined) * 16777619u;
+    return h;
+}
+
+static int grow_buckets(allocprof_t *p)
+{
+    size_t nbucket   = p->nbucket * 2;
+    site_t **buckets = calloc(nbucket, sizeof(site_t *));
+
+    if (!buckets) {
+        return -1;
+    }
+    for (size_t i = 0; i < p->nbucket; i++) {
+        site_t *s = p->buckets[i];
+        while (s) {
+            site_t *next = s->next;
+            uint32_t h   = site_hash(s->source, s->line, s->linedefined);
+            s->next      = buckets[h % nbucket];
+            buckets[h % nbucket] = s;
+            s                    = next;
+        }
+    }
+    free(p->buckets);
+    p->buckets = buckets;
+    p->nbucket = nbucket;
+    return 0;
+}
+
+/**
+ * @brief get the site of the line, or create it if not found.
+ * @return site_t* the site, or NULL if no memory.
+ */
+static site_t *get_site(allocprof_t *p, const char *source, int line,
+                        int linedefined)
+{
+    uint32_t h = site_hash(source, line, linedefined);
+    site_t *s  = p->buckets[h % p->nbucket];
+
+    for (; s; s = s->next) {
+        if (s->line == line && s->linedefined == linedefined &&
+            strcmp(s->source, source) == 0) {
+            return s;
+        }
+    }
+
+    if (p->nsite >= p->nbucket && grow_buckets(p) == 0) {
+        h = site_hash(source, line, linedefined);
+    }
+    if (!(s = calloc(1, sizeof(site_t)))) {
+        return NULL;
+    }
+    strncpy(s->source, source, sizeof(s->source) - 1);
+    s->line                    = line;
+    s->linedefined             = linedefined;
+    s->next                    = p->buckets[h % p->nbucket];
+    p->buckets[h % p->nbucket] = s;
+    p->nsite++;
+    return s;
+}
+
+/**
+ * @brief set the current site to the innermost Lua function at the level.
+ */
+static void set_current(allocprof_t *p, lua_State *L, int level)
+{
+    lua_Debug ar;
+
+    while (lua_getstack(L, level++, &ar)) {
+        if (lua_getinfo(L, "Sl", &ar) && ar.currentline > 0) {
+            p->current = get_site(p, ar.short_src, ar.currentline,
+                                  ar.linedefined);
+            return;
+        }
+    }
+    p->current = get_site(p, "?", 0, 0);
+}
+
+static void hook_fn(lua_State *L, lua_Debug *ar)
+{
+    allocprof_t *p = PROF;
+
+    if (!p) {
+        return;
+    } else if (ar->event == LUA_HOOKLINE) {
+        // the running function
+        set_current(p, L, 0);
+    } else {
+        // back to the caller of the returning function
+        set_current(p, L, 1);
+    }
+}
+
+static void free_prof(allocprof_t *p)
+{
+    for (size_t i = 0; i < p->nbucket; i++) {
+        site_t *s = p->buckets[i];
+        while (s) {
+            site_t *next = s->next;
+            free(s);
+            s = next;
+        }
+    }
+    free(p->buckets);
+    free(p);
+}
+
+static int start_lua(lua_State *L)
+{
+    allocprof_t *p = NULL;
+
+    if (PROF) {
+        lua_pushnil(L);
+        lua_pushliteral(L, "the profiler is already running");
+        return 2;
+    } else if (!(p = calloc(1, sizeof(allocprof_t))) ||
+               !(p->buckets = calloc(SITE_NBUCKET, sizeof(site_t *)))) {
+        free(p);
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    p->nbucket = SITE_NBUCKET;
+    p->L       = L;
+    p->f       = lua_getallocf(L, &p->ud);
+
+    lua_setallocf(L, alloc_fn, p);
+    if (lua_getallocf(L, NULL) != alloc_fn) {
+        // e.g. LuaJIT on 64-bit platforms
+        free_prof(p);
+        lua_pushnil(L);
+        lua_pushliteral(L, "the allocator of this runtime cannot be replaced");
+        return 2;
+    }
+    PROF = p;
+    // attribute the allocations to the caller until the next line
+    set_current(p, L, 1);
+    p->hook      = lua_gethook(L);
+    p->hookmask  = lua_gethookmask(L);
+    p->hookcount = lua_gethookcount(L);
+    lua_sethook(L, hook_fn, LUA_MASKLINE | LUA_MASKRET, 0);
+
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int cmp_site(const void *a, const void *b)
+{
+    const site_t *x = *(const site_t *const *)a;
+    const site_t *y = *(const site_t *const *)b;
+
+    if (x->bytes != y->bytes) {
+        return x->bytes > y->bytes ? -1 : 1;
+    } else if (x->count != y->count) {
+        return x->count > y->count ? -1 : 1;
+    }
+    return 0;
+}
+
+static int stop_lua(lua_State *L)
+{
+    allocprof_t *p = PROF;
+    site_t **list  = NULL;
+    size_t n       = 0;
+
+    if (!p) {
+        lua_pushnil(L);
+        lua_pushliteral(L, "the profiler is not running");
+        return 2;
+    }
+    // stop counting before the result is created
+    lua_sethook(p->L, p->hook, p->hookmask, p->hookcount);
+    lua_setallocf(L, p->f, p->ud);
+    PROF = NULL;
+
+    // sort the sites in descending order of the bytes
+    if (p->nsite && !(list = malloc(sizeof(site_t *) * p->nsite))) {
+        free_prof(p);
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    for (size_t i = 0; i < p->nbucket; i++) {
+        for (site_t *s = p->buckets[i]; s; s = s->next) {
+            if (s->count) {
+                list[n++] = s;
+            }
+        }
+    }
+    qsort(list, n, sizeof(site_t *), cmp_site);
+
+    lua_createtable(L, (int)n, 0);
+    for (size_t i = 0; i < n; i++) {
+        lua_createtable(L, 0, 5);
+        lua_pushstring(L, list[i]->source);
+        lua_setfield(L, -2, "source");
+        lua_pushinteger(L, list[i]->line);
+        lua_setfield(L, -2, "line");
+        lua_pushinteger(L, list[i]->linedefined);
+        lua_setfield(L, -2, "linedefined");
+        lua_pushinteger(L, (lua_Integer)list[i]->count);
+        lua_setfield(L, -2, "count");
+        lua_pushinteger(L, (lua_Integer)list[i]->bytes);
+        lua_setfield(L, -2, "bytes");
+        lua_rawseti(L, -2, (int)i + 1);
+    }
+    free(list);
+    free_prof(p);
+    return 1;
+}
+
+LUALIB_API int luaopen_measure_allocprof(lua_State *L)
+{
+    struct luaL_Reg funcs[] = {
+        {"start", start_lua},
+        {"stop",  stop_lua },
+        {NULL,    NULL     }
+    };
+
+    lua_createtable(L, 0, 2);
+    for (struct luaL_Reg *ptr = funcs; ptr->name; ptr++) {
+        lua_pushcfunction(L, ptr->func);
+        lua_setfield(L, -2, ptr->name);
+    }
+    return 1;
+}
@@ -0,0 +1,131 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+// measure headers
+#include "measure.h"
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+// a round that takes longer than this ratio to the median is a spike
+#define SPIKE_RATIO 10.0
+
+#define DEFAULT_ROUNDS 1000
+#define DEFAULT_WORK   10000
+
+// Fixed amount of CPU work that the compiler cannot optimize away.
+static inline void do_work(lua_Integer work)
+{
+    volatile uint64_t x = 88172645463325252ULL;
+    for (lua_Integer i = 0; i < work; i++) {
+        // xorshift64
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+}
+
+static int cmp_uint64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int calibrate_lua(lua_State *L)
+{
+    lua_Integer rounds = luaL_optinteger(L, 1, DEFAULT_ROUNDS);
+    lua_Integer work   = luaL_optinteger(L, 2, DEFAULT_WORK);
+    uint64_t *data     = NULL;
+    double mean        = 0;
+    double m2          = 0;
+    double median      = 0;
+    lua_Integer spikes = 0;
+
+    luaL_argcheck(L, rounds >= 10, 1, "rounds must be at least 10");
+    luaL_argcheck(L, work > 0, 2, "work must be greater than 0");
+    data = lua_newuserdata(L, sizeof(uint64_t) * (size_t)rounds);
+
+    // warm up the caches and the CPU frequency before measuring
+    for (lua_Integer i = 0; i < rounds / 10; i++) {
+        do_work(work);
+    }
+
+    for (lua_Integer i = 0; i < rounds; i++) {
+        uint64_t t = measure_getnsec();
+        do_work(work);
+        data[i] = measure_getnsec() - t;
+    }
+
+    // mean and variance with Welford's algorithm
+    for (lua_Integer i = 0; i < rounds; i++) {
+        double x     = (double)data[i];
+        double delta = x - mean;
+        mean += delta / (double)(i + 1);
+        m2 += delta * (x - mean);
+    }
+
+    qsort(data, (size_t)rounds, sizeof(uint64_t), cmp_uint64);
+    if (rounds % 2) {
+        median = (double)data[rounds / 2];
+    } else {
+        median = ((double)data[rounds / 2 - 1] + (double)data[rounds / 2]) / 2;
+    }
+    for (lua_Integer i = rounds - 1; i >= 0; i--) {
+        if ((double)data[i] <= median * SPIKE_RATIO) {
+            break;
+        }
+        spikes++;
+    }
+
+    lua_createtable(L, 0, 8);
+    lua_pushinteger(L, rounds);
+    lua_setfield(L, -2, "rounds");
+    lua_pushnumber(L, mean);
+    lua_setfield(L, -2, "mean");
+    lua_pushnumber(L, median);
+    lua_setfield(L, -2, "median");
+    lua_pushnumber(L, (double)data[0]);
+    lua_setfield(L, -2, "min");
+    lua_pushnumber(L, (double)data[rounds - 1]);
+    lua_setfield(L, -2, "max");
+    lua_pushnumber(L, sqrt(m2 / (double)(rounds - 1)));
+    lua_setfield(L, -2, "stddev");
+    // coefficient of variation in percentage
+    lua_pushnumber(L, mean > 0 ? sqrt(m2 / (double)(rounds - 1)) / mean * 100 :
+                                 0);
+    lua_setfield(L, -2, "cv");
+    // frequency of the spikes in percentage
+    lua_pushnumber(L, (double)spikes / (double)rounds * 100);
+    lua_setfield(L, -2, "spike_rate");
+    return 1;
+}
+
+LUALIB_API int luaopen_measure_calibrate(lua_State *L)
+{
+    lua_pushcfunction(L, calibrate_lua);
+    return 1;
+}
@@ -0,0 +1,330 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+/*
+ * Sampling CPU profiler.
+ *
+ * ITIMER_PROF sends SIGPROF every interval of the CPU time of the process.
+ * The Lua API cannot be called from the signal handler, except lua_sethook(),
+ * so the handler sets a count hook that fires at the next instruction, and
+ * the hook records the Lua call stack there. The samples are the folded
+ * stacks, the frames from the root to the leaf joined by ';', that are
+ * counted in a hash table.
+ */
+
+// maximum number of frames of a stack
+#define MAX_DEPTH     64
+// maximum length of a frame name
+#define MAX_FRAME     128
+// initial number of buckets of the stack table
+#define STACK_NBUCKET 256
+
+typedef struct folded_t {
+    struct folded_t *next; // next stack in the same bucket
+    size_t count;          // number of samples
+    char key[];            // folded stack
+} folded_t;
+
+typedef struct {
+    lua_State *L;        // thread the hook is set to
+    lua_Hook hook;       // hook of the thread before the profile
+    int hookmask;        // mask of the hook before the profile
+    int hookcount;       // count of the hook before the profile
+    struct sigaction sa; // SIGPROF action before the profile
+    folded_t **buckets;
+    size_t nbucket;
+    size_t nstack;
+    size_t nsample;      // number of samples recorded
+    size_t ndropped;     // number of samples dropped by no memory
+} cpuprof_t;
+
+// the running profile (only one profile at a time)
+static cpuprof_t *PROF = NULL;
+
+static uint32_t stack_hash(const char *key)
+{
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)key; *c; c++) {
+        h = (h ^ *c) * 16777619u;
+    }
+    return h;
+}
+
+static void grow_buckets(cpuprof_t *p)
+{
+    size_t nbucket     = p->nbucket * 2;
+    folded_t **buckets = calloc(nbucket, sizeof(folded_t *));
+
+    if (!buckets) {
+        return;
+    }
+    for (size_t i = 0; i < p->nbucket; i++) {
+        folded_t *s = p->buckets[i];
+        while (s) {
+            folded_t *next = s->next;
+            uint32_t h     = stack_hash(s->key) % nbucket;
+            s->next        = buckets[h];
+            buckets[h]     = s;
+            s              = next;
+        }
+    }
+    free(p->buckets);
+    p->buckets = buckets;
+    p->nbucket = nbucket;
+}
+
+static void add_stack(cpuprof_t *p, const char *key, size_t len)
+{
+    uint32_t h  = stack_hash(key);
+    folded_t *s = p->buckets[h % p->nbucket];
+
+    for (; s; s = s->next) {
+        if (strcmp(s->key, key) == 0) {
+            s->count++;
+            p->nsample++;
+            return;
+        }
+    }
+
+    if (p->nstack >= p->nbucket) {
+        grow_buckets(p);
+    }
+    if (!(s = malloc(sizeof(folded_t) + len + 1))) {
+        p->ndropped++;
+        return;
+    }
+    memcpy(s->key, key, len + 1);
+    s->count                   = 1;
+    s->next                    = p->buckets[h % p->nbucket];
+    p->buckets[h % p->nbucket] = s;
+    p->nstack++;
+    p->nsample++;
+}
+
+/**
+ * @brief get the name of the frame at the level.
+ * Lua functions are named by the function name and the line of the
+ * definition, and C functions by the function name.
+ */
+static int frame_name(lua_State *L, lua_Debug *ar, char *buf)
+{
+    const char *name = NULL;
+
+    if (!lua_getinfo(L, "Sn", ar)) {
+        return snprintf(buf, MAX_FRAME, "?");
+    }
+    name = ar->name ? ar->name : "?";
+    if (*ar->what == 'C') {
+        return snprintf(buf, MAX_FRAME, "%s [C]", name);
+    } else if (*ar->what == 'm') {
+        return snprintf(buf, MAX_FRAME, "main %s", ar->short_src);
+    }
+    return snprintf(buf, MAX_FRAME, "%s %s:%d", name, ar->short_src,
+                    ar->linedefined);
+}
+
+static void hook_fn(lua_State *L, lua_Debug *ar)
+{
+    cpuprof_t *p = PROF;
+    char frames[MAX_DEPTH][MAX_FRAME];
+    char key[MAX_DEPTH * MAX_FRAME];
+    size_t len = 0;
+    int depth  = 0;
+
+    if (!p) {
+        return;
+    }
+    // disarm until the next signal
+    lua_sethook(L, p->hook, p->hookmask, p->hookcount);
+
+    while (depth < MAX_DEPTH && lua_getstack(L, depth, ar)) {
+        int n = frame_name(L, ar, frames[depth]);
+        if (n < 0) {
+            frames[depth][0] = '\0';
+        }
+        // ';' separates the frames in the folded stack
+        for (char *c = frames[depth]; *c; c++) {
+            if (*c == ';') {
+                *c = ':';
+            }
+        }
+        depth++;
+    }
+
+    // fold the stack from the root to the leaf
+    while (depth-- > 0) {
+        size_t n = strlen(frames[depth]);
+        if (len) {
+            key[len++] = ';';
+        }
+        memcpy(key + len, frames[depth], n);
+        len += n;
+    }
+    key[len] = '\0';
+    add_stack(p, key, len);
+}
+
+static void signal_fn(int sig)
+{
+    cpuprof_t *p = PROF;
+
+    (void)sig;
+    if (p) {
+        // lua_sethook() is the only function that is safe in the handler
+        lua_sethook(p->L, hook_fn, LUA_MASKCOUNT, 1);
+    }
+}
+
+static void free_prof(cpuprof_t *p)
+{
+    for (size_t i = 0; i < p->nbucket; i++) {
+        folded_t *s = p->buckets[i];
+        while (s) {
+            folded_t *next = s->next;
+            free(s);
+            s = next;
+        }
+    }
+    free(p->buckets);
+    free(p);
+}
+
+static int start_lua(lua_State *L)
+{
+    lua_Integer interval = luaL_optinteger(L, 1, 1000);
+    struct itimerval tv  = {0};
+    struct sigaction sa  = {0};
+    cpuprof_t *p         = NULL;
+
+    luaL_argcheck(L, interval > 0 && interval < 1000000, 1,
+                  "interval must be in 1-999999 microseconds");
+    if (PROF) {
+        lua_pushnil(L);
+        lua_pushliteral(L, "the profiler is already running");
+        return 2;
+    } else if (!(p = calloc(1, sizeof(cpuprof_t))) ||
+               !(p->buckets = calloc(STACK_NBUCKET, sizeof(folded_t *)))) {
+        free(p);
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    p->nbucket   = STACK_NBUCKET;
+    p->L         = L;
+    p->hook      = lua_gethook(L);
+    p->hookmask  = lua_gethookmask(L);
+    p->hookcount = lua_gethookcount(L);
+
+    sa.sa_handler = signal_fn;
+    sa.sa_flags   = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGPROF, &sa, &p->sa) != 0) {
+        free_prof(p);
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    PROF                   = p;
+    tv.it_interval.tv_sec  = 0;
+    tv.it_interval.tv_usec = (suseconds_t)interval;
+    tv.it_value            = tv.it_interval;
+    if (setitimer(ITIMER_PROF, &tv, NULL) != 0) {
+        int err = errno;
+        PROF    = NULL;
+        sigaction(SIGPROF, &p->sa, NULL);
+        free_prof(p);
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(err));
+        return 2;
+    }
+
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int stop_lua(lua_State *L)
+{
+    cpuprof_t *p        = PROF;
+    struct itimerval tv = {0};
+    int idx             = 0;
+
+    if (!p) {
+        lua_pushnil(L);
+        lua_pushliteral(L, "the profiler is not running");
+        return 2;
+    }
+    // stop the timer before the handler is restored, so that no SIGPROF is
+    // delivered to the default action that terminates the process
+    setitimer(ITIMER_PROF, &tv, NULL);
+    PROF = NULL;
+    sigaction(SIGPROF, &p->sa, NULL);
+    lua_sethook(p->L, p->hook, p->hookmask, p->hookcount);
+
+    lua_createtable(L, 0, 3);
+    lua_createtable(L, (int)p->nstack, 0);
+    for (size_t i = 0; i < p->nbucket; i++) {
+        for (folded_t *s = p->buckets[i]; s; s = s->next) {
+            lua_createtable(L, 0, 2);
+            lua_pushstring(L, s->key);
+            lua_setfield(L, -2, "stack");
+            lua_pushinteger(L, (lua_Integer)s->count);
+            lua_setfield(L, -2, "count");
+            lua_rawseti(L, -2, ++idx);
+        }
+    }
+    lua_setfield(L, -2, "stacks");
+    lua_pushinteger(L, (lua_Integer)p->nsample);
+    lua_setfield(L, -2, "samples");
+    lua_pushinteger(L, (lua_Integer)p->ndropped);
+    lua_setfield(L, -2, "dropped");
+    free_prof(p);
+    return 1;
+}
+
+LUALIB_API int luaopen_measure_cpuprof(lua_State *L)
+{
+    struct luaL_Reg funcs[] = {
+        {"start", start_lua},
+        {"stop",  stop_lua },
+        {NULL,    NULL     }
+    };
+
+    lua_createtable(L, 0, 2);
+    for (struct luaL_Reg *ptr = funcs; ptr->name; ptr++) {
+        lua_pushcfunction(L, ptr->func);
+        lua_setfield(L, -2, ptr->name);
+    }
+    return 1;
+}
@@ -0,0 +1,157 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+#ifndef LUA_OK
+# define LUA_OK 0
+#endif
+
+static int write_all(int fd, const char *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Run in the child process: call the function and write the result string or
+// the error message to the pipe, then exit without returning to the caller.
+static void run_child(lua_State *L, int fd, int nargs)
+{
+    int status      = 0;
+    const char *str = NULL;
+    size_t len      = 0;
+
+    if (lua_pcall(L, nargs, 1, 0) != LUA_OK) {
+        status = 1;
+    } else if (lua_type(L, -1) != LUA_TSTRING) {
+        status = 1;
+        lua_pushfstring(L, "function must return a string, got %s",
+                        luaL_typename(L, -1));
+    }
+    str = lua_tolstring(L, -1, &len);
+    if (!str) {
+        str = "(error object is not a string)";
+        len = strlen(str);
+    }
+    if (write_all(fd, str, len) == -1) {
+        status = 2;
+    }
+    close(fd);
+    // flush the outputs of the child process, but do not run the exit
+    // handlers and the finalizers that belong to the parent process
+    fflush(NULL);
+    _exit(status);
+}
+
+static int forkrun_lua(lua_State *L)
+{
+    int nargs      = lua_gettop(L) - 1;
+    int fds[2]     = {-1, -1};
+    int status     = 0;
+    pid_t pid      = 0;
+    luaL_Buffer b;
+
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    if (pipe(fds) == -1) {
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+    // flush the buffered outputs to prevent them from being written twice
+    fflush(NULL);
+    pid = fork();
+    if (pid == -1) {
+        int err = errno;
+        close(fds[0]);
+        close(fds[1]);
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(err));
+        return 2;
+    } else if (pid == 0) {
+        close(fds[0]);
+        run_child(L, fds[1], nargs);
+    }
+
+    // read the result of the child process
+    close(fds[1]);
+    luaL_buffinit(L, &b);
+    for (;;) {
+        char *buf = luaL_prepbuffer(&b);
+        ssize_t n = read(fds[0], buf, LUAL_BUFFERSIZE);
+        if (n > 0) {
+            luaL_addsize(&b, (size_t)n);
+        } else if (n == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    close(fds[0]);
+    luaL_pushresult(&b);
+
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) {
+            lua_pushnil(L);
+            lua_pushstring(L, strerror(errno));
+            return 2;
+        }
+    }
+
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        return 1;
+    } else if (WIFSIGNALED(status)) {
+        lua_pushnil(L);
+        lua_pushfstring(L, "child process was killed by signal %d",
+                        WTERMSIG(status));
+        return 2;
+    }
+    lua_pushnil(L);
+    lua_pushfstring(L, "child process failed: %s", lua_tostring(L, -2));
+    return 2;
+}
+
+LUALIB_API int luaopen_measure_forkrun(lua_State *L)
+{
+    lua_pushcfunction(L, forkrun_lua);
+    return 1;
+}
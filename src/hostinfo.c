@@ -0,0 +1,313 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+#if defined(__linux__)
+
+# define SYSFS_CPU "/sys/devices/system/cpu"
+
+// Read the first line of a small file such as /proc and sysfs entries.
+// Returns the length of the line without the trailing newline, or -1.
+static ssize_t read_line(const char *pathname, char *buf, size_t size)
+{
+    FILE *fp  = fopen(pathname, "r");
+    ssize_t n = -1;
+
+    if (fp) {
+        if (fgets(buf, (int)size, fp)) {
+            n = (ssize_t)strcspn(buf, "\n");
+            buf[n] = 0;
+        }
+        fclose(fp);
+    }
+    return n;
+}
+
+// Get the value part of the "key : value" line in /proc/cpuinfo
+static const char *cpuinfo_value(const char *line, const char *key)
+{
+    size_t len = strlen(key);
+
+    if (strncmp(line, key, len) != 0 ||
+        (line[len] != ' ' && line[len] != '\t' && line[len] != ':')) {
+        return NULL;
+    }
+    line = strchr(line + len, ':');
+    if (!line) {
+        return NULL;
+    }
+    line += strspn(line + 1, " \t") + 1;
+    return line;
+}
+
+static void push_cpuinfo(lua_State *L)
+{
+    FILE *fp      = fopen("/proc/cpuinfo", "r");
+    char line[1024];
+    int threads   = 0;
+    int ncores    = 0;
+    long phys     = 0;
+    long cores[1024][2];
+    const char *v = NULL;
+
+    lua_createtable(L, 0, 4);
+    if (!fp) {
+        return;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\n")] = 0;
+        if (cpuinfo_value(line, "processor")) {
+            threads++;
+            phys = 0;
+        } else if ((v = cpuinfo_value(line, "model name")) && threads == 1) {
+            lua_pushstring(L, v);
+            lua_setfield(L, -2, "model");
+        } else if ((v = cpuinfo_value(line, "cpu MHz")) && threads == 1) {
+            lua_pushnumber(L, strtod(v, NULL));
+            lua_setfield(L, -2, "mhz");
+        } else if ((v = cpuinfo_value(line, "physical id"))) {
+            phys = strtol(v, NULL, 10);
+        } else if ((v = cpuinfo_value(line, "core id"))) {
+            // count the unique pairs of the physical id and core id
+            long core = strtol(v, NULL, 10);
+            int found = 0;
+            for (int i = 0; i < ncores && !found; i++) {
+                found = cores[i][0] == phys && cores[i][1] == core;
+            }
+            if (!found && ncores < (int)(sizeof(cores) / sizeof(cores[0]))) {
+                cores[ncores][0] = phys;
+                cores[ncores][1] = core;
+                ncores++;
+            }
+        }
+    }
+    fclose(fp);
+
+    lua_pushinteger(L, threads);
+    lua_setfield(L, -2, "threads");
+    // no core id field in some architectures and virtual machines
+    lua_pushinteger(L, ncores > 0 ? ncores : threads);
+    lua_setfield(L, -2, "cores");
+}
+
+// Push the size and the level of the last-level cache of cpu0 to the table on
+// the top of the stack, which is the largest data or unified cache
+static void push_llc(lua_State *L)
+{
+    char pathname[256];
+    char buf[64];
+    long size_kb = 0;
+    long level   = 0;
+
+    for (int i = 0;; i++) {
+        long lv = 0;
+        long kb = 0;
+        char *end;
+
+        snprintf(pathname, sizeof(pathname), SYSFS_CPU "/cpu0/cache/index%d/type",
+                 i);
+        if (read_line(pathname, buf, sizeof(buf)) < 0) {
+            break;
+        } else if (strcmp(buf, "Instruction") == 0) {
+            continue;
+        }
+        snprintf(pathname, sizeof(pathname),
+                 SYSFS_CPU "/cpu0/cache/index%d/level", i);
+        if (read_line(pathname, buf, sizeof(buf)) > 0) {
+            lv = strtol(buf, NULL, 10);
+        }
+        snprintf(pathname, sizeof(pathname),
+                 SYSFS_CPU "/cpu0/cache/index%d/size", i);
+        if (read_line(pathname, buf, sizeof(buf)) > 0) {
+            // e.g. "32K" or "16M"
+            kb = strtol(buf, &end, 10);
+            if (*end == 'M') {
+                kb *= 1024;
+            } else if (*end != 'K') {
+                kb /= 1024;
+            }
+        }
+        if (lv > level || (lv == level && kb > size_kb)) {
+            level   = lv;
+            size_kb = kb;
+        }
+    }
+
+    if (size_kb > 0) {
+        lua_pushinteger(L, size_kb);
+        lua_setfield(L, -2, "llc_kb");
+        lua_pushinteger(L, level);
+        lua_setfield(L, -2, "llc_level");
+    }
+}
+
+static void push_meminfo(lua_State *L)
+{
+    FILE *fp = fopen("/proc/meminfo", "r");
+    char line[256];
+    long long kb = 0;
+
+    lua_createtable(L, 0, 2);
+    if (!fp) {
+        return;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "MemTotal: %lld kB", &kb) == 1) {
+            lua_pushinteger(L, (lua_Integer)kb);
+            lua_setfield(L, -2, "total_kb");
+        } else if (sscanf(line, "MemAvailable: %lld kB", &kb) == 1) {
+            lua_pushinteger(L, (lua_Integer)kb);
+            lua_setfield(L, -2, "available_kb");
+        }
+    }
+    fclose(fp);
+}
+
+// Push the distinct scaling governors of the online CPUs joined with comma.
+static void push_governor(lua_State *L, long ncpu)
+{
+    char pathname[128];
+    char buf[64];
+    char list[256] = {0};
+    size_t len     = 0;
+
+    for (long i = 0; i < ncpu; i++) {
+        snprintf(pathname, sizeof(pathname),
+                 SYSFS_CPU "/cpu%ld/cpufreq/scaling_governor", i);
+        if (read_line(pathname, buf, sizeof(buf)) > 0) {
+            // check whether the governor is already listed
+            const char *p = list;
+            size_t n      = strlen(buf);
+            int found     = 0;
+            while (!found && (p = strstr(p, buf))) {
+                found = (p == list || p[-1] == ',') &&
+                        (p[n] == 0 || p[n] == ',');
+                p += n;
+            }
+            if (!found && len + n + 2 < sizeof(list)) {
+                len += snprintf(list + len, sizeof(list) - len, "%s%s",
+                                len ? "," : "", buf);
+            }
+        }
+    }
+
+    if (len > 0) {
+        lua_pushstring(L, list);
+        lua_setfield(L, -2, "governor");
+    }
+}
+
+// Push whether the turbo boost (Intel) or the frequency boost (AMD and
+// acpi-cpufreq) is enabled.
+static void push_boost(lua_State *L)
+{
+    char buf[16];
+
+    if (read_line(SYSFS_CPU "/intel_pstate/no_turbo", buf, sizeof(buf)) > 0) {
+        lua_pushboolean(L, buf[0] == '0');
+        lua_setfield(L, -2, "boost");
+    } else if (read_line(SYSFS_CPU "/cpufreq/boost", buf, sizeof(buf)) > 0) {
+        lua_pushboolean(L, buf[0] == '1');
+        lua_setfield(L, -2, "boost");
+    }
+}
+
+static void push_smt(lua_State *L)
+{
+    char buf[32];
+
+    if (read_line(SYSFS_CPU "/smt/control", buf, sizeof(buf)) > 0) {
+        lua_pushstring(L, buf);
+        lua_setfield(L, -2, "smt");
+    }
+    if (read_line(SYSFS_CPU "/smt/active", buf, sizeof(buf)) > 0) {
+        lua_pushboolean(L, buf[0] == '1');
+        lua_setfield(L, -2, "smt_active");
+    }
+}
+
+static void push_loadavg(lua_State *L)
+{
+    double loadavg[3] = {0};
+    int n             = getloadavg(loadavg, 3);
+
+    if (n > 0) {
+        lua_createtable(L, n, 0);
+        for (int i = 0; i < n; i++) {
+            lua_pushnumber(L, loadavg[i]);
+            lua_rawseti(L, -2, i + 1);
+        }
+        lua_setfield(L, -2, "loadavg");
+    }
+}
+
+static int hostinfo_lua(lua_State *L)
+{
+    long ncpu = sysconf(_SC_NPROCESSORS_CONF);
+    char buf[256];
+
+    lua_createtable(L, 0, 10);
+    push_cpuinfo(L);
+    push_llc(L);
+    lua_setfield(L, -2, "cpu");
+    push_meminfo(L);
+    lua_setfield(L, -2, "memory");
+
+    lua_pushinteger(L, sysconf(_SC_NPROCESSORS_ONLN));
+    lua_setfield(L, -2, "online");
+    push_governor(L, ncpu);
+    push_boost(L);
+    push_smt(L);
+    if (read_line(SYSFS_CPU "/isolated", buf, sizeof(buf)) >= 0) {
+        lua_pushstring(L, buf);
+        lua_setfield(L, -2, "isolated");
+    }
+    push_loadavg(L);
+    return 1;
+}
+
+#else
+
+static int hostinfo_lua(lua_State *L)
+{
+    lua_pushnil(L);
+    lua_pushliteral(L, "hostinfo is not supported on this platform");
+    return 2;
+}
+
+#endif
+
+LUALIB_API int luaopen_measure_hostinfo(lua_State *L)
+{
+    lua_pushcfunction(L, hostinfo_lua);
+    return 1;
+}
@@ -0,0 +1,248 @@
+/**
+ *  Copyright (C) 2025 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+#define MEASURE_INOTIFY_MT "measure.inotify"
+
+#if defined(__linux__)
+# include <poll.h>
+# include <sys/inotify.h>
+
+// Events that indicate a file in a watched directory may have new content.
+// Directories are watched instead of the files themselves, because editors
+// commonly save files by writing a temporary file and renaming it over the
+// original, which would silently drop a watch on the original inode.
+# define WATCH_MASK                                                            \
+     (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM |   \
+      IN_DELETE_SELF | IN_MOVE_SELF)
+
+typedef struct {
+    int fd;
+} measure_inotify_t;
+
+static const char *event_name(uint32_t mask)
+{
+    if (mask & IN_Q_OVERFLOW) {
+        return "overflow";
+    } else if (mask & IN_IGNORED) {
+        return "ignored";
+    } else if (mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+        return "gone";
+    } else if (mask & (IN_DELETE | IN_MOVED_FROM)) {
+        return "delete";
+    } else if (mask & IN_CREATE) {
+        return "create";
+    }
+    // IN_CLOSE_WRITE | IN_MOVED_TO
+    return "modify";
+}
+
+static int read_lua(lua_State *L)
+{
+    measure_inotify_t *w = luaL_checkudata(L, 1, MEASURE_INOTIFY_MT);
+    lua_Number timeout   = luaL_optnumber(L, 2, -1);
+    struct pollfd pfd    = {.fd = w->fd, .events = POLLIN};
+    char buf[sizeof(struct inotify_event) * 64 + 4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t len = 0;
+    int rc      = 0;
+
+    if (w->fd < 0) {
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(EBADF));
+        return 2;
+    }
+
+    // wait for events
+    rc = poll(&pfd, 1, (timeout < 0) ? -1 : (int)(timeout * 1000));
+    if (rc == 0) {
+        // timed out
+        lua_createtable(L, 0, 0);
+        return 1;
+    } else if (rc == -1) {
+        if (errno == EINTR) {
+            // interrupted by a signal such as SIGCHLD or SIGWINCH
+            lua_createtable(L, 0, 0);
+            return 1;
+        }
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+
+    len = read(w->fd, buf, sizeof(buf));
+    if (len == -1) {
+        if (errno == EAGAIN || errno == EINTR) {
+            lua_createtable(L, 0, 0);
+            return 1;
+        }
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+
+    // convert events to the list of tables
+    lua_createtable(L, 8, 0);
+    int idx = 0;
+    for (char *ptr = buf; ptr < buf + len;) {
+        const struct inotify_event *ev = (const struct inotify_event *)ptr;
+
+        lua_createtable(L, 0, 3);
+        lua_pushinteger(L, ev->wd);
+        lua_setfield(L, -2, "wd");
+        lua_pushstring(L, event_name(ev->mask));
+        lua_setfield(L, -2, "event");
+        if (ev->len > 0) {
+            lua_pushstring(L, ev->name);
+            lua_setfield(L, -2, "name");
+        }
+        lua_rawseti(L, -2, ++idx);
+        ptr += sizeof(struct inotify_event) + ev->len;
+    }
+    return 1;
+}
+
+static int unwatch_lua(lua_State *L)
+{
+    measure_inotify_t *w = luaL_checkudata(L, 1, MEASURE_INOTIFY_MT);
+    lua_Integer wd       = luaL_checkinteger(L, 2);
+
+    if (inotify_rm_watch(w->fd, (int)wd) == -1) {
+        lua_pushboolean(L, 0);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int watch_lua(lua_State *L)
+{
+    measure_inotify_t *w = luaL_checkudata(L, 1, MEASURE_INOTIFY_MT);
+    const char *pathname = luaL_checkstring(L, 2);
+    int wd               = inotify_add_watch(w->fd, pathname, WATCH_MASK);
+
+    if (wd == -1) {
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        lua_pushinteger(L, errno);
+        return 3;
+    }
+    lua_pushinteger(L, wd);
+    return 1;
+}
+
+static int close_lua(lua_State *L)
+{
+    measure_inotify_t *w = luaL_checkudata(L, 1, MEASURE_INOTIFY_MT);
+    if (w->fd != -1) {
+        close(w->fd);
+        w->fd = -1;
+    }
+    return 0;
+}
+
+static int tostring_lua(lua_State *L)
+{
+    lua_pushfstring(L, MEASURE_INOTIFY_MT ": %p", lua_touserdata(L, 1));
+    return 1;
+}
+
+static int new_lua(lua_State *L)
+{
+    measure_inotify_t *w = lua_newuserdata(L, sizeof(measure_inotify_t));
+
+    w->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (w->fd == -1) {
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    luaL_getmetatable(L, MEASURE_INOTIFY_MT);
+    lua_setmetatable(L, -2);
+    return 1;
+}
+
+LUALIB_API int luaopen_measure_inotify(lua_State *L)
+{
+    // create metatable
+    if (luaL_newmetatable(L, MEASURE_INOTIFY_MT)) {
+        struct luaL_Reg mmethod[] = {
+            {"__gc",       close_lua   },
+            {"__tostring", tostring_lua},
+            {NULL,         NULL        }
+        };
+        struct luaL_Reg method[] = {
+            {"watch",   watch_lua  },
+            {"unwatch", unwatch_lua},
+            {"read",    read_lua   },
+            {"close",   close_lua  },
+            {NULL,      NULL       }
+        };
+
+        // metamethods
+        for (struct luaL_Reg *ptr = mmethod; ptr->name; ptr++) {
+            lua_pushcfunction(L, ptr->func);
+            lua_setfield(L, -2, ptr->name);
+        }
+        // methods
+        lua_createtable(L, 0, 4);
+        for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
+            lua_pushcfunction(L, ptr->func);
+            lua_setfield(L, -2, ptr->name);
+        }
+        lua_setfield(L, -2, "__index");
+
+        // Protect metatable from external access
+        lua_pushliteral(L, "metatable is protected");
+        lua_setfield(L, -2, "__metatable");
+
+        lua_pop(L, 1);
+    }
+
+    lua_pushcfunction(L, new_lua);
+    return 1;
+}
+
+#else
+
+static int new_lua(lua_State *L)
+{
+    lua_pushnil(L);
+    lua_pushliteral(L, "inotify is not supported on this platform");
+    return 2;
+}
+
+LUALIB_API int luaopen_measure_inotify(lua_State *L)
+{
+    lua_pushcfunction(L, new_lua);
+    return 1;
+}
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <string.h>
+// measure headers
+#include "measure.h"
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+#include <lualib.h>
+
+#ifndef LUA_OK
+# define LUA_OK 0
+#endif
+
+/**
+ * @brief get the heap size of the Lua state in KB.
+ * @param collect perform a full GC before getting the size if non-zero.
+ */
+static lua_Integer get_heap_kb(lua_State *L, int collect)
+{
+    if (collect) {
+        lua_gc(L, LUA_GCCOLLECT, 0);
+    }
+    return (lua_Integer)lua_gc(L, LUA_GCCOUNT, 0);
+}
+
+static void set_path(lua_State *L, const char *field, const char *path)
+{
+    if (path) {
+        lua_getglobal(L, "package");
+        lua_pushstring(L, path);
+        lua_setfield(L, -2, field);
+        lua_pop(L, 1);
+    }
+}
+
+/**
+ * Measure the cost of require() of the module in a new Lua state.
+ * The cost of the C libraries that are already loaded into the current
+ * process is not included, so call this function in a fresh process.
+ */
+static int measure_require(lua_State *L, lua_State *NL, const char *modname)
+{
+    lua_Integer before_kb = 0;
+    lua_Integer after_kb  = 0;
+    long rss_kb           = 0;
+    uint64_t ns           = 0;
+    int rc                = 0;
+
+    // take the snapshot of the loaded modules
+    lua_getglobal(NL, "package");
+    lua_getfield(NL, -1, "loaded");
+    lua_replace(NL, 1);
+    lua_settop(NL, 1);
+    lua_newtable(NL);
+    lua_pushnil(NL);
+    while (lua_next(NL, 1)) {
+        lua_pop(NL, 1);
+        lua_pushvalue(NL, -1);
+        lua_pushboolean(NL, 1);
+        lua_rawset(NL, 2);
+    }
+
+    // call require(modname)
+    lua_getglobal(NL, "require");
+    lua_pushstring(NL, modname);
+    before_kb = get_heap_kb(NL, 1);
+    rss_kb    = measure_getrss_kb();
+    ns        = measure_getnsec();
+    rc        = lua_pcall(NL, 1, 0, 0);
+    ns        = measure_getnsec() - ns;
+    after_kb  = get_heap_kb(NL, 0);
+    if (rc != LUA_OK) {
+        const char *err = lua_tostring(NL, -1);
+        lua_pushnil(L);
+        lua_pushstring(L, err ? err : "(error object is not a string)");
+        return 2;
+    }
+
+    lua_createtable(L, 0, 6);
+    lua_pushinteger(L, (lua_Integer)ns);
+    lua_setfield(L, -2, "time_ns");
+    lua_pushinteger(L, before_kb);
+    lua_setfield(L, -2, "before_kb");
+    lua_pushinteger(L, after_kb);
+    lua_setfield(L, -2, "after_kb");
+    lua_pushinteger(L, get_heap_kb(NL, 1) - before_kb);
+    lua_setfield(L, -2, "retained_kb");
+    if (rss_kb >= 0) {
+        long after_rss_kb = measure_getrss_kb();
+        if (after_rss_kb >= 0) {
+            lua_pushinteger(L, after_rss_kb - rss_kb);
+            lua_setfield(L, -2, "rss_kb");
+        }
+    }
+
+    // list the modules loaded by require()
+    lua_newtable(L);
+    int idx = 0;
+    lua_pushnil(NL);
+    while (lua_next(NL, 1)) {
+        lua_pop(NL, 1);
+        if (lua_type(NL, -1) == LUA_TSTRING) {
+            lua_pushvalue(NL, -1);
+            lua_rawget(NL, 2);
+            if (lua_isnil(NL, -1)) {
+                lua_pushstring(L, lua_tostring(NL, -2));
+                lua_rawseti(L, -2, ++idx);
+            }
+            lua_pop(NL, 1);
+        }
+    }
+    lua_setfield(L, -2, "modules");
+    return 1;
+}
+
+static int loadcost_lua(lua_State *L)
+{
+    const char *modname = luaL_checkstring(L, 1);
+    const char *path    = luaL_optstring(L, 2, NULL);
+    const char *cpath   = luaL_optstring(L, 3, NULL);
+    lua_State *NL       = luaL_newstate();
+    int rv              = 0;
+
+    if (!NL) {
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(ENOMEM));
+        return 2;
+    }
+    luaL_openlibs(NL);
+    set_path(NL, "path", path);
+    set_path(NL, "cpath", cpath);
+    rv = measure_require(L, NL, modname);
+    lua_close(NL);
+    return rv;
+}
+
+LUALIB_API int luaopen_measure_loadcost(lua_State *L)
+{
+    lua_pushcfunction(L, loadcost_lua);
+    return 1;
+}
@@ -24,7 +24,16 @@
 #define measure_h
 
 #include <stdint.h>
+#include <stdio.h>
 #include <time.h>
+#if defined(__linux__)
+# include <fcntl.h>
+# include <sys/types.h>
+# include <unistd.h>
+#endif
+#if defined(__GLIBC__)
+# include <malloc.h>
+#endif
 
 #define MEASURE_SEC2NSEC(s) ((uint64_t)(s) * 1000000000ULL)
 
@@ -43,4 +52,98 @@ static inline uint64_t measure_getnsec(void)
     return MEASURE_SEC2NSEC(ts.tv_sec) + (uint64_t)ts.tv_nsec;
 }
 
+/**
+ * @brief get the resident set size of the current process in KB.
+ * The /proc/self/statm is kept open to read it in each sample without the
+ * cost of open(2), and is opened again in the forked child process since the
+ * inherited descriptor refers to the parent process.
+ * @return long the resident set size in KB, or -1 if not available.
+ */
+static inline long measure_getrss_kb(void)
+{
+#if defined(__linux__)
+    static int fd    = -1;
+    static pid_t pid = 0;
+    pid_t cur        = getpid();
+    char buf[128]    = {0};
+    ssize_t len      = 0;
+    long size        = 0;
+    long pages       = 0;
+
+    if (fd == -1 || pid != cur) {
+        if (fd != -1) {
+            close(fd);
+        }
+        fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            return -1;
+        }
+        pid = cur;
+    }
+    len = pread(fd, buf, sizeof(buf) - 1, 0);
+    if (len <= 0 || sscanf(buf, "%ld %ld", &size, &pages) != 2) {
+        return -1;
+    }
+    return pages * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return -1;
+#endif
+}
+
+typedef struct {
+    size_t used_kb; // memory in use by malloc, including the mmapped chunks
+    size_t free_kb; // free memory held by the malloc arenas (fragmentation)
+} measure_mallinfo_t;
+
+/**
+ * @brief get the statistics of the malloc arenas.
+ * mallinfo2() is used on glibc 2.33 or later, and mallinfo() on the older
+ * glibc, whose fields wrap around at 4 GB.
+ * @param mi the statistics to fill.
+ * @return int 0 on success, or -1 if not available.
+ */
+static inline int measure_getmallinfo(measure_mallinfo_t *mi)
+{
+#if defined(__GLIBC__) &&                                                      \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    mi->used_kb           = (info.uordblks + info.hblkhd) / 1024;
+    mi->free_kb           = info.fordblks / 1024;
+    return 0;
+#elif defined(__GLIBC__)
+    struct mallinfo info = mallinfo();
+    mi->used_kb =
+        ((size_t)(unsigned)info.uordblks + (size_t)(unsigned)info.hblkhd) /
+        1024;
+    mi->free_kb = (size_t)(unsigned)info.fordblks / 1024;
+    return 0;
+#else
+    (void)mi;
+    return -1;
+#endif
+}
+
+// stride to touch every cache line of the eviction buffer
+#define MEASURE_CACHE_LINE 64
+
+/**
+ * @brief evict the CPU caches by reading every cache line of the buffer.
+ * The buffer should be larger than the last-level cache. The lines are only
+ * read, so they stay clean and the sample does not pay for their writeback
+ * when it replaces them.
+ * @param buf the eviction buffer.
+ * @param size the size of the buffer in bytes.
+ * @return unsigned char the sum of the bytes read.
+ */
+static inline unsigned char measure_evict_cache(const unsigned char *buf,
+                                                size_t size)
+{
+    const volatile unsigned char *p = buf;
+    unsigned char sum               = 0;
+    for (size_t i = 0; i < size; i += MEASURE_CACHE_LINE) {
+        sum += p[i];
+    }
+    return sum;
+}
+
 #endif /* measure_h */
@@ -72,11 +72,13 @@ typedef struct {
     size_t before_kb;    // Memory usage before operation (after GC if mode=0)
     size_t after_kb;     // Memory usage after operation
     size_t allocated_kb; // Memory allocated during operation
+    size_t rss_kb;       // Resident set size after operation (0 if unknown)
 } measure_samples_data_t;
 
 typedef struct {
     int saved_gc_pause;      // Saved GC pause value
     int saved_gc_stepmul;    // Saved GC step multiplier value
+    int saved_gc_mode;       // Saved GC mode (Lua 5.4 or later)
     size_t capacity;         // capacity of the samples array
     size_t count;            // number of samples collected
     size_t base_kb;          // Memory usage at start (after initial GC)
@@ -88,6 +90,12 @@ typedef struct {
     double M2;               // sum of squares about the mean (Welford's method)
     double mean;             // mean of the samples
     size_t sum_allocated_kb; // sum of all allocated memory in KB
+    int has_malloc;          // whether the malloc statistics are available
+    int64_t malloc_kb;       // growth of the memory in use by malloc in KB
+    int64_t native_kb;       // growth of malloc excluding the Lua heap in KB
+    size_t malloc_free_kb;   // free memory held by the malloc arenas in KB
+    measure_mallinfo_t malloc_start; // malloc statistics at preprocess
+    size_t malloc_start_heap_kb;     // Lua heap at preprocess in KB
     int gc_step;             // GC step size in KB (0 for full GC)
     int ref_data;            // reference to Lua data array
     measure_samples_data_t *data; // array of samples in nanoseconds
@@ -111,14 +119,20 @@ static inline void measure_samples_clear(measure_samples_t *s)
     s->M2               = 0.0;
     s->mean             = 0.0;
     s->sum_allocated_kb = 0;
+    s->has_malloc       = 0;
+    s->malloc_kb        = 0;
+    s->native_kb        = 0;
+    s->malloc_free_kb   = 0;
     memset(s->data, 0, sizeof(measure_samples_data_t) * s->capacity);
     s->base_kb = 0;
 }
 
 /**
  * @brief Preprocess the measure_samples_t object.
- * This function saves the current garbage collector state, performs a full
- * garbage collection, and records the baseline memory usage.
+ * This function saves the current garbage collector state (the pause, the
+ * step multiplier, and the mode on Lua 5.4 or later), performs a full
+ * garbage collection, and records the baseline memory usage and the malloc
+ * statistics.
  *
  * @param s Pointer to the measure_samples_t object
  * @param L Lua state
@@ -135,11 +149,23 @@ static inline void measure_samples_preprocess(measure_samples_t *s,
 #else
     s->saved_gc_stepmul = 200; // Default value for Lua 5.1
 #endif
+#if LUA_VERSION_NUM >= 504
+    // switching the mode returns the previous mode, and zero parameters are
+    // left unchanged
+    s->saved_gc_mode = lua_gc(L, LUA_GCINC, 0, 0, 0);
+    if (s->saved_gc_mode == LUA_GCGEN) {
+        lua_gc(L, LUA_GCGEN, 0, 0); // Restore immediately
+    }
+#endif
 
     // Perform full GC to get clean baseline
     lua_gc(L, LUA_GCCOLLECT, 0);
     // Record baseline memory usage after GC
     s->base_kb = (size_t)(lua_gc(L, LUA_GCCOUNT, 0));
+    // Record malloc statistics to calculate the growth in postprocess
+    if (measure_getmallinfo(&s->malloc_start) == 0) {
+        s->malloc_start_heap_kb = s->base_kb;
+    }
     // Disable GC if step is negative
     if (s->gc_step < 0) {
         lua_gc(L, LUA_GCSTOP, 0);
@@ -148,7 +174,10 @@ static inline void measure_samples_preprocess(measure_samples_t *s,
 
 /**
  * @brief Post-process the measure_samples_t object.
- * This function re-enables the garbage collector and restores its state.
+ * This function re-enables the garbage collector and restores its state,
+ * including the GC mode on Lua 5.4 or later, and accumulates the growth of
+ * the memory in use by malloc since preprocess. The growth of the Lua heap
+ * is subtracted from it to get the memory allocated by the C code.
  *
  * @param s Pointer to the measure_samples_t object
  * @param L Lua state
@@ -156,8 +185,28 @@ static inline void measure_samples_preprocess(measure_samples_t *s,
 static inline void measure_samples_postprocess(measure_samples_t *s,
                                                lua_State *L)
 {
+    measure_mallinfo_t mi = {0};
+
+    if (measure_getmallinfo(&mi) == 0) {
+        int64_t heap_kb = (int64_t)lua_gc(L, LUA_GCCOUNT, 0);
+        int64_t growth  = (int64_t)mi.used_kb - (int64_t)s->malloc_start.used_kb;
+
+        s->has_malloc = 1;
+        s->malloc_kb += growth;
+        s->native_kb += growth - (heap_kb - (int64_t)s->malloc_start_heap_kb);
+        s->malloc_free_kb = mi.free_kb;
+    }
+
     // Re-enable and restore GC state
     lua_gc(L, LUA_GCRESTART, 0);
+#if LUA_VERSION_NUM >= 504
+    // the benchmark may have changed the mode
+    if (s->saved_gc_mode == LUA_GCGEN) {
+        lua_gc(L, LUA_GCGEN, 0, 0);
+    } else {
+        lua_gc(L, LUA_GCINC, 0, 0, 0);
+    }
+#endif
     lua_gc(L, LUA_GCSETPAUSE, s->saved_gc_pause);
 #if LUA_VERSION_NUM >= 502
     lua_gc(L, LUA_GCSETSTEPMUL, s->saved_gc_stepmul);
@@ -170,13 +219,19 @@ static inline void measure_samples_postprocess(measure_samples_t *s,
  * nanoseconds and recording the memory usage before the operation. It checks if
  * there is space left in the samples array and returns -1 if not. If the
  * gc_step is 0, it performs a full garbage collection to ensure a clean state.
+ * If the eviction buffer is given, it is read after the garbage collection
+ * so that the sample starts with the CPU caches filled by the buffer.
  *
  * @param s Pointer to the measure_samples_t object
  * @param L Lua state
+ * @param evict Pointer to the eviction buffer, or NULL
+ * @param evict_size Size of the eviction buffer in bytes
  * @return 0 on success, -1 on error (if no space left)
  */
-static inline int measure_samples_init_sample(measure_samples_t *s,
-                                              lua_State *L)
+static inline int measure_samples_init_sample_ex(measure_samples_t *s,
+                                                 lua_State *L,
+                                                 const unsigned char *evict,
+                                                 size_t evict_size)
 {
     if (s->count >= s->capacity) {
         // no space left to add a new sample
@@ -188,6 +243,9 @@ static inline int measure_samples_init_sample(measure_samples_t *s,
     if (s->gc_step == 0) {
         lua_gc(L, LUA_GCCOLLECT, 0);
     }
+    if (evict) {
+        (void)measure_evict_cache(evict, evict_size);
+    }
 
     measure_samples_data_t *data = &s->data[s->count];
     // get the current time in nanoseconds
@@ -199,6 +257,12 @@ static inline int measure_samples_init_sample(measure_samples_t *s,
     return 0;
 }
 
+static inline int measure_samples_init_sample(measure_samples_t *s,
+                                              lua_State *L)
+{
+    return measure_samples_init_sample_ex(s, L, NULL, 0);
+}
+
 /**
  * @brief Update the sample data in the measure_samples_t object.
  * This function updates the sample data with the elapsed time, memory usage
@@ -216,12 +280,14 @@ static inline int measure_samples_init_sample(measure_samples_t *s,
  * @param elapsed Elapsed time in nanoseconds for the sample
  * @param before_kb Memory usage before the operation in KB
  * @param after_kb Memory usage after the operation in KB
+ * @param rss_kb Resident set size after the operation in KB (0 if unknown)
  * @return int 0 on success, -1 on error (if no space left)
  */
 static inline int measure_samples_update_sample_ex(measure_samples_t *s,
                                                    uint64_t elapsed,
                                                    size_t before_kb,
-                                                   size_t after_kb)
+                                                   size_t after_kb,
+                                                   size_t rss_kb)
 {
     if (s->count >= s->capacity) {
         // no space left to add a new sample
@@ -233,6 +299,7 @@ static inline int measure_samples_update_sample_ex(measure_samples_t *s,
     data->time_ns                = elapsed;
     data->before_kb              = before_kb;
     data->after_kb               = after_kb;
+    data->rss_kb                 = rss_kb;
     // Calculate allocated KB
     if (data->after_kb > data->before_kb) {
         data->allocated_kb = data->after_kb - data->before_kb;
@@ -269,7 +336,8 @@ static inline int measure_samples_update_sample_ex(measure_samples_t *s,
 /**
  * @brief Update the current sample in the measure_samples_t object.
  * This function calculates the elapsed time since the sample was initialized,
- * updates the memory usage after the operation, and applies step GC if needed.
+ * updates the memory usage and the resident set size after the operation,
+ * and applies step GC if needed.
  * It increments the sample count and returns 0 on success.
  *
  * @param s Pointer to the measure_samples_t object
@@ -290,7 +358,9 @@ static inline int measure_samples_update_sample(measure_samples_t *s,
     // calculate the elapsed time
     uint64_t elapsed             = measure_getnsec() - data->time_ns;
     size_t after_kb              = (size_t)lua_gc(L, LUA_GCCOUNT, 0);
-    measure_samples_update_sample_ex(s, elapsed, data->before_kb, after_kb);
+    long rss_kb                  = measure_getrss_kb();
+    measure_samples_update_sample_ex(s, elapsed, data->before_kb, after_kb,
+                                     rss_kb > 0 ? (size_t)rss_kb : 0);
 
     // Apply step GC if needed
     if (s->gc_step > 0 && data->allocated_kb >= (size_t)s->gc_step) {
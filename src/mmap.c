@@ -0,0 +1,229 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+#define MEASURE_MMAP_MT "measure.mmap"
+
+/*
+ * Read-only buffer of a file mapped into the memory.
+ *
+ * The contents are read from the page cache on access and are not copied into
+ * the Lua heap, so a large fixture does not change the heap size and the GC
+ * behaviour of the benchmark. byte() and sub() follow string.byte() and
+ * string.sub(), and sub() creates a Lua string of the range on demand.
+ */
+
+typedef struct {
+    const unsigned char *addr;
+    size_t len;
+    int closed;
+} measure_mmap_t;
+
+static measure_mmap_t *check_mmap(lua_State *L)
+{
+    measure_mmap_t *m = luaL_checkudata(L, 1, MEASURE_MMAP_MT);
+    if (m->closed) {
+        luaL_error(L, "attempt to use a closed buffer");
+    }
+    return m;
+}
+
+// convert a relative position of string.sub() to the absolute position
+static size_t posrelat(lua_Integer pos, size_t len)
+{
+    if (pos > 0) {
+        return (size_t)pos;
+    } else if (pos == 0) {
+        return 1;
+    } else if (pos < -(lua_Integer)len) {
+        return 1;
+    }
+    return len + (size_t)pos + 1;
+}
+
+static size_t posend(lua_Integer pos, size_t len)
+{
+    if (pos > (lua_Integer)len) {
+        return len;
+    } else if (pos >= 0) {
+        return (size_t)pos;
+    } else if (pos < -(lua_Integer)len) {
+        return 0;
+    }
+    return len + (size_t)pos + 1;
+}
+
+static int sub_lua(lua_State *L)
+{
+    measure_mmap_t *m = check_mmap(L);
+    size_t i          = posrelat(luaL_optinteger(L, 2, 1), m->len);
+    size_t j          = posend(luaL_optinteger(L, 3, -1), m->len);
+
+    if (i > j) {
+        lua_pushliteral(L, "");
+    } else {
+        lua_pushlstring(L, (const char *)m->addr + i - 1, j - i + 1);
+    }
+    return 1;
+}
+
+static int byte_lua(lua_State *L)
+{
+    measure_mmap_t *m = check_mmap(L);
+    lua_Integer pi    = luaL_optinteger(L, 2, 1);
+    size_t i          = posrelat(pi, m->len);
+    size_t j          = posend(luaL_optinteger(L, 3, pi), m->len);
+    int n             = 0;
+
+    if (i > j) {
+        return 0;
+    } else if (j - i >= (size_t)INT_MAX) {
+        return luaL_error(L, "range is too long");
+    }
+    n = (int)(j - i + 1);
+    luaL_checkstack(L, n, "range is too long");
+    for (int k = 0; k < n; k++) {
+        lua_pushinteger(L, m->addr[i + k - 1]);
+    }
+    return n;
+}
+
+static int len_lua(lua_State *L)
+{
+    measure_mmap_t *m = check_mmap(L);
+    lua_pushinteger(L, (lua_Integer)m->len);
+    return 1;
+}
+
+static int close_lua(lua_State *L)
+{
+    measure_mmap_t *m = luaL_checkudata(L, 1, MEASURE_MMAP_MT);
+    if (!m->closed) {
+        if (m->len) {
+            munmap((void *)m->addr, m->len);
+        }
+        m->addr   = NULL;
+        m->len    = 0;
+        m->closed = 1;
+    }
+    return 0;
+}
+
+static int tostring_lua(lua_State *L)
+{
+    lua_pushfstring(L, MEASURE_MMAP_MT ": %p", lua_touserdata(L, 1));
+    return 1;
+}
+
+static int new_lua(lua_State *L)
+{
+    const char *pathname = luaL_checkstring(L, 1);
+    measure_mmap_t *m    = lua_newuserdata(L, sizeof(measure_mmap_t));
+    struct stat st       = {0};
+    int fd               = -1;
+
+    // closed until the file is mapped, so __gc does nothing on failure
+    *m = (measure_mmap_t){.closed = 1};
+    luaL_getmetatable(L, MEASURE_MMAP_MT);
+    lua_setmetatable(L, -2);
+
+    fd = open(pathname, O_RDONLY | O_CLOEXEC);
+    if (fd == -1 || fstat(fd, &st) == -1) {
+        goto FAIL;
+    } else if (st.st_size > 0) {
+        // the mapping stays valid after the file is closed
+        void *addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd,
+                          0);
+        if (addr == MAP_FAILED) {
+            goto FAIL;
+        }
+        m->addr = addr;
+        m->len  = (size_t)st.st_size;
+    }
+    close(fd);
+    m->closed = 0;
+    return 1;
+
+FAIL: {
+    int err = errno;
+    if (fd != -1) {
+        close(fd);
+    }
+    lua_pushnil(L);
+    lua_pushstring(L, strerror(err));
+    return 2;
+}
+}
+
+LUALIB_API int luaopen_measure_mmap(lua_State *L)
+{
+    // create metatable
+    if (luaL_newmetatable(L, MEASURE_MMAP_MT)) {
+        struct luaL_Reg mmethod[] = {
+            {"__gc",       close_lua   },
+            {"__len",      len_lua     },
+            {"__tostring", tostring_lua},
+            {NULL,         NULL        }
+        };
+        struct luaL_Reg method[] = {
+            {"len",   len_lua  },
+            {"byte",  byte_lua },
+            {"sub",   sub_lua  },
+            {"close", close_lua},
+            {NULL,    NULL     }
+        };
+
+        // metamethods
+        for (struct luaL_Reg *ptr = mmethod; ptr->name; ptr++) {
+            lua_pushcfunction(L, ptr->func);
+            lua_setfield(L, -2, ptr->name);
+        }
+        // methods
+        lua_createtable(L, 0, 4);
+        for (struct luaL_Reg *ptr = method; ptr->name; ptr++) {
+            lua_pushcfunction(L, ptr->func);
+            lua_setfield(L, -2, ptr->name);
+        }
+        lua_setfield(L, -2, "__index");
+
+        // Protect metatable from external access
+        lua_pushliteral(L, "metatable is protected");
+        lua_setfield(L, -2, "__metatable");
+
+        lua_pop(L, 1);
+    }
+
+    lua_pushcfunction(L, new_lua);
+    return 1;
+}
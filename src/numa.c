@@ -0,0 +1,285 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE // for sched_setaffinity()
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+// lua_rawlen is not available in Lua 5.1
+#if LUA_VERSION_NUM < 502
+# define lua_rawlen(L, idx) lua_objlen(L, idx)
+#endif
+
+/*
+ * NUMA placement of the process.
+ *
+ * nodes() lists the online nodes with their CPUs and memory from sysfs, and
+ * bind() restricts the process to the CPUs of a node by sched_setaffinity()
+ * and its new memory allocations to a node by set_mempolicy(MPOL_BIND). The
+ * system calls are called directly, so libnuma is not required.
+ */
+
+#if defined(__linux__)
+# include <sched.h>
+# include <sys/syscall.h>
+
+# define SYSFS_NODE "/sys/devices/system/node"
+
+# ifndef MPOL_BIND
+#  define MPOL_BIND 2
+# endif
+
+// maximum number of nodes in the node mask of set_mempolicy()
+# define MAX_NODES 1024
+
+// Read the first line of a small file such as sysfs entries.
+// Returns the length of the line without the trailing newline, or -1.
+static ssize_t read_line(const char *pathname, char *buf, size_t size)
+{
+    FILE *fp  = fopen(pathname, "r");
+    ssize_t n = -1;
+
+    if (fp) {
+        if (fgets(buf, (int)size, fp)) {
+            n = (ssize_t)strcspn(buf, "\n");
+            buf[n] = 0;
+        }
+        fclose(fp);
+    }
+    return n;
+}
+
+// Push the list of the numbers in the format of "0-3,8,10-11" as a table
+static void push_list(lua_State *L, const char *str)
+{
+    int idx = 0;
+
+    lua_createtable(L, 0, 0);
+    while (*str) {
+        char *end  = NULL;
+        long first = strtol(str, &end, 10);
+        long last  = first;
+
+        if (end == str) {
+            break;
+        } else if (*end == '-') {
+            str  = end + 1;
+            last = strtol(str, &end, 10);
+        }
+        for (long i = first; i <= last; i++) {
+            lua_pushinteger(L, i);
+            lua_rawseti(L, -2, ++idx);
+        }
+        str = end + strspn(end, ",");
+    }
+}
+
+// Get the total memory of the node in KB from its meminfo, or -1
+static long node_memory_kb(long node)
+{
+    char pathname[64];
+    char line[256];
+    FILE *fp = NULL;
+    long kb  = -1;
+
+    snprintf(pathname, sizeof(pathname), SYSFS_NODE "/node%ld/meminfo", node);
+    if ((fp = fopen(pathname, "r"))) {
+        while (fgets(line, sizeof(line), fp)) {
+            // "Node 0 MemTotal:       16329044 kB"
+            const char *v = strstr(line, "MemTotal:");
+            if (v) {
+                kb = strtol(v + sizeof("MemTotal:") - 1, NULL, 10);
+                break;
+            }
+        }
+        fclose(fp);
+    }
+    return kb;
+}
+
+static int nodes_lua(lua_State *L)
+{
+    char buf[4096];
+    int nnode = 0;
+
+    if (read_line(SYSFS_NODE "/online", buf, sizeof(buf)) <= 0) {
+        lua_pushnil(L);
+        lua_pushliteral(L, "NUMA is not supported on this platform");
+        return 2;
+    }
+
+    push_list(L, buf);
+    nnode = (int)lua_rawlen(L, -1);
+    lua_createtable(L, nnode, 0);
+    for (int i = 1; i <= nnode; i++) {
+        char pathname[64];
+        long node = 0;
+        long kb   = 0;
+
+        lua_rawgeti(L, -2, i);
+        node = (long)lua_tointeger(L, -1);
+        lua_pop(L, 1);
+
+        lua_createtable(L, 0, 3);
+        lua_pushinteger(L, node);
+        lua_setfield(L, -2, "node");
+        snprintf(pathname, sizeof(pathname), SYSFS_NODE "/node%ld/cpulist",
+                 node);
+        if (read_line(pathname, buf, sizeof(buf)) < 0) {
+            buf[0] = 0;
+        }
+        push_list(L, buf);
+        lua_setfield(L, -2, "cpus");
+        if ((kb = node_memory_kb(node)) >= 0) {
+            lua_pushinteger(L, kb);
+            lua_setfield(L, -2, "mem_kb");
+        }
+        lua_rawseti(L, -2, i);
+    }
+    return 1;
+}
+
+static int bind_lua(lua_State *L)
+{
+    lua_Integer cpu_node = luaL_checkinteger(L, 1);
+    lua_Integer mem_node = luaL_optinteger(L, 2, cpu_node);
+    unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+    char pathname[64];
+    char buf[4096];
+    cpu_set_t cpus;
+    int ncpu = 0;
+
+    luaL_argcheck(L, cpu_node >= 0 && cpu_node < MAX_NODES, 1,
+                  "node out of range");
+    luaL_argcheck(L, mem_node >= 0 && mem_node < MAX_NODES, 2,
+                  "node out of range");
+
+    // restrict the process to the CPUs of the node
+    snprintf(pathname, sizeof(pathname), SYSFS_NODE "/node%d/cpulist",
+             (int)cpu_node);
+    if (read_line(pathname, buf, sizeof(buf)) < 0) {
+        lua_pushnil(L);
+        lua_pushfstring(L, "node %d is not found", (int)cpu_node);
+        return 2;
+    }
+    CPU_ZERO(&cpus);
+    push_list(L, buf);
+    ncpu = (int)lua_rawlen(L, -1);
+    for (int i = 1; i <= ncpu; i++) {
+        lua_Integer cpu = 0;
+
+        lua_rawgeti(L, -1, i);
+        cpu = lua_tointeger(L, -1);
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET((int)cpu, &cpus);
+        }
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+    if (ncpu == 0) {
+        lua_pushnil(L);
+        lua_pushfstring(L, "node %d has no CPUs", (int)cpu_node);
+        return 2;
+    } else if (sched_setaffinity(0, sizeof(cpus), &cpus) == -1) {
+        lua_pushnil(L);
+        lua_pushfstring(L, "failed to set the CPU affinity: %s",
+                        strerror(errno));
+        return 2;
+    }
+
+    // allocate the new pages only from the memory of the node
+    mask[mem_node / (8 * sizeof(unsigned long))] |=
+        1UL << (mem_node % (8 * sizeof(unsigned long)));
+    // the kernel expects the number of bits plus one
+    if (syscall(SYS_set_mempolicy, MPOL_BIND, mask, MAX_NODES + 1) == -1) {
+        lua_pushnil(L);
+        lua_pushfstring(L, "failed to set the memory policy: %s",
+                        strerror(errno));
+        return 2;
+    }
+
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int getcpu_lua(lua_State *L)
+{
+    unsigned cpu  = 0;
+    unsigned node = 0;
+
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == -1) {
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    lua_pushinteger(L, cpu);
+    lua_pushinteger(L, node);
+    return 2;
+}
+
+#else
+
+static int nodes_lua(lua_State *L)
+{
+    lua_pushnil(L);
+    lua_pushliteral(L, "NUMA is not supported on this platform");
+    return 2;
+}
+
+static int bind_lua(lua_State *L)
+{
+    return nodes_lua(L);
+}
+
+static int getcpu_lua(lua_State *L)
+{
+    return nodes_lua(L);
+}
+
+#endif
+
+LUALIB_API int luaopen_measure_numa(lua_State *L)
+{
+    struct luaL_Reg funcs[] = {
+        {"nodes",  nodes_lua },
+        {"bind",   bind_lua  },
+        {"getcpu", getcpu_lua},
+        {NULL,     NULL      }
+    };
+
+    lua_createtable(L, 0, 3);
+    for (struct luaL_Reg *ptr = funcs; ptr->name; ptr++) {
+        lua_pushcfunction(L, ptr->func);
+        lua_setfield(L, -2, ptr->name);
+    }
+    return 1;
+}
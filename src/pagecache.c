@@ -0,0 +1,181 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+/*
+ * Page cache control of the fixture files.
+ *
+ * evict() writes back the dirty pages of the file and drops its pages from
+ * the page cache by posix_fadvise(POSIX_FADV_DONTNEED), warm() reads the whole
+ * file into the page cache, and resident() counts the pages of the file that
+ * are in the page cache by mincore().
+ */
+
+// size of the buffer to read the file
+#define READ_BUFSIZE (256 * 1024)
+
+static int push_error(lua_State *L, int fd)
+{
+    int err = errno;
+
+    if (fd != -1) {
+        close(fd);
+    }
+    lua_pushnil(L);
+    lua_pushstring(L, strerror(err));
+    return 2;
+}
+
+static int evict_lua(lua_State *L)
+{
+#if defined(POSIX_FADV_DONTNEED)
+    const char *pathname = luaL_checkstring(L, 1);
+    int fd               = open(pathname, O_RDONLY | O_CLOEXEC);
+    int rc               = 0;
+
+    if (fd == -1) {
+        return push_error(L, fd);
+    }
+    // only the clean pages can be dropped
+    fdatasync(fd);
+    if ((rc = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED)) != 0) {
+        errno = rc;
+        return push_error(L, fd);
+    }
+    close(fd);
+    lua_pushboolean(L, 1);
+    return 1;
+#else
+    lua_pushnil(L);
+    lua_pushliteral(L, "posix_fadvise is not supported on this platform");
+    return 2;
+#endif
+}
+
+static int warm_lua(lua_State *L)
+{
+    const char *pathname = luaL_checkstring(L, 1);
+    int fd               = open(pathname, O_RDONLY | O_CLOEXEC);
+    char *buf            = NULL;
+    ssize_t n            = 0;
+
+    if (fd == -1) {
+        return push_error(L, fd);
+    } else if (!(buf = malloc(READ_BUFSIZE))) {
+        return push_error(L, fd);
+    }
+#if defined(POSIX_FADV_WILLNEED)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+    // read the whole file, since the advice is only a hint
+    while ((n = read(fd, buf, READ_BUFSIZE)) != 0) {
+        if (n == -1 && errno != EINTR) {
+            free(buf);
+            return push_error(L, fd);
+        }
+    }
+    free(buf);
+    close(fd);
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int resident_lua(lua_State *L)
+{
+    const char *pathname = luaL_checkstring(L, 1);
+    int fd               = open(pathname, O_RDONLY | O_CLOEXEC);
+    long pagesize        = sysconf(_SC_PAGESIZE);
+    struct stat st       = {0};
+    size_t npage         = 0;
+    size_t nresident     = 0;
+    unsigned char *vec   = NULL;
+    void *addr           = NULL;
+
+    if (fd == -1 || fstat(fd, &st) == -1) {
+        return push_error(L, fd);
+    } else if (st.st_size == 0) {
+        close(fd);
+        lua_pushinteger(L, 0);
+        lua_pushinteger(L, 0);
+        return 2;
+    }
+
+    npage = ((size_t)st.st_size + (size_t)pagesize - 1) / (size_t)pagesize;
+    addr  = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return push_error(L, fd);
+    } else if (!(vec = malloc(npage))) {
+        munmap(addr, (size_t)st.st_size);
+        return push_error(L, fd);
+    }
+    // mapping the file does not read its pages
+    if (mincore(addr, (size_t)st.st_size, (void *)vec) == -1) {
+        free(vec);
+        munmap(addr, (size_t)st.st_size);
+        return push_error(L, fd);
+    }
+    for (size_t i = 0; i < npage; i++) {
+        nresident += vec[i] & 1;
+    }
+    free(vec);
+    munmap(addr, (size_t)st.st_size);
+    close(fd);
+
+    // bytes in the page cache and the size of the file
+    nresident *= (size_t)pagesize;
+    if (nresident > (size_t)st.st_size) {
+        // the last page is partially used
+        nresident = (size_t)st.st_size;
+    }
+    lua_pushinteger(L, (lua_Integer)nresident);
+    lua_pushinteger(L, (lua_Integer)st.st_size);
+    return 2;
+}
+
+LUALIB_API int luaopen_measure_pagecache(lua_State *L)
+{
+    struct luaL_Reg funcs[] = {
+        {"evict",    evict_lua   },
+        {"warm",     warm_lua    },
+        {"resident", resident_lua},
+        {NULL,       NULL        }
+    };
+
+    lua_createtable(L, 0, 3);
+    for (struct luaL_Reg *ptr = funcs; ptr->name; ptr++) {
+        lua_pushcfunction(L, ptr->func);
+        lua_setfield(L, -2, ptr->name);
+    }
+    return 1;
+}
@@ -23,6 +23,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -45,6 +46,9 @@ typedef struct {
     measure_samples_t *samples; // pointer to the samples object
     int warmup;                 // warmup duration in seconds
     int clear;                  // whether to clear samples before running
+    unsigned char *evict;       // buffer to evict the caches before each sample
+    size_t evict_size;          // size of the eviction buffer in bytes
+    int before; // whether to call the function at index 3 before each sample
 } sampler_t;
 
 static inline int is_lua_error(lua_State *L, int rc)
@@ -95,12 +99,21 @@ static int sampling_lua(sampler_t *s)
     measure_samples_preprocess(s->samples, L);
 
     for (size_t i = s->samples->count; i < capacity; i++) {
+        if (s->before) {
+            // prepare the sample outside the timed region
+            lua_pushvalue(L, 3);
+            if (is_lua_error(L, lua_pcall(L, 0, 0, 0))) {
+                return -1;
+            }
+        }
+
         // push the function again, as it may have been removed from the stack
         lua_pushvalue(L, 1);
         lua_pushboolean(L, 0);
 
         // initialize a sample data structure.
-        if (measure_samples_init_sample(s->samples, L) < 0) {
+        if (measure_samples_init_sample_ex(s->samples, L, s->evict,
+                                           s->evict_size) < 0) {
             lua_pushfstring(L, "failed to initialize sample: %s",
                             strerror(errno));
             return -1;
@@ -181,21 +194,44 @@ static int run_lua(lua_State *L)
         luaL_checktype(L, 4, LUA_TBOOLEAN);
         s.clear = lua_toboolean(L, 4);
     }
-    lua_settop(L, 2); // clear stack except for the function and samples object
+    if (!lua_isnoneornil(L, 5)) {
+        // check optional size of the eviction buffer in KB
+        lua_Integer iv = luaL_checkinteger(L, 5);
+        if (iv > 0) {
+            s.evict_size = (size_t)iv * 1024;
+        }
+    }
+    if (!lua_isnoneornil(L, 6)) {
+        // check optional function to call before each sample
+        luaL_checktype(L, 6, LUA_TFUNCTION);
+        s.before = 1;
+    }
+    // allocate the eviction buffer after all the arguments are checked, since
+    // a failed check does not return here to free it
+    if (s.evict_size) {
+        if (!(s.evict = malloc(s.evict_size))) {
+            lua_pushboolean(L, 0);
+            lua_pushfstring(L, "failed to allocate the eviction buffer: %s",
+                            strerror(errno));
+            return 2;
+        }
+        // fault in the pages before the first sample
+        memset(s.evict, 1, s.evict_size);
+    }
+    // clear stack except for the function, samples object and before function
+    lua_settop(L, 6);
+    lua_replace(L, 3);
+    lua_settop(L, 3);
 
     // if warmup is greater than 0, run the function for warmup iterations
     rv = warmup_lua(&s);
-    if (rv != 0) {
-        // if there was an error during warmup, return the error
-        lua_pushboolean(L, 0);
-        lua_insert(L, -2);
-        return 2;
+    if (rv == 0) {
+        // run the sampling function
+        rv = sampling_lua(&s);
     }
-
-    // run the sampling function
-    rv = sampling_lua(&s);
+    free(s.evict);
     if (rv != 0) {
-        // if there was an error during sampling, return the error
+        // if there was an error during warmup or sampling, return the error
         lua_pushboolean(L, 0);
         lua_insert(L, -2);
         return 2;
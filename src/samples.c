@@ -252,6 +252,8 @@ static int memstat_lua(lua_State *L)
         double uncollected;  // Uncollected memory growth (KB)
         double avg_incr;     // Average memory change per sample (KB)
         double max_alloc_op; // Maximum allocation per operation (KB/op)
+        size_t peak_rss;     // Peak resident set size in KB
+        double rss_growth;   // Resident set size growth (KB)
     } memstat = {0};
 
     if (samples->count > 0) {
@@ -269,6 +271,10 @@ static int memstat_lua(lua_State *L)
         if ((double)samples->data[idx].allocated_kb > memstat.max_alloc_op) {  \
             memstat.max_alloc_op = (double)samples->data[idx].allocated_kb;    \
         }                                                                      \
+        /* Update peak resident set size */                                    \
+        if (samples->data[idx].rss_kb > memstat.peak_rss) {                    \
+            memstat.peak_rss = samples->data[idx].rss_kb;                      \
+        }                                                                      \
     } while (0)
 
         // calculate metrics
@@ -299,10 +305,17 @@ static int memstat_lua(lua_State *L)
             // Average memory change per sample (total_increase already
             // calculated in loop)
             memstat.avg_incr = total_increase / (samples->count - 1);
+
+            // Resident set size growth from the first to the last sample
+            if (samples->data[0].rss_kb > 0) {
+                memstat.rss_growth =
+                    (double)samples->data[samples->count - 1].rss_kb -
+                    (double)samples->data[0].rss_kb;
+            }
         }
     }
 
-    lua_createtable(L, 0, 5);
+    lua_createtable(L, 0, 10);
     lua_pushnumber(L, memstat.alloc_op);
     lua_setfield(L, -2, "alloc_op");
     lua_pushinteger(L, memstat.peak);
@@ -317,6 +330,22 @@ static int memstat_lua(lua_State *L)
     lua_pushnumber(L, memstat.max_alloc_op);
     lua_setfield(L, -2, "max_alloc_op");
 
+    // Process memory fields (absent if not available on this platform)
+    if (memstat.peak_rss > 0) {
+        lua_pushinteger(L, memstat.peak_rss);
+        lua_setfield(L, -2, "peak_rss");
+        lua_pushnumber(L, memstat.rss_growth);
+        lua_setfield(L, -2, "rss_growth");
+    }
+    if (samples->has_malloc) {
+        lua_pushinteger(L, samples->malloc_kb);
+        lua_setfield(L, -2, "malloc_kb");
+        lua_pushinteger(L, samples->native_kb);
+        lua_setfield(L, -2, "native_kb");
+        lua_pushinteger(L, samples->malloc_free_kb);
+        lua_setfield(L, -2, "malloc_free_kb");
+    }
+
     return 1;
 }
 
@@ -325,14 +354,15 @@ static int dump_lua(lua_State *L)
     measure_samples_t *s = luaL_checkudata(L, 1, MEASURE_SAMPLES_MT);
     lua_settop(L, 1);
 
-    // Create a table with 8 fields (4 data arrays + 4 metadata fields)
+    // Create a table with 8 fields (5 data arrays + 3 metadata fields)
     lua_createtable(L, 0, 8);
 
-    // Create time_ns, before_kb, after_kb and allocated_kb arrays
+    // Create time_ns, before_kb, after_kb, allocated_kb and rss_kb arrays
     lua_createtable(L, s->count, 0); // 3: time_ns
     lua_createtable(L, s->count, 0); // 4: before_kb
     lua_createtable(L, s->count, 0); // 5: after_kb
     lua_createtable(L, s->count, 0); // 6: allocated_kb
+    lua_createtable(L, s->count, 0); // 7: rss_kb
     for (size_t i = 0; i < s->count; i++) {
         int idx = i + 1;
         lua_pushinteger(L, s->data[i].time_ns);
@@ -343,7 +373,10 @@ static int dump_lua(lua_State *L)
         lua_rawseti(L, 5, idx);
         lua_pushinteger(L, s->data[i].allocated_kb);
         lua_rawseti(L, 6, idx);
+        lua_pushinteger(L, s->data[i].rss_kb);
+        lua_rawseti(L, 7, idx);
     }
+    lua_setfield(L, 2, "rss_kb");
     lua_setfield(L, 2, "allocated_kb");
     lua_setfield(L, 2, "after_kb");
     lua_setfield(L, 2, "before_kb");
@@ -388,6 +421,15 @@ static int dump_lua(lua_State *L)
     lua_pushinteger(L, s->base_kb);
     lua_setfield(L, 2, "base_kb");
 
+    if (s->has_malloc) {
+        lua_pushinteger(L, s->malloc_kb);
+        lua_setfield(L, 2, "malloc_kb");
+        lua_pushinteger(L, s->native_kb);
+        lua_setfield(L, 2, "native_kb");
+        lua_pushinteger(L, s->malloc_free_kb);
+        lua_setfield(L, 2, "malloc_free_kb");
+    }
+
     return 1;
 }
 
@@ -549,6 +591,25 @@ static int restore_lua(lua_State *L)
     s->count   = 0;
     s->base_kb = base_kb;
 
+    // malloc statistics are optional, since they are not available on all
+    // platforms
+    lua_getfield(L, 1, "malloc_kb");
+    lua_getfield(L, 1, "native_kb");
+    lua_getfield(L, 1, "malloc_free_kb");
+    if (!lua_isnil(L, -3)) {
+        luaL_argcheck(L,
+                      lua_isinteger(L, -3) && lua_isinteger(L, -2) &&
+                          lua_isinteger(L, -1) && lua_tointeger(L, -1) >= 0,
+                      1,
+                      "fields 'malloc_kb', 'native_kb' and 'malloc_free_kb' "
+                      "must be integers");
+        s->has_malloc     = 1;
+        s->malloc_kb      = (int64_t)lua_tointeger(L, -3);
+        s->native_kb      = (int64_t)lua_tointeger(L, -2);
+        s->malloc_free_kb = (size_t)lua_tointeger(L, -1);
+    }
+    lua_pop(L, 3);
+
     // Check if the table has the required fields
     top = lua_gettop(L);
 
@@ -576,6 +637,21 @@ static int restore_lua(lua_State *L)
 
 #undef CHECK_TABLE_FIELD
 
+    // rss_kb is optional for the samples dumped by the older versions
+#define RSS_KB_FIELD (top + 4)
+    lua_getfield(L, 1, "rss_kb");
+    int has_rss = !lua_isnil(L, -1);
+    if (has_rss) {
+        luaL_argcheck(L, lua_istable(L, -1), 1,
+                      "field 'rss_kb' must be a table");
+        if (lua_rawlen(L, -1) != count) {
+            lua_pushnil(L);
+            lua_pushliteral(L,
+                            "field 'rss_kb' array size does not match 'count'");
+            return 2;
+        }
+    }
+
     // Fill data from table arrays (only up to count)
     s->min = UINT64_MAX; // ensure any sample will be less
     for (size_t i = 1; i <= count; i++) {
@@ -598,9 +674,13 @@ static int restore_lua(lua_State *L)
         COPY_ARRAY_VALUE(time_ns, TIME_NS_FIELD);
         COPY_ARRAY_VALUE(before_kb, BEFORE_KB_FIELD);
         COPY_ARRAY_VALUE(after_kb, AFTER_KB_FIELD);
+        data.rss_kb = 0;
+        if (has_rss) {
+            COPY_ARRAY_VALUE(rss_kb, RSS_KB_FIELD);
+        }
         // update sample data and related statistics
         measure_samples_update_sample_ex(s, data.time_ns, data.before_kb,
-                                         data.after_kb);
+                                         data.after_kb, data.rss_kb);
     }
 
     // Clean up the stack and return the new measure_samples_t object
@@ -652,6 +732,7 @@ static inline void copy_samples(lua_State *L, measure_samples_t *dst,
         }
 
         dst->sum += src->sum;
+        dst->sum_allocated_kb += src->sum_allocated_kb;
         if (src->min < dst->min) {
             dst->min = src->min;
         }
@@ -660,6 +741,16 @@ static inline void copy_samples(lua_State *L, measure_samples_t *dst,
         }
         dst->count += src->count;
     }
+
+    // Sum up the malloc growth of each process
+    if (src->has_malloc) {
+        dst->has_malloc = 1;
+        dst->malloc_kb += src->malloc_kb;
+        dst->native_kb += src->native_kb;
+        if (src->malloc_free_kb > dst->malloc_free_kb) {
+            dst->malloc_free_kb = src->malloc_free_kb;
+        }
+    }
 }
 
 static int merge_lua(lua_State *L)
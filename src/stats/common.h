@@ -51,9 +51,218 @@
 // Minimum for MAD outlier detection
 #define MIN_SAMPLES_MAD_OUTLIER       3
 
+// Mathematical constants for high-precision calculations
+static const double FPMIN_THRESHOLD      = 1.0e-300;
+static const double BETA_CONVERGENCE_EPS = 1.0e-16;
+static const int BETA_MAX_ITERATIONS     = 500;
+
+// Bernoulli coefficients for Stirling's approximation: B_n / (n * n!)
+typedef struct {
+    double coeff;
+} bernoulli_term_t;
+
+static const bernoulli_term_t BERNOULLI_COEFFS[] = {
+    {1.0 / 12.0},          // B2/(2*2!)
+    {-1.0 / 360.0},        // B4/(4*4!)
+    {1.0 / 1260.0},        // B6/(6*6!)
+    {-1.0 / 1680.0},       // B8/(8*8!)
+    {1.0 / 1188.0},        // B10/(10*10!)
+    {-691.0 / 360360.0},   // B12/(12*12!)
+    {1.0 / 156.0},         // B14/(14*14!)
+    {-3617.0 / 122400.0},  // B16/(16*16!)
+    {43867.0 / 244188.0},  // B18/(18*18!)
+    {-174611.0 / 125400.0} // B20/(20*20!)
+};
+static const size_t NUM_BERNOULLI_TERMS =
+    sizeof(BERNOULLI_COEFFS) / sizeof(BERNOULLI_COEFFS[0]);
+
+// High-precision log gamma using Stirling's approximation
+static inline double log_gamma_stirling(double x)
+{
+    // Apply gamma recurrence relation for values < 15 (helper function inlined)
+    double correction = 0.0;
+    while (x < 15.0) {
+        correction -= log(x);
+        x += 1.0;
+    }
+
+    // Base Stirling formula: log(Γ(x)) ≈ (x-0.5)log(x) - x + 0.5*log(2π)
+    double result = (x - 0.5) * log(x) - x + 0.91893853320467274178032973640562;
+
+    // Add Bernoulli correction terms
+    double x_inv       = 1.0 / x;
+    double x_inv_power = x_inv;
+    double x_inv2      = x_inv * x_inv;
+
+    for (size_t i = 0; i < NUM_BERNOULLI_TERMS; i++) {
+        result += BERNOULLI_COEFFS[i].coeff * x_inv_power;
+        x_inv_power *= x_inv2;
+    }
+
+    return result + correction;
+}
+
+// Lentz's continued fraction algorithm for incomplete beta function
+static inline double betacf(double a, double b, double x)
+{
+// Prevent underflow in continued fraction calculations (helper macro)
+#define ensure_minimum_value(value)                                            \
+    do {                                                                       \
+        if (fabs(*(value)) < FPMIN_THRESHOLD) {                                \
+            *(value) = (*(value) < 0) ? -FPMIN_THRESHOLD : FPMIN_THRESHOLD;    \
+        }                                                                      \
+    } while (0)
+
+    double qab = a + b;
+    double qap = a + 1.0;
+    double qam = a - 1.0;
+
+    // Initialize Lentz's algorithm
+    double c = 1.0;
+    double d = 1.0 - qab * x / qap;
+    ensure_minimum_value(&d);
+    d        = 1.0 / d;
+    double h = d;
+
+    for (int m = 1; m <= BETA_MAX_ITERATIONS; m++) {
+        int m2 = 2 * m;
+
+        // Even coefficient
+        double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d         = 1.0 + aa * d;
+        ensure_minimum_value(&d);
+        c = 1.0 + aa / c;
+        ensure_minimum_value(&c);
+        d = 1.0 / d;
+        h *= d * c;
+
+        // Odd coefficient
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d  = 1.0 + aa * d;
+        ensure_minimum_value(&d);
+        c = 1.0 + aa / c;
+        ensure_minimum_value(&c);
+        d          = 1.0 / d;
+        double del = d * c;
+        h *= del;
+
+        // Check convergence
+        if (fabs(del - 1.0) <= BETA_CONVERGENCE_EPS) {
+            break;
+        }
+    }
+
+#undef ensure_minimum_value
+    return h;
+}
+
+// Log gamma function using direct Stirling implementation for better precision
+static inline double log_gamma(double x)
+{
+    return log_gamma_stirling(x);
+}
+
+// Regularized incomplete beta function I_x(a,b)
+static inline double betai(double a, double b, double x)
+{
+    if (x < 0.0 || x > 1.0) {
+        return -1.0; // Invalid input
+    }
+
+    if (x == 0.0) {
+        return 0.0;
+    }
+    if (x == 1.0) {
+        return 1.0;
+    }
+
+    // Compute beta prefactor in log space for numerical stability
+    double log_bt = log_gamma(a + b) - log_gamma(a) - log_gamma(b) +
+                    a * log(x) + b * log(1.0 - x);
+
+    // Choose the most numerically stable form
+    if (x < (a + 1.0) / (a + b + 2.0)) {
+        // Use direct form
+        double bt = exp(log_bt);
+        return bt * betacf(a, b, x) / a;
+    } else {
+        // Use complementary form for better stability
+        double bt = exp(log_bt);
+        return 1.0 - bt * betacf(b, a, 1.0 - x) / b;
+    }
+}
+
+// Student's t-distribution cumulative distribution function
+static inline double student_t_cdf(double t, double df)
+{
+    if (!isfinite(t) || !isfinite(df) || df <= 0) {
+        return (t < 0) ? 0.0 : 1.0;
+    }
+
+    // For very large |t|, use asymptotic behavior
+    if (fabs(t) > 100.0) {
+        return (t < 0) ? 0.0 : 1.0;
+    }
+
+    // Special case for df = 1 (Cauchy distribution)
+    if (fabs(df - 1.0) < 1e-15) {
+        return 0.5 + atan(t) / M_PI;
+    }
+
+    // For large df, use normal approximation
+    if (df > 1000.0) {
+        // Standard normal CDF approximation
+        double z = t;
+        return 0.5 * (1.0 + erf(z / sqrt(2.0)));
+    }
+
+    // Use the relationship: T ~ t_df ⟺ T² / (df + T²) ~ Beta(1/2, df/2)
+    // But implement with better numerical stability
+
+    double t_squared = t * t;
+
+    // For better numerical stability, use different forms based on magnitude
+    double x;
+    if (t_squared < df) {
+        // x = t²/(df + t²)
+        x = t_squared / (df + t_squared);
+    } else {
+        // x = 1 - df/(df + t²) for better precision when t is large
+        x = 1.0 - df / (df + t_squared);
+    }
+
+    // Compute the incomplete beta function
+    double p_beta = betai(0.5, df / 2.0, x);
+
+    // Return the CDF value
+    if (t >= 0.0) {
+        return 0.5 + 0.5 * p_beta;
+    } else {
+        return 0.5 - 0.5 * p_beta;
+    }
+}
+
+// Calculate two-tailed p-value from t-statistic
+static inline double calc_two_tailed_p_value(double t, double df)
+{
+    if (!isfinite(t) || !isfinite(df) || df <= 0) {
+        return 1.0;
+    }
+
+    double p = 2.0 * (1.0 - student_t_cdf(fabs(t), df));
+
+    // Clamp p-value to valid [0,1] range (inlined)
+    if (p < 0.0)
+        p = 0.0;
+    else if (p > 1.0)
+        p = 1.0;
+
+    return p;
+}
+
 // T-distribution critical values for common confidence levels
 // Indexed by degrees of freedom (df = n - 1)
-// For df >= 30, use normal distribution approximation
+// For the other levels or df > 30, the quantile is computed from the CDF
 static const struct {
     double df;
     double t_90; // 90% confidence
@@ -92,57 +301,68 @@ static const struct {
     {30, 1.697, 2.042,  2.750 }
 };
 
-// Helper function to get t-value for given confidence level and degrees of
-// freedom
-static inline double get_t_value(size_t df, double confidence_level)
+// Quantile of the Student's t-distribution for the probability p > 0.5.
+// The closed forms are used for df = 1 and 2, whose tails are too heavy for
+// student_t_cdf(), and the bisection of the CDF otherwise.
+static inline double t_quantile(double p, double df)
 {
-    // For large samples (df >= 30), use normal distribution approximation
-    if (df >= 30) {
-        if (confidence_level >= CONFIDENCE_LEVEL_99) {
-            return 2.576;
-        }
-        if (confidence_level >= CONFIDENCE_LEVEL_95) {
-            return 1.96;
-        }
-        if (confidence_level >= CONFIDENCE_LEVEL_90) {
-            return 1.645;
-        }
-        return 1.0;
+    if (p <= 0.5) {
+        return 0.0;
     }
-
-    // Use t-table for small samples
-    if (df == 0) {
-        df = 1; // Minimum df = 1
+    if (p >= 1.0) {
+        return HUGE_VAL;
+    }
+    if (df <= 1.0) {
+        return tan(M_PI * (p - 0.5));
     }
-    if (df > 30) {
-        df = 30; // Cap at 30
+    if (df <= 2.0) {
+        return (2.0 * p - 1.0) / sqrt(2.0 * p * (1.0 - p));
     }
 
-    size_t idx = df - 1;
-    if (confidence_level >= CONFIDENCE_LEVEL_99) {
-        return t_table[idx].t_99;
+    // expand the upper bound until it covers the quantile
+    double lo = 0.0;
+    double hi = 1.0;
+    while (hi < 100.0 && student_t_cdf(hi, df) < p) {
+        lo = hi;
+        hi *= 2.0;
     }
-    if (confidence_level >= CONFIDENCE_LEVEL_95) {
-        return t_table[idx].t_95;
+    for (int i = 0; i < 100 && hi - lo > STATS_EPSILON * hi; i++) {
+        double mid = (lo + hi) / 2.0;
+        if (student_t_cdf(mid, df) < p) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
     }
-    if (confidence_level >= CONFIDENCE_LEVEL_90) {
-        return t_table[idx].t_90;
+    return (lo + hi) / 2.0;
+}
+
+// Helper function to get t-value for given confidence level and degrees of
+// freedom
+static inline double get_t_value(size_t df, double confidence_level)
+{
+    if (df == 0) {
+        df = 1; // Minimum df = 1
     }
 
-    // For other confidence levels, interpolate between 90% and 95%
-    if (confidence_level > CONFIDENCE_LEVEL_90 &&
-        confidence_level < CONFIDENCE_LEVEL_95) {
-        double t90   = t_table[idx].t_90;
-        double t95   = t_table[idx].t_95;
-        double ratio = (confidence_level - CONFIDENCE_LEVEL_90) /
-                       (CONFIDENCE_LEVEL_95 - CONFIDENCE_LEVEL_90);
-        return t90 + ratio * (t95 - t90);
+    // Use t-table for small samples at the common confidence levels
+    if (df <= 30) {
+        size_t idx = df - 1;
+        if (confidence_level == CONFIDENCE_LEVEL_99) {
+            return t_table[idx].t_99;
+        }
+        if (confidence_level == CONFIDENCE_LEVEL_95) {
+            return t_table[idx].t_95;
+        }
+        if (confidence_level == CONFIDENCE_LEVEL_90) {
+            return t_table[idx].t_90;
+        }
     }
 
-    return t_table[idx].t_90; // Default to 90%
+    // two-sided critical value
+    return t_quantile((1.0 + confidence_level) / 2.0, (double)df);
 }
 
-
 // Helper function to check if a double value is valid (not NaN or Inf)
 static inline int is_valid_number(double value)
 {
@@ -0,0 +1,64 @@
+/**
+ *  Copyright (C) 2025 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "common.h"
+#include <lauxlib.h>
+#include <lua.h>
+
+// Lua binding for the two-sided critical value of the t-distribution
+static int critical_value_lua(lua_State *L)
+{
+    lua_Number level = luaL_checknumber(L, 1);
+    lua_Integer df   = luaL_checkinteger(L, 2);
+
+    luaL_argcheck(L, level >= 0 && level < 1, 1, "must be in [0, 1)");
+    luaL_argcheck(L, df >= 1, 2, "must be greater than 0");
+    lua_pushnumber(L, get_t_value((size_t)df, level));
+    return 1;
+}
+
+// Lua binding for the two-sided p-value of the t statistic
+static int p_value_lua(lua_State *L)
+{
+    lua_Number t  = luaL_checknumber(L, 1);
+    lua_Number df = luaL_checknumber(L, 2);
+
+    lua_pushnumber(L, calc_two_tailed_p_value(t, df));
+    return 1;
+}
+
+LUALIB_API int luaopen_measure_stats_tdist(lua_State *L)
+{
+    struct luaL_Reg funcs[] = {
+        {"critical_value", critical_value_lua},
+        {"p_value",        p_value_lua       },
+        {NULL,             NULL              }
+    };
+
+    lua_createtable(L, 0, 2);
+    for (struct luaL_Reg *ptr = funcs; ptr->name; ptr++) {
+        lua_pushcfunction(L, ptr->func);
+        lua_setfield(L, -2, ptr->name);
+    }
+    return 1;
+}
@@ -0,0 +1,59 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/utsname.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+static int uname_lua(lua_State *L)
+{
+    struct utsname u = {0};
+
+    if (uname(&u) == -1) {
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        lua_pushinteger(L, errno);
+        return 3;
+    }
+
+    lua_createtable(L, 0, 5);
+    lua_pushstring(L, u.sysname);
+    lua_setfield(L, -2, "sysname");
+    lua_pushstring(L, u.nodename);
+    lua_setfield(L, -2, "nodename");
+    lua_pushstring(L, u.release);
+    lua_setfield(L, -2, "release");
+    lua_pushstring(L, u.version);
+    lua_setfield(L, -2, "version");
+    lua_pushstring(L, u.machine);
+    lua_setfield(L, -2, "machine");
+    return 1;
+}
+
+LUALIB_API int luaopen_measure_uname(lua_State *L)
+{
+    lua_pushcfunction(L, uname_lua);
+    return 1;
+}
@@ -0,0 +1,304 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+/*
+ * VM instruction counter.
+ *
+ * A count hook that fires at every instruction counts the instructions
+ * executed on each source line of each Lua function. The hook cannot tell
+ * which instruction of the line is running, so the opcodes are classified
+ * by decoding the bytecode of the functions on the Lua side, and the
+ * functions are kept in a table of the registry to be returned by stop().
+ * The source of lua_Debug points to the source string of the function, which
+ * is kept alive by the table, so the lines are looked up by the pointer.
+ */
+
+// initial number of buckets of the line table
+#define LINE_NBUCKET 256
+
+typedef struct line_t {
+    struct line_t *next; // next line in the same bucket
+    const char *source;  // source of the function
+    int line;            // current line
+    int linedefined;     // line where the function is defined
+    size_t count;        // number of instructions executed
+    char short_src[LUA_IDSIZE];
+} line_t;
+
+typedef struct {
+    lua_State *L;  // thread the hook is set to
+    lua_Hook hook; // hook of the thread before the profile
+    int hookmask;  // mask of the hook before the profile
+    int hookcount; // count of the hook before the profile
+    int ref;       // reference of the table of the functions
+    line_t **buckets;
+    size_t nbucket;
+    size_t nline;
+    size_t ndropped; // number of instructions dropped by no memory
+} vmprof_t;
+
+// the running profile (only one profile at a time)
+static vmprof_t *PROF = NULL;
+
+static uint32_t line_hash(const char *source, int line, int linedefined)
+{
+    // FNV-1a of the pointer and the lines
+    uintptr_t v = (uintptr_t)source;
+    uint32_t h  = 2166136261u;
+    for (size_t i = 0; i < sizeof(v); i++, v >>= 8) {
+        h = (h ^ (uint32_t)(v & 0xff)) * 16777619u;
+    }
+    h = (h ^ (uint32_t)line) * 16777619u;
+    h = (h ^ (uint32_t)linedefined) * 16777619u;
+    return h;
+}
+
+static int grow_buckets(vmprof_t *p)
+{
+    size_t nbucket   = p->nbucket * 2;
+    line_t **buckets = calloc(nbucket, sizeof(line_t *));
+
+    if (!buckets) {
+        return -1;
+    }
+    for (size_t i = 0; i < p->nbucket; i++) {
+        line_t *l = p->buckets[i];
+        while (l) {
+            line_t *next = l->next;
+            uint32_t h   = line_hash(l->source, l->line, l->linedefined);
+            l->next      = buckets[h % nbucket];
+            buckets[h % nbucket] = l;
+            l                    = next;
+        }
+    }
+    free(p->buckets);
+    p->buckets = buckets;
+    p->nbucket = nbucket;
+    return 0;
+}
+
+/**
+ * @brief keep the running function in the table of the functions by the key
+ * of short_src:linedefined.
+ */
+static void keep_function(vmprof_t *p, lua_State *L, lua_Debug *ar)
+{
+    lua_rawgeti(L, LUA_REGISTRYINDEX, p->ref);
+    lua_pushfstring(L, "%s:%d", ar->short_src, ar->linedefined);
+    lua_rawget(L, -2);
+    if (lua_isnil(L, -1)) {
+        lua_pop(L, 1);
+        lua_pushfstring(L, "%s:%d", ar->short_src, ar->linedefined);
+        lua_getinfo(L, "f", ar);
+        lua_rawset(L, -3);
+        lua_pop(L, 1);
+        return;
+    }
+    lua_pop(L, 2);
+}
+
+/**
+ * @brief get the line of the function, or create it if not found.
+ * @return line_t* the line, or NULL if no memory.
+ */
+static line_t *get_line(vmprof_t *p, lua_State *L, lua_Debug *ar)
+{
+    uint32_t h = line_hash(ar->source, ar->currentline, ar->linedefined);
+    line_t *l  = p->buckets[h % p->nbucket];
+
+    for (; l; l = l->next) {
+        if (l->source == ar->source && l->line == ar->currentline &&
+            l->linedefined == ar->linedefined) {
+            return l;
+        }
+    }
+
+    if (p->nline >= p->nbucket && grow_buckets(p) == 0) {
+        h = line_hash(ar->source, ar->currentline, ar->linedefined);
+    }
+    if (!(l = calloc(1, sizeof(line_t)))) {
+        return NULL;
+    }
+    keep_function(p, L, ar);
+    memcpy(l->short_src, ar->short_src, sizeof(l->short_src));
+    l->source                  = ar->source;
+    l->line                    = ar->currentline;
+    l->linedefined             = ar->linedefined;
+    l->next                    = p->buckets[h % p->nbucket];
+    p->buckets[h % p->nbucket] = l;
+    p->nline++;
+    return l;
+}
+
+static void hook_fn(lua_State *L, lua_Debug *ar)
+{
+    vmprof_t *p = PROF;
+    line_t *l   = NULL;
+
+    if (!p || !lua_getinfo(L, "Sl", ar)) {
+        return;
+    } else if ((l = get_line(p, L, ar))) {
+        l->count++;
+    } else {
+        p->ndropped++;
+    }
+}
+
+static void free_prof(vmprof_t *p)
+{
+    for (size_t i = 0; i < p->nbucket; i++) {
+        line_t *l = p->buckets[i];
+        while (l) {
+            line_t *next = l->next;
+            free(l);
+            l = next;
+        }
+    }
+    free(p->buckets);
+    free(p);
+}
+
+static int start_lua(lua_State *L)
+{
+    vmprof_t *p = NULL;
+
+    if (PROF) {
+        lua_pushnil(L);
+        lua_pushliteral(L, "the profiler is already running");
+        return 2;
+    } else if (!(p = calloc(1, sizeof(vmprof_t))) ||
+               !(p->buckets = calloc(LINE_NBUCKET, sizeof(line_t *)))) {
+        free(p);
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    p->nbucket = LINE_NBUCKET;
+    p->L       = L;
+    lua_newtable(L);
+    p->ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    PROF         = p;
+    p->hook      = lua_gethook(L);
+    p->hookmask  = lua_gethookmask(L);
+    p->hookcount = lua_gethookcount(L);
+    lua_sethook(L, hook_fn, LUA_MASKCOUNT, 1);
+
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int cmp_line(const void *a, const void *b)
+{
+    const line_t *x = *(const line_t *const *)a;
+    const line_t *y = *(const line_t *const *)b;
+
+    if (x->count != y->count) {
+        return x->count > y->count ? -1 : 1;
+    }
+    return 0;
+}
+
+static int stop_lua(lua_State *L)
+{
+    vmprof_t *p   = PROF;
+    line_t **list = NULL;
+    size_t n      = 0;
+    size_t total  = 0;
+
+    if (!p) {
+        lua_pushnil(L);
+        lua_pushliteral(L, "the profiler is not running");
+        return 2;
+    }
+    // stop counting before the result is created
+    lua_sethook(p->L, p->hook, p->hookmask, p->hookcount);
+    PROF = NULL;
+
+    // sort the lines in descending order of the count
+    if (p->nline && !(list = malloc(sizeof(line_t *) * p->nline))) {
+        luaL_unref(L, LUA_REGISTRYINDEX, p->ref);
+        free_prof(p);
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        return 2;
+    }
+    for (size_t i = 0; i < p->nbucket; i++) {
+        for (line_t *l = p->buckets[i]; l; l = l->next) {
+            list[n++] = l;
+            total += l->count;
+        }
+    }
+    qsort(list, n, sizeof(line_t *), cmp_line);
+
+    lua_createtable(L, 0, 4);
+    lua_createtable(L, (int)n, 0);
+    for (size_t i = 0; i < n; i++) {
+        lua_createtable(L, 0, 4);
+        lua_pushstring(L, list[i]->short_src);
+        lua_setfield(L, -2, "source");
+        lua_pushinteger(L, list[i]->line);
+        lua_setfield(L, -2, "line");
+        lua_pushinteger(L, list[i]->linedefined);
+        lua_setfield(L, -2, "linedefined");
+        lua_pushinteger(L, (lua_Integer)list[i]->count);
+        lua_setfield(L, -2, "count");
+        lua_rawseti(L, -2, (int)i + 1);
+    }
+    lua_setfield(L, -2, "lines");
+    lua_rawgeti(L, LUA_REGISTRYINDEX, p->ref);
+    lua_setfield(L, -2, "functions");
+    lua_pushinteger(L, (lua_Integer)total);
+    lua_setfield(L, -2, "count");
+    lua_pushinteger(L, (lua_Integer)p->ndropped);
+    lua_setfield(L, -2, "dropped");
+
+    free(list);
+    luaL_unref(L, LUA_REGISTRYINDEX, p->ref);
+    free_prof(p);
+    return 1;
+}
+
+LUALIB_API int luaopen_measure_vmprof(lua_State *L)
+{
+    struct luaL_Reg funcs[] = {
+        {"start", start_lua},
+        {"stop",  stop_lua },
+        {NULL,    NULL     }
+    };
+
+    lua_createtable(L, 0, 2);
+    for (struct luaL_Reg *ptr = funcs; ptr->name; ptr++) {
+        lua_pushcfunction(L, ptr->func);
+        lua_setfield(L, -2, ptr->name);
+    }
+    return 1;
+}
@@ -0,0 +1,257 @@
+/**
+ *  Copyright (C) 2022 Masatoshi Fukunaga
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ *  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fnmatch.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+// lua
+#include <lauxlib.h>
+#include <lua.h>
+
+// lua_rawlen is not available in Lua 5.1
+#if LUA_VERSION_NUM < 502
+# define lua_rawlen(L, idx) lua_objlen(L, idx)
+#endif
+
+// identity of the directory being visited, used to detect symlink loops
+typedef struct walkdir_node_t {
+    dev_t dev;
+    ino_t ino;
+    struct walkdir_node_t *parent;
+} walkdir_node_t;
+
+typedef struct {
+    lua_State *L;
+    int recursive;   // descend into subdirectories
+    int include;     // stack index of the include patterns or 0
+    int exclude;     // stack index of the exclude patterns or 0
+    int result;      // stack index of the result table
+    int nresult;     // number of pathnames in the result table
+    size_t rootlen;  // length of the root pathname in the buffer
+    char buf[PATH_MAX];
+} walkdir_t;
+
+static int cmp_name(const void *a, const void *b)
+{
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+// Check whether the entry matches any of the patterns.
+// A pattern that contains a slash is matched against the pathname relative to
+// the root directory, otherwise it is matched against the entry name.
+static int match_patterns(walkdir_t *w, int idx, const char *relpath,
+                          const char *name)
+{
+    lua_State *L = w->L;
+    size_t n     = lua_rawlen(L, idx);
+
+    for (size_t i = 1; i <= n; i++) {
+        const char *pattern = NULL;
+        int matched         = 0;
+
+        lua_rawgeti(L, idx, (int)i);
+        pattern = lua_tostring(L, -1);
+        if (strchr(pattern, '/')) {
+            matched = fnmatch(pattern, relpath, FNM_PATHNAME) == 0;
+        } else {
+            matched = fnmatch(pattern, name, 0) == 0;
+        }
+        lua_pop(L, 1);
+        if (matched) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int is_visited(walkdir_node_t *node, struct stat *st)
+{
+    for (; node; node = node->parent) {
+        if (node->dev == st->st_dev && node->ino == st->st_ino) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int walk(walkdir_t *w, size_t len, walkdir_node_t *parent)
+{
+    lua_State *L       = w->L;
+    DIR *dir           = opendir(w->buf);
+    struct dirent *ent = NULL;
+    const char **names = NULL;
+    int nname          = 0;
+
+    if (!dir) {
+        lua_pushfstring(L, "failed to open directory %s: %s", w->buf,
+                        strerror(errno));
+        return -1;
+    }
+
+    // collect the entry names to sort them
+    luaL_checkstack(L, 4, "too many nested directories");
+    lua_newtable(L);
+    errno = 0;
+    while ((ent = readdir(dir))) {
+        if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+            lua_pushstring(L, ent->d_name);
+            lua_rawseti(L, -2, ++nname);
+        }
+    }
+    if (errno) {
+        int err = errno;
+        closedir(dir);
+        lua_pushfstring(L, "failed to read directory %s: %s", w->buf,
+                        strerror(err));
+        return -1;
+    }
+    closedir(dir);
+
+    // the name strings are kept alive by the table below the array
+    names = lua_newuserdata(L, sizeof(const char *) * (nname + 1));
+    for (int i = 0; i < nname; i++) {
+        lua_rawgeti(L, -2, i + 1);
+        names[i] = lua_tostring(L, -1);
+        lua_pop(L, 1);
+    }
+    qsort(names, nname, sizeof(const char *), cmp_name);
+
+    for (int i = 0; i < nname; i++) {
+        const char *name    = names[i];
+        size_t namelen      = strlen(name);
+        const char *relpath = w->buf + w->rootlen + 1;
+        struct stat st      = {0};
+        size_t newlen       = len;
+
+        // append the entry name to the pathname
+        if (len + namelen + 2 > sizeof(w->buf)) {
+            lua_pushfstring(L, "pathname too long: %s/%s", w->buf, name);
+            return -1;
+        }
+        if (len == 0 || w->buf[len - 1] != '/') {
+            w->buf[newlen++] = '/';
+        }
+        memcpy(w->buf + newlen, name, namelen + 1);
+        newlen += namelen;
+        if (w->rootlen == 0 || w->buf[w->rootlen - 1] == '/') {
+            relpath = w->buf + w->rootlen;
+        }
+
+        // follow symbolic links, and ignore broken links
+        if (stat(w->buf, &st) == 0 &&
+            !(w->exclude && match_patterns(w, w->exclude, relpath, name))) {
+            if (S_ISDIR(st.st_mode)) {
+                if (w->recursive && !is_visited(parent, &st)) {
+                    walkdir_node_t node = {
+                        .dev    = st.st_dev,
+                        .ino    = st.st_ino,
+                        .parent = parent,
+                    };
+                    if (walk(w, newlen, &node) != 0) {
+                        return -1;
+                    }
+                }
+            } else if (S_ISREG(st.st_mode) &&
+                       (!w->include ||
+                        match_patterns(w, w->include, relpath, name))) {
+                lua_pushlstring(L, w->buf, newlen);
+                lua_rawseti(L, w->result, ++w->nresult);
+            }
+        }
+        w->buf[len] = 0;
+    }
+    lua_pop(L, 2);
+
+    return 0;
+}
+
+static void check_patterns(lua_State *L, int idx)
+{
+    if (!lua_isnoneornil(L, idx)) {
+        size_t n = 0;
+
+        luaL_checktype(L, idx, LUA_TTABLE);
+        n = lua_rawlen(L, idx);
+        for (size_t i = 1; i <= n; i++) {
+            lua_rawgeti(L, idx, (int)i);
+            if (lua_type(L, -1) != LUA_TSTRING) {
+                luaL_argerror(L, idx, "patterns must be a list of strings");
+            }
+            lua_pop(L, 1);
+        }
+    }
+}
+
+static int walkdir_lua(lua_State *L)
+{
+    size_t len           = 0;
+    const char *pathname = luaL_checklstring(L, 1, &len);
+    struct stat st       = {0};
+    walkdir_node_t root  = {0};
+    walkdir_t w          = {
+        .L         = L,
+        .recursive = lua_toboolean(L, 2),
+    };
+
+    check_patterns(L, 3);
+    check_patterns(L, 4);
+    w.include = lua_istable(L, 3) ? 3 : 0;
+    w.exclude = lua_istable(L, 4) ? 4 : 0;
+    if (len >= sizeof(w.buf)) {
+        lua_pushnil(L);
+        lua_pushfstring(L, "pathname too long: %s", pathname);
+        lua_pushinteger(L, ENAMETOOLONG);
+        return 3;
+    } else if (stat(pathname, &st) == -1) {
+        lua_pushnil(L);
+        lua_pushstring(L, strerror(errno));
+        lua_pushinteger(L, errno);
+        return 3;
+    }
+    memcpy(w.buf, pathname, len + 1);
+    w.rootlen = len;
+    root.dev  = st.st_dev;
+    root.ino  = st.st_ino;
+
+    lua_settop(L, 4);
+    lua_newtable(L);
+    w.result = lua_gettop(L);
+    if (walk(&w, len, &root) != 0) {
+        lua_pushnil(L);
+        lua_insert(L, -2);
+        return 2;
+    }
+    lua_settop(L, w.result);
+    return 1;
+}
+
+LUALIB_API int luaopen_measure_walkdir(lua_State *L)
+{
+    lua_pushcfunction(L, walkdir_lua);
+    return 1;
+}
@@ -0,0 +1,79 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local allocator = require('measure.allocator')
+
+--- Allocate the objects of various sizes
+--- @param n integer
+--- @return table list
+local function allocate(n)
+    local list = {}
+    for i = 1, n do
+        list[i] = {
+            i,
+            string.rep('x', i % 300),
+            tostring(i),
+        }
+    end
+    return list
+end
+
+--- Check the objects allocated by allocate()
+--- @param list table
+--- @param n integer
+local function verify(list, n)
+    assert.equal(#list, n)
+    for i = 1, n do
+        local v = list[i]
+        assert.equal(v[1], i)
+        assert.equal(#v[2], i % 300)
+        assert.equal(v[3], tostring(i))
+    end
+end
+
+function testcase.use()
+    local ok, err = allocator.use('system')
+    if not ok then
+        -- the allocator cannot be replaced (e.g. LuaJIT on 64-bit platforms)
+        assert.match(err, 'cannot be replaced')
+        return
+    end
+    assert.equal(allocator.current(), 'system')
+
+    -- test that the objects survive switching the allocators
+    local before = allocate(1000)
+    for _, kind in ipairs({
+        'arena',
+        'pool',
+        'system',
+        'pool',
+        'arena',
+    }) do
+        assert(allocator.use(kind))
+        assert.equal(allocator.current(), kind)
+        local list = allocate(3000)
+        -- grow and shrink the blocks allocated by the other allocators
+        for i = 1, #before do
+            before[i][4] = string.rep('y', 100)
+        end
+        collectgarbage('collect')
+        verify(list, 3000)
+        for i = 1, #before do
+            before[i][4] = nil
+        end
+        verify(before, 1000)
+        -- free the blocks while the allocator is in use
+        list = nil
+        collectgarbage('collect')
+    end
+
+    assert(allocator.use('system'))
+    collectgarbage('collect')
+    verify(before, 1000)
+end
+
+function testcase.use_invalid()
+    -- test that throws an error for an unknown kind
+    local err = assert.throws(allocator.use, 'unknown')
+    assert.match(err, 'invalid option')
+end
@@ -0,0 +1,81 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local allocprof = require('measure.allocprof')
+
+--- Find the site of the line
+--- @param list table[] The sites
+--- @param line integer The line
+--- @return table? site
+local function find_line(list, line)
+    for _, v in ipairs(list) do
+        if v.source:find('allocprof_test.lua', 1, true) and v.line == line then
+            return v
+        end
+    end
+end
+
+function testcase.start_stop()
+    local base = debug.getinfo(1, 'l').currentline
+    assert(allocprof.start())
+    local list = {}
+    for i = 1, 100 do
+        list[i] = {} -- base + 4
+    end
+    local s = string.rep('x', 10000) -- base + 6
+    local sites = assert(allocprof.stop())
+    assert.equal(#s, 10000)
+
+    -- test that the allocations are attributed to the line
+    local v = find_line(sites, base + 4)
+    assert.greater_or_equal(v.count, 100)
+    assert.greater_or_equal(v.bytes, 100 * 32)
+    assert.equal(v.linedefined, debug.getinfo(1, 'S').linedefined)
+
+    -- test that the allocations of the C function are attributed to the
+    -- caller
+    v = find_line(sites, base + 6)
+    assert.greater_or_equal(v.bytes, 10000)
+
+    -- test that the sites are sorted by the bytes
+    for i = 2, #sites do
+        assert.greater_or_equal(sites[i - 1].bytes, sites[i].bytes)
+    end
+end
+
+function testcase.nested_function()
+    local function make()
+        return {
+            1,
+            2,
+            3,
+        }
+    end
+    local line = debug.getinfo(make, 'S').linedefined + 1
+    assert(allocprof.start())
+    local list = {}
+    for i = 1, 50 do
+        list[i] = make()
+    end
+    local sites = assert(allocprof.stop())
+    assert.equal(#list, 50)
+
+    -- test that the allocations are attributed to the line of the callee
+    local v = find_line(sites, line)
+    assert.greater_or_equal(v.count, 50)
+    assert.equal(v.linedefined, line - 1)
+end
+
+function testcase.errors()
+    -- test that the profiler cannot be started twice
+    assert(allocprof.start())
+    local ok, err = allocprof.start()
+    assert.is_nil(ok)
+    assert.match(err, 'already running')
+    assert(allocprof.stop())
+
+    -- test that the profiler must be running to stop
+    ok, err = allocprof.stop()
+    assert.is_nil(ok)
+    assert.match(err, 'not running')
+end
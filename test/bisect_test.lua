@@ -0,0 +1,71 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local bisect = require('measure.bisect')
+local mock_samples = require('./test/helpers/mock_samples')
+
+-- Import helper function
+local create_mock_samples = mock_samples.create_mock_samples
+
+--- Create the samples around the given mean
+--- @param mean number
+--- @return measure.samples
+local function make_samples(mean)
+    local values = {}
+    for i = 1, 30 do
+        values[i] = mean + (i % 5) * 10
+    end
+    return create_mock_samples(values)
+end
+
+function testcase.judge()
+    local good = make_samples(1000)
+
+    -- test that the significant slowdown is bad
+    local res = bisect.judge(good, make_samples(1200), 5)
+    assert.is_true(res.bad)
+    assert.equal(res.ratio, 1220 / 1020)
+    assert.less(res.p_value, 0.05)
+
+    -- test that the slowdown below the threshold is not bad
+    res = bisect.judge(good, make_samples(1030), 5)
+    assert.is_false(res.bad)
+    assert.less(res.p_value, 0.05)
+
+    -- test that the speedup is not bad
+    res = bisect.judge(good, make_samples(800), 5)
+    assert.is_false(res.bad)
+    assert.less(res.ratio, 1)
+
+    -- test that the same samples are not bad
+    res = bisect.judge(good, make_samples(1000), 0)
+    assert.is_false(res.bad)
+    assert.equal(res.ratio, 1)
+end
+
+function testcase.search()
+    -- test that the first bad revision is found for each position
+    for first_bad = 1, 10 do
+        local tested = {}
+        local idx = bisect.search(10, function(i)
+            tested[#tested + 1] = i
+            return i >= first_bad
+        end)
+        assert.equal(idx, first_bad)
+        assert.less_or_equal(#tested, 4)
+    end
+
+    -- test that no revision is tested if good and bad are adjacent
+    local idx = bisect.search(1, function()
+        error('must not be called')
+    end)
+    assert.equal(idx, 1)
+
+    -- test that the error of the test is returned
+    local err
+    idx, err = bisect.search(10, function()
+        return nil, 'test error'
+    end)
+    assert.is_nil(idx)
+    assert.equal(err, 'test error')
+end
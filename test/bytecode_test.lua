@@ -0,0 +1,95 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local bytecode = require('measure.bytecode')
+
+local function sample(t, k)
+    local v = t[k]
+    local s = 'x' .. v -- linedefined + 2
+    return function()
+        return s
+    end
+end
+
+function testcase.decode()
+    local info = debug.getinfo(sample, 'S')
+    local f = assert(bytecode.decode(string.dump(sample)))
+
+    -- test that the main function is decoded with its nested function
+    assert.equal(f.source, info.source)
+    assert.equal(f.linedefined, info.linedefined)
+    assert.equal(f.lastlinedefined, info.lastlinedefined)
+    assert.equal(#f.protos, 1)
+    assert.equal(f.protos[1].source, info.source)
+    assert.equal(f.protos[1].linedefined, info.linedefined + 3)
+
+    -- test that every instruction has the opcode and the line
+    assert.equal(#f.ops, #f.lines)
+    local ops = {}
+    for i, op in ipairs(f.ops) do
+        assert.not_equal(op, 'UNKNOWN')
+        assert.greater_or_equal(f.lines[i], info.linedefined)
+        assert.less_or_equal(f.lines[i], info.lastlinedefined)
+        ops[op] = f.lines[i]
+    end
+    assert.equal(ops.CONCAT, info.linedefined + 2)
+    -- the line of the closure is the line of 'function' or 'end' by version
+    assert.greater_or_equal(ops.CLOSURE, info.linedefined + 3)
+    assert.less_or_equal(ops.CLOSURE, info.linedefined + 5)
+end
+
+function testcase.decode_errors()
+    -- test that the invalid chunks are rejected
+    local f, err = bytecode.decode('return 1')
+    assert.is_nil(f)
+    assert.match(err, 'not a Lua bytecode')
+
+    f, err = bytecode.decode('\27Lua\1')
+    assert.is_nil(f)
+    assert.match(err, 'unsupported bytecode version')
+
+    local str = string.dump(sample)
+    f, err = bytecode.decode(str:sub(1, #str - 10))
+    assert.is_nil(f)
+    assert.match(err, 'truncated chunk')
+
+    -- test that the argument must be a string
+    err = assert.throws(bytecode.decode, 1)
+    assert.match(err, 'str must be a string')
+end
+
+function testcase.classify()
+    for op, class in pairs({
+        GETFIELD = 'table access',
+        GETTABUP = 'global access',
+        GETUPVAL = 'upvalue',
+        NEWTABLE = 'constructor',
+        CONCAT = 'string concat',
+        ADD = 'arithmetic',
+        LT = 'comparison',
+        FORLOOP = 'control flow',
+        CALL = 'call',
+        MOVE = 'load',
+    }) do
+        assert.equal(bytecode.classify(op), class)
+    end
+end
+
+function testcase.line_classes()
+    local line = debug.getinfo(sample, 'S').linedefined
+    local lines = assert(bytecode.line_classes(sample))
+
+    -- test that the instructions are classified on each line
+    assert.equal(lines[line + 1]['table access'], 1)
+    assert.equal(lines[line + 2]['string concat'], 1)
+    local n = 0
+    for i = line + 3, line + 5 do
+        n = n + (lines[i] and lines[i]['constructor'] or 0)
+    end
+    assert.equal(n, 1)
+
+    -- test that C functions cannot be dumped
+    local res, err = bytecode.line_classes(print)
+    assert.is_nil(res)
+    assert.is_string(err)
+end
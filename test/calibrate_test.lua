@@ -0,0 +1,31 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local calibrate = require('measure.calibrate')
+
+function testcase.calibrate()
+    -- test that return the jitter statistics of the constant workload
+    local res = calibrate(100, 100)
+    assert.equal(res.rounds, 100)
+    assert.greater(res.median, 0)
+    assert.less_or_equal(res.min, res.median)
+    assert.greater_or_equal(res.max, res.median)
+    assert.greater(res.mean, 0)
+    assert.greater_or_equal(res.stddev, 0)
+    assert.greater_or_equal(res.cv, 0)
+    assert.greater_or_equal(res.spike_rate, 0)
+    assert.less_or_equal(res.spike_rate, 100)
+
+    -- test that default arguments are used
+    res = calibrate()
+    assert.equal(res.rounds, 1000)
+end
+
+function testcase.calibrate_invalid_arguments()
+    -- test that throw error if the arguments are invalid
+    local err = assert.throws(calibrate, 9)
+    assert.match(err, 'rounds must be at least 10')
+
+    err = assert.throws(calibrate, 10, 0)
+    assert.match(err, 'work must be greater than 0')
+end
@@ -0,0 +1,102 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local census = require('measure.census')
+
+local RETAINED = {}
+
+local function find_site(list, pattern)
+    for _, v in ipairs(list) do
+        if v.site and v.site:find(pattern) then
+            return v
+        end
+    end
+end
+
+function testcase.census()
+    -- test that the objects are counted by type
+    collectgarbage('collect')
+    local c = census.census()
+    for _, t in ipairs({
+        'table',
+        'function',
+        'string',
+    }) do
+        assert.greater(c.types[t].count, 0)
+        assert.greater(c.types[t].size, 0)
+    end
+
+    -- test that the globals are attributed to their names
+    local e = c.sites['table _G.package']
+    assert.equal(e.type, 'table')
+    assert.equal(e.site, '_G.package')
+    assert.greater(e.size, 0)
+end
+
+function testcase.diff()
+    collectgarbage('collect')
+    local before = census.census()
+    local function keep()
+        RETAINED[#RETAINED + 1] = {
+            n = #RETAINED,
+        }
+    end
+    _G.census_test_keep = keep
+    for _ = 1, 100 do
+        keep()
+    end
+    collectgarbage('collect')
+    local after = census.census()
+    _G.census_test_keep = nil
+
+    -- test that the retained tables are reported by type
+    local res = census.diff(before, after)
+    local tables
+    for _, v in ipairs(res.types) do
+        if v.type == 'table' then
+            tables = v
+        end
+    end
+    assert.greater_or_equal(tables.count, 100)
+    assert.equal(tables.count, tables.after - tables.before)
+    assert.greater(tables.size, 0)
+
+    -- test that the retained tables are attributed to the upvalue
+    local v = find_site(res.sites, 'upvalue RETAINED')
+    assert.equal(v.type, 'table')
+    assert.greater_or_equal(v.count, 100)
+    assert.match(v.site, 'census_test.lua:%d+ %(upvalue RETAINED%)', false)
+
+    -- test that the function is attributed to its definition
+    v = find_site(res.sites, 'census_test.lua:' ..
+                      debug.getinfo(keep, 'S').linedefined .. '$')
+    assert.equal(v.type, 'function')
+    assert.equal(v.count, 1)
+
+    -- test that the sites are sorted by the size
+    for i = 2, #res.sites do
+        assert.greater_or_equal(res.sites[i - 1].size, res.sites[i].size)
+    end
+end
+
+function testcase.weak_table()
+    collectgarbage('collect')
+    local before = census.census()
+    local cache = setmetatable({}, {
+        __mode = 'v',
+    })
+    _G.census_test_cache = cache
+    local strong = {}
+    for i = 1, 10 do
+        strong[i] = {}
+        cache[i] = strong[i]
+    end
+    local after = census.census()
+    _G.census_test_cache = nil
+
+    -- test that the values of the weak table are not retained by it
+    local res = census.diff(before, after)
+    local v = find_site(res.sites, '^_G.census_test_cache$')
+    assert.equal(v.count, 2)
+    assert.is_nil(strong[11])
+end
@@ -0,0 +1,51 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local cpuprof = require('measure.cpuprof')
+
+local function spin()
+    local t = os.clock()
+    local n = 0
+    while os.clock() - t < 0.2 do
+        n = n + 1
+    end
+    return n
+end
+
+function testcase.start_stop()
+    -- test that the stacks are sampled every interval of the CPU time
+    assert(cpuprof.start(1000))
+    spin()
+    local res = assert(cpuprof.stop())
+    assert.greater(res.samples, 10)
+    assert.equal(res.dropped, 0)
+
+    local total = 0
+    local found = false
+    for _, v in ipairs(res.stacks) do
+        total = total + v.count
+        if v.stack:find('spin [^;]*cpuprof_test%.lua:6') then
+            found = true
+        end
+    end
+    assert.equal(total, res.samples)
+    assert.is_true(found)
+end
+
+function testcase.errors()
+    -- test that the profiler cannot be started twice
+    assert(cpuprof.start())
+    local ok, err = cpuprof.start()
+    assert.is_nil(ok)
+    assert.match(err, 'already running')
+    assert(cpuprof.stop())
+
+    -- test that the profiler must be running to stop
+    ok, err = cpuprof.stop()
+    assert.is_nil(ok)
+    assert.match(err, 'not running')
+
+    -- test that the interval must be positive
+    err = assert.throws(cpuprof.start, 0)
+    assert.match(err, 'interval must be')
+end
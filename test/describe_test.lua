@@ -17,6 +17,21 @@ function testcase.constructor()
     assert.equal(desc.spec.name, 'test benchmark')
 end
 
+function testcase.constructor_fileinfo()
+    -- Test that the file information of the caller is recorded
+    local desc = assert(new_describe('test benchmark'))
+    local lineno = debug.getinfo(1, 'l').currentline - 1
+    assert.is_table(desc.fileinfo)
+    assert.match(desc.fileinfo.source, '^@.*describe_test%.lua$', false)
+    assert.match(desc.fileinfo.pathname, '^/.*/describe_test%.lua$', false)
+    assert.equal(desc.fileinfo.lineno, lineno)
+
+    -- Test that the file information is resolved from the cached pathname
+    local desc2 = assert(new_describe('test benchmark'))
+    assert.equal(desc2.fileinfo.pathname, desc.fileinfo.pathname)
+    assert.equal(desc2.fileinfo.lineno, lineno + 8)
+end
+
 function testcase.constructor_invalid()
     -- Test invalid arguments
     local desc, err = new_describe(123)
@@ -103,6 +118,48 @@ function testcase.run_with_timer()
     })
 end
 
+function testcase.require()
+    -- Test valid call
+    local desc = assert(new_describe('test'))
+    local ok, err = desc:require('foo.bar')
+    assert.is_true(ok)
+    assert.is_nil(err)
+    assert.equal(desc.spec.require, 'foo.bar')
+
+    -- Test invalid argument type
+    desc = assert(new_describe('test'))
+    ok, err = desc:require(create_dummy_fn())
+    assert.is_false(ok)
+    assert.equal(err, 'argument must be a string')
+
+    -- Test cannot define twice
+    desc = assert(new_describe('test'))
+    assert(desc:require('foo'))
+    ok, err = desc:require('foo')
+    assert.is_false(ok)
+    assert.equal(err, 'cannot be defined twice')
+
+    -- Test cannot be combined with run(), run_with_timer() and setup()
+    for method, errmsg in pairs({
+        run = 'cannot be defined if run() or run_with_timer() is defined',
+        run_with_timer = 'cannot be defined if run() or run_with_timer() is defined',
+        setup = 'cannot be defined if setup() or setup_once() is defined',
+        setup_once = 'cannot be defined if setup() or setup_once() is defined',
+    }) do
+        desc = assert(new_describe('test'))
+        assert(desc[method](desc, create_dummy_fn()))
+        ok, err = desc:require('foo')
+        assert.is_false(ok)
+        assert.equal(err, errmsg)
+
+        desc = assert(new_describe('test'))
+        assert(desc:require('foo'))
+        ok, err = desc[method](desc, create_dummy_fn())
+        assert.is_false(ok)
+        assert.equal(err, 'cannot be defined if require() is defined')
+    end
+end
+
 function testcase.teardown()
     local teardown_fn = create_dummy_fn()
 
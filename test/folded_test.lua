@@ -0,0 +1,130 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local folded = require('measure.folded')
+
+local STACKS = {
+    {
+        stack = 'main a.lua;run a.lua:3;encode b.lua:10',
+        count = 6,
+    },
+    {
+        stack = 'main a.lua;run a.lua:3',
+        count = 1,
+    },
+    {
+        stack = 'main a.lua;run a.lua:3;concat [C]',
+        count = 3,
+    },
+    {
+        stack = 'main a.lua;f a.lua:9;f a.lua:9',
+        count = 2,
+    },
+}
+
+function testcase.encode()
+    -- test that the stacks are sorted and followed by the count
+    assert.equal(folded.encode(STACKS), table.concat({
+        'main a.lua;f a.lua:9;f a.lua:9 2\n',
+        'main a.lua;run a.lua:3 1\n',
+        'main a.lua;run a.lua:3;concat [C] 3\n',
+        'main a.lua;run a.lua:3;encode b.lua:10 6\n',
+    }))
+    assert.equal(folded.encode({}), '')
+end
+
+function testcase.summarize()
+    -- test that the frames are sorted by the self samples
+    local list = folded.summarize(STACKS)
+    assert.equal(list, {
+        {
+            frame = 'encode b.lua:10',
+            self = 6,
+            total = 6,
+        },
+        {
+            frame = 'concat [C]',
+            self = 3,
+            total = 3,
+        },
+        {
+            frame = 'f a.lua:9',
+            self = 2,
+            total = 2,
+        },
+        {
+            frame = 'run a.lua:3',
+            self = 1,
+            total = 10,
+        },
+        {
+            frame = 'main a.lua',
+            self = 0,
+            total = 12,
+        },
+    })
+
+    -- test that the list is truncated to the top frames
+    list = folded.summarize(STACKS, 2)
+    assert.equal(#list, 2)
+    assert.equal(list[2].frame, 'concat [C]')
+end
+
+function testcase.strip()
+    -- test that the leading frames of the caller are removed and merged
+    local list = folded.strip({
+        {
+            stack = 'main m.lua;run m.lua:5;pcall [C];? m.lua:9;f a.lua:9',
+            count = 2,
+        },
+        {
+            stack = 'main m.lua;run m.lua:5;sampler [C];f a.lua:9',
+            count = 3,
+        },
+        {
+            stack = 'main m.lua;run m.lua:5;f a.lua:9;concat [C]',
+            count = 1,
+        },
+        {
+            stack = 'main m.lua;run m.lua:5',
+            count = 4,
+        },
+    }, 'm.lua')
+    assert.equal(list, {
+        {
+            stack = 'f a.lua:9',
+            count = 5,
+        },
+        {
+            stack = 'f a.lua:9;concat [C]',
+            count = 1,
+        },
+        {
+            stack = 'main m.lua;run m.lua:5',
+            count = 4,
+        },
+    })
+end
+
+function testcase.strip_sources()
+    -- test that the leading frames of any of the sources are removed
+    local list = folded.strip({
+        {
+            stack = 'main m.lua;run m.lua:5;f r.lua:9;pcall [C];f a.lua:9',
+            count = 2,
+        },
+        {
+            stack = 'main m.lua;f a.lua:9',
+            count = 3,
+        },
+    }, {
+        ['m.lua'] = true,
+        ['r.lua'] = true,
+    })
+    assert.equal(list, {
+        {
+            stack = 'f a.lua:9',
+            count = 5,
+        },
+    })
+end
@@ -0,0 +1,48 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local forkrun = require('measure.forkrun')
+
+function testcase.forkrun()
+    -- test that return the string returned by the function in the child
+    local res, err = forkrun(function(a, b)
+        return a .. b
+    end, 'foo', 'bar')
+    assert.is_nil(err)
+    assert.equal(res, 'foobar')
+
+    -- test that the changes in the child do not affect the parent
+    local counter = 0
+    res = assert(forkrun(function()
+        counter = counter + 1
+        return tostring(counter)
+    end))
+    assert.equal(res, '1')
+    assert.equal(counter, 0)
+
+    -- test that return the large result
+    res = assert(forkrun(function()
+        return string.rep('x', 1024 * 1024)
+    end))
+    assert.equal(#res, 1024 * 1024)
+end
+
+function testcase.forkrun_error()
+    -- test that return the error raised in the child
+    local res, err = forkrun(function()
+        error('oops', 0)
+    end)
+    assert.is_nil(res)
+    assert.match(err, 'child process failed: oops')
+
+    -- test that return an error if the function does not return a string
+    res, err = forkrun(function()
+        return 123
+    end)
+    assert.is_nil(res)
+    assert.match(err, 'function must return a string')
+
+    -- test that throws an error if the argument is not a function
+    err = assert.throws(forkrun, 'foo')
+    assert.match(err, 'function expected')
+end
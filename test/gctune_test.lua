@@ -0,0 +1,90 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local gctune = require('measure.gctune')
+
+function testcase.candidates()
+    -- test that the first candidate keeps the default parameters
+    local list = gctune.candidates(false)
+    assert.equal(list[1], {
+        label = 'default',
+    })
+    assert.equal(#list, 16)
+    for i = 2, #list do
+        assert.equal(list[i].mode, 'incremental')
+        assert.is_uint(list[i].params.pause)
+        assert.is_uint(list[i].params.stepmul)
+    end
+    assert.equal(list[2].label, 'incremental pause=100 stepmul=100')
+
+    -- test that the generational candidates are appended
+    list = gctune.candidates(true)
+    assert.equal(#list, 25)
+    assert.equal(list[17].mode, 'generational')
+    assert.equal(list[17].label, 'generational minormul=10 majormul=50')
+end
+
+function testcase.apply()
+    -- test that the incremental parameters are applied
+    local pause = collectgarbage('setpause', 200)
+    gctune.apply({
+        label = 'incremental pause=150 stepmul=400',
+        mode = 'incremental',
+        params = {
+            pause = 150,
+            stepmul = 400,
+        },
+    })
+    -- Lua 5.4 stores the parameters in the units of 4%
+    local v = collectgarbage('setpause', pause)
+    assert.less_or_equal(math.abs(v - 150), 4)
+end
+
+function testcase.select_best()
+    local points = {
+        {
+            mean = 100,
+            p99 = 300,
+            peak_kb = 500,
+        },
+        {
+            mean = 80,
+            p99 = 120,
+            peak_kb = 900,
+        },
+        {
+            mean = 90,
+            p99 = 100,
+            peak_kb = 700,
+        },
+        {
+            mean = 120,
+            p99 = 130,
+            peak_kb = 600,
+        },
+    }
+
+    -- test that the fastest point is selected without the limit
+    local best, curve = gctune.select_best(points, 'mean')
+    assert.equal(best, 2)
+    assert.equal(curve, {
+        1,
+        3,
+        2,
+    })
+
+    -- test that the points over the limit are not selected
+    best = gctune.select_best(points, 'mean', 800)
+    assert.equal(best, 3)
+    best, curve = gctune.select_best(points, 'p99', 650)
+    assert.equal(best, 4)
+    assert.equal(curve, {
+        1,
+        4,
+        3,
+    })
+
+    -- test that no point is selected if all are over the limit
+    best = gctune.select_best(points, 'mean', 100)
+    assert.is_nil(best)
+end
@@ -0,0 +1,19 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local getcwd = require('measure.getcwd')
+local chdir = require('chdir')
+
+function testcase.getcwd()
+    -- test that return the absolute pathname of the working directory
+    local cwd, err = getcwd()
+    assert.is_nil(err)
+    assert.match(cwd, '^/', false)
+
+    -- test that return the changed working directory
+    assert(chdir('/'))
+    local dir = getcwd()
+    assert(chdir(cwd))
+    assert.equal(dir, '/')
+    assert.equal(getcwd(), cwd)
+end
@@ -0,0 +1,48 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local hostinfo = require('measure.hostinfo')
+
+function testcase.hostinfo()
+    local info, err = hostinfo()
+    if not info then
+        -- not supported on this platform
+        assert.match(err, 'not supported')
+        return
+    end
+
+    -- test that return the cpu and memory information
+    assert.is_table(info.cpu)
+    assert.greater(info.cpu.threads, 0)
+    assert.greater(info.cpu.cores, 0)
+    assert.less_or_equal(info.cpu.cores, info.cpu.threads)
+    if info.cpu.llc_kb then
+        -- test that the last-level cache is found in sysfs
+        assert.greater(info.cpu.llc_kb, 0)
+        assert.greater(info.cpu.llc_level, 0)
+    end
+    assert.is_table(info.memory)
+    assert.greater(info.memory.total_kb, 0)
+    assert.greater(info.online, 0)
+
+    -- test that return the load average
+    assert.is_table(info.loadavg)
+    assert.equal(#info.loadavg, 3)
+    for _, v in ipairs(info.loadavg) do
+        assert.greater_or_equal(v, 0)
+    end
+
+    -- test that the tuning fields have the expected types if available
+    if info.governor then
+        assert.match(info.governor, '^[%w_,]+$', false)
+    end
+    if info.boost ~= nil then
+        assert.is_boolean(info.boost)
+    end
+    if info.smt then
+        assert.is_string(info.smt)
+    end
+    if info.isolated then
+        assert.is_string(info.isolated)
+    end
+end
@@ -0,0 +1,120 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local new_jittrace = require('measure.jittrace')
+
+--- Replace the jit modules with the fakes while the function runs
+--- @param fn function The function to run with the fake jit module
+local function with_fake_jit(fn)
+    local handlers = {}
+    local fake = {
+        attach = function(handler, what)
+            if what then
+                handlers[#handlers + 1] = handler
+                return
+            end
+            for i, v in ipairs(handlers) do
+                if v == handler then
+                    table.remove(handlers, i)
+                end
+            end
+        end,
+    }
+    local saved = {
+        jit = rawget(_G, 'jit'),
+        util = package.loaded['jit.util'],
+        vmdef = package.loaded['jit.vmdef'],
+        profile = package.loaded['jit.profile'],
+    }
+    rawset(_G, 'jit', fake)
+    package.loaded['jit.util'] = {
+        funcinfo = function(_, pc)
+            return {
+                loc = 'bench.lua:' .. tostring(pc),
+            }
+        end,
+    }
+    package.loaded['jit.vmdef'] = {
+        traceerr = {
+            [7] = 'NYI: bytecode %d',
+        },
+        ffnames = {},
+    }
+    package.loaded['jit.profile'] = nil
+
+    local ok, err = pcall(fn, handlers)
+    rawset(_G, 'jit', saved.jit)
+    package.loaded['jit.util'] = saved.util
+    package.loaded['jit.vmdef'] = saved.vmdef
+    package.loaded['jit.profile'] = saved.profile
+    assert(ok, err)
+end
+
+function testcase.not_luajit()
+    if rawget(_G, 'jit') then
+        return
+    end
+    -- test that the recorder is not available without LuaJIT
+    local rec, err = new_jittrace()
+    assert.is_nil(rec)
+    assert.match(err, 'not LuaJIT')
+end
+
+function testcase.trace_events()
+    with_fake_jit(function(handlers)
+        local rec = assert(new_jittrace())
+        local fn = function()
+        end
+        rec:start()
+        assert.equal(#handlers, 1)
+
+        -- test that the events are counted by phase
+        handlers[1]('start', 1, fn, 3)
+        handlers[1]('abort', 1, fn, 5, 7, 51)
+        handlers[1]('start', 2, fn, 3)
+        handlers[1]('stop', 2)
+        rec:set_phase('sampling')
+        handlers[1]('start', 3, fn, 3)
+        handlers[1]('abort', 3, fn, 5, 7, 51)
+        handlers[1]('abort', 4, fn, 5, 7, 51)
+        handlers[1]('abort', 5, fn, 8, 'custom error')
+        handlers[1]('flush')
+        local res = rec:stop()
+        assert.equal(#handlers, 0)
+
+        assert.equal(res.phases.warmup, {
+            started = 2,
+            completed = 1,
+            aborted = 1,
+            flushed = 0,
+        })
+        assert.equal(res.phases.sampling, {
+            started = 1,
+            completed = 0,
+            aborted = 3,
+            flushed = 1,
+        })
+
+        -- test that the aborts are grouped by reason and location
+        assert.equal(res.aborts, {
+            {
+                phase = 'sampling',
+                reason = 'NYI: bytecode 51',
+                location = 'bench.lua:5',
+                count = 2,
+            },
+            {
+                phase = 'warmup',
+                reason = 'NYI: bytecode 51',
+                location = 'bench.lua:5',
+                count = 1,
+            },
+            {
+                phase = 'sampling',
+                reason = 'custom error',
+                location = 'bench.lua:8',
+                count = 1,
+            },
+        })
+    end)
+end
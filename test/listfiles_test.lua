@@ -120,4 +120,71 @@ function testcase.listfiles_with_invalid_type()
     local ok, err = pcall(listfiles, nil)
     assert.is_false(ok)
     assert.match(err, 'pathname must be a string')
+
+    -- Test with invalid options
+    ok, err = pcall(listfiles, TMPDIR, 'foo')
+    assert.is_false(ok)
+    assert.match(err, 'opts must be a table')
+
+    ok, err = pcall(listfiles, TMPDIR, {
+        include = 'foo',
+    })
+    assert.is_false(ok)
+    assert.match(err, 'opts.include must be a table')
+
+    ok, err = pcall(listfiles, TMPDIR, {
+        exclude = {
+            1,
+        },
+    })
+    assert.is_false(ok)
+    assert.match(err, 'opts.exclude#1 must be a string')
+end
+
+function testcase.listfiles_recursive()
+    -- Test that the files in subdirectories are listed in sorted order
+    local files, err = listfiles(TMPDIR, {
+        recursive = true,
+    })
+    assert.is_nil(err)
+    assert.equal(files, {
+        TMPDIR .. '/dir/another_bench.lua',
+        TMPDIR .. '/dir/subdir/sub_bench.lua',
+        TMPDIR .. '/dir/test1_bench.lua',
+        TMPDIR .. '/dir/test2_bench.lua',
+        TMPDIR .. '/single_bench.lua',
+        TMPDIR .. '/space dir/my_bench.lua',
+    })
+end
+
+function testcase.listfiles_with_patterns()
+    -- Test with include patterns
+    local files, err = listfiles(TMPDIR .. '/dir', {
+        include = {
+            'test*_bench.lua',
+            'notbench.lua',
+        },
+    })
+    assert.is_nil(err)
+    assert.equal(files, {
+        TMPDIR .. '/dir/notbench.lua',
+        TMPDIR .. '/dir/test1_bench.lua',
+        TMPDIR .. '/dir/test2_bench.lua',
+    })
+
+    -- Test with exclude patterns that prune the directories
+    files, err = listfiles(TMPDIR, {
+        recursive = true,
+        exclude = {
+            'subdir',
+            'space dir/*',
+            'test2_*',
+        },
+    })
+    assert.is_nil(err)
+    assert.equal(files, {
+        TMPDIR .. '/dir/another_bench.lua',
+        TMPDIR .. '/dir/test1_bench.lua',
+        TMPDIR .. '/single_bench.lua',
+    })
 end
@@ -0,0 +1,49 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local loadcost = require('measure.loadcost')
+
+function testcase.loadcost()
+    -- test that measure the cost of require() in a new Lua state
+    local res, err = loadcost('measure.stats.coldstart', package.path,
+                              package.cpath)
+    assert.is_nil(err)
+    assert.is_uint(res.time_ns)
+    assert.greater(res.time_ns, 0)
+    assert.is_uint(res.before_kb)
+    assert.greater_or_equal(res.after_kb, res.before_kb)
+    assert.is_number(res.retained_kb)
+    assert.equal(res.modules, {
+        'measure.stats.coldstart',
+    })
+    if res.rss_kb then
+        assert.is_number(res.rss_kb)
+    end
+
+    -- test that the transitive modules are listed
+    res = assert(loadcost('measure.stats.hierarchical', package.path,
+                          package.cpath))
+    table.sort(res.modules)
+    assert.equal(res.modules, {
+        'measure.quantile',
+        'measure.stats.hierarchical',
+        'measure.stats.tdist',
+    })
+
+    -- test that the module is not loaded into the current state
+    package.loaded['measure.stats.coldstart'] = nil
+    assert(loadcost('measure.stats.coldstart', package.path, package.cpath))
+    assert.is_nil(package.loaded['measure.stats.coldstart'])
+end
+
+function testcase.loadcost_error()
+    -- test that return an error if the module is not found
+    local res, err = loadcost('measure.no_such_module', package.path,
+                              package.cpath)
+    assert.is_nil(res)
+    assert.match(err, "module 'measure.no_such_module' not found")
+
+    -- test that throws an error if the module name is not a string
+    err = assert.throws(loadcost)
+    assert.match(err, 'string expected')
+end
@@ -146,3 +146,46 @@ function testcase.valid_file_loading()
     assert.is_table(result.spec)
     assert.match(result.filename, 'valid_bench.lua')
 end
+
+function testcase.dependencies()
+    -- Test that the Lua modules required by the file are recorded
+    create_test_file('tmp/deps_helper_sub.lua', [[
+return 'sub'
+]])
+    create_test_file('tmp/deps_helper.lua', [[
+return require('deps_helper_sub')
+]])
+    create_test_file('tmp/deps_bench.lua', [[
+local measure = require('measure')
+local helper = require('deps_helper')
+measure.describe("deps_test").run(function()
+    return helper
+end)
+]])
+    local path = package.path
+    package.path = './tmp/?.lua;' .. path
+    local result, err = loadfile('tmp/deps_bench.lua')
+    package.path = path
+    assert.is_nil(err)
+    assert.equal(result.deps, {
+        deps_helper = './tmp/deps_helper.lua',
+        deps_helper_sub = './tmp/deps_helper_sub.lua',
+    })
+
+    -- Test that the dependencies of the loaded modules are also recorded
+    create_test_file('tmp/deps2_bench.lua', [[
+local measure = require('measure')
+local helper = require('deps_helper')
+measure.describe("deps_test").run(function()
+    return helper
+end)
+]])
+    result, err = loadfile('tmp/deps2_bench.lua')
+    assert.is_nil(err)
+    assert.equal(result.deps, {
+        deps_helper = './tmp/deps_helper.lua',
+        deps_helper_sub = './tmp/deps_helper_sub.lua',
+    })
+    package.loaded.deps_helper = nil
+    package.loaded.deps_helper_sub = nil
+end
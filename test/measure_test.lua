@@ -452,3 +452,8 @@ function testcase.actual_measure_complete_workflow()
 
     assert.is_true(true) -- Workflow completed successfully
 end
+
+function testcase.mmap()
+    -- Test that measure.mmap is the constructor of measure.mmap
+    assert.equal(measure.mmap, require('measure.mmap'))
+end
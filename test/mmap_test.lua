@@ -0,0 +1,103 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local unpack = table.unpack or unpack
+local new_mmap = require('measure.mmap')
+
+local PATHNAME
+local DATA = 'hello mmap world'
+
+function testcase.before_all()
+    PATHNAME = os.tmpname()
+    local f = assert(io.open(PATHNAME, 'w'))
+    f:write(DATA)
+    f:close()
+end
+
+function testcase.after_all()
+    os.remove(PATHNAME)
+end
+
+function testcase.new()
+    -- test that map the file
+    local m = assert(new_mmap(PATHNAME))
+    assert.match(tostring(m), '^measure%.mmap: ', false)
+    assert.equal(#m, #DATA)
+    assert.equal(m:len(), #DATA)
+    m:close()
+
+    -- test that map the empty file
+    local pathname = os.tmpname()
+    assert(io.open(pathname, 'w')):close()
+    m = assert(new_mmap(pathname))
+    os.remove(pathname)
+    assert.equal(#m, 0)
+    assert.equal(m:sub(), '')
+    assert.is_nil(m:byte(1))
+
+    -- test that return an error for the missing file
+    local err
+    m, err = new_mmap(PATHNAME .. '.missing')
+    assert.is_nil(m)
+    assert.match(err, 'No such file')
+
+    -- test that throw an error with invalid argument
+    assert.throws(new_mmap)
+end
+
+function testcase.byte()
+    local m = assert(new_mmap(PATHNAME))
+
+    -- test that return the bytes as string.byte()
+    for _, v in ipairs({
+        {},
+        {1},
+        {5},
+        {-1},
+        {2, 4},
+        {-3, -1},
+        {0, 3},
+        {10, 3},
+        {#DATA + 1},
+        {-100, 2},
+    }) do
+        assert.equal({m:byte(unpack(v))}, {DATA:byte(unpack(v))})
+    end
+end
+
+function testcase.sub()
+    local m = assert(new_mmap(PATHNAME))
+
+    -- test that return the whole contents without arguments
+    assert.equal(m:sub(), DATA)
+
+    -- test that return the substring as string.sub()
+    for _, v in ipairs({
+        {1},
+        {7},
+        {-5},
+        {1, 5},
+        {7, -7},
+        {0, 3},
+        {10, 3},
+        {-100, 100},
+        {#DATA + 1},
+    }) do
+        assert.equal(m:sub(unpack(v)), DATA:sub(unpack(v)))
+    end
+end
+
+function testcase.close()
+    local m = assert(new_mmap(PATHNAME))
+
+    -- test that throw an error after closed
+    m:close()
+    m:close()
+    local err = assert.throws(function()
+        m:sub()
+    end)
+    assert.match(err, 'closed buffer')
+    assert.throws(function()
+        return #m
+    end)
+end
@@ -0,0 +1,37 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local allocators = require('measure.mode.allocators')
+
+function testcase.allocators()
+    -- test that return the merged samples of each allocator
+    local list, err, kinds = allocators({
+        spec = {
+            name = 'test',
+            run = function()
+                local t = {}
+                for i = 1, 100 do
+                    t[i] = {}
+                end
+            end,
+        },
+    }, {
+        context = {},
+        warmup = 0,
+        gc_step = 0,
+        confidence_level = 95,
+        rciw = 5,
+        sample_size = 10,
+    }, {
+        'system',
+        'pool',
+    })
+    assert.is_nil(err)
+    assert.equal(kinds, {
+        'system',
+        'pool',
+    })
+    assert.equal(#list, 2)
+    assert.equal(list[1]:name(), 'test [system]')
+    assert.equal(list[2]:name(), 'test [pool]')
+end
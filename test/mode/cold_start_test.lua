@@ -0,0 +1,26 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local cold_start = require('measure.mode.cold_start')
+
+function testcase.cold_start()
+    -- test that measure the first invocations in each child process
+    local list = assert(cold_start({
+        spec = {
+            name = 'test',
+            run = function()
+            end,
+        },
+    }, {
+        context = {},
+        warmup = 1,
+        gc_step = 0,
+        confidence_level = 95,
+        rciw = 5,
+        forks = 2,
+    }, 3))
+    assert.equal(#list, 2)
+    for _, samples in ipairs(list) do
+        assert.equal(#samples, 3)
+    end
+end
@@ -0,0 +1,42 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local leak_check = require('measure.mode.leak_check')
+
+local OPTS = {
+    context = {},
+    warmup = 0,
+    gc_step = 0,
+    confidence_level = 95,
+    rciw = 5,
+}
+
+function testcase.leak_check()
+    -- test that detect the memory retained on each invocation
+    local retained = {}
+    local res = assert(leak_check({
+        spec = {
+            name = 'leak',
+            run = function()
+                retained[#retained + 1] = string.rep('x', 1024)
+            end,
+        },
+    }, OPTS, {
+        samples = 30,
+    }))
+    assert.greater(res.slope_kb, 0.5)
+    assert.less(res.p_value, 0.05)
+
+    -- test that return an error if the describe fails
+    local err
+    res, err = leak_check({
+        spec = {
+            name = 'error',
+            run = function()
+                error('oops', 0)
+            end,
+        },
+    }, OPTS, {})
+    assert.is_nil(res)
+    assert.match(err, 'oops')
+end
@@ -0,0 +1,75 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local numa = require('measure.numa')
+local forkrun = require('measure.forkrun')
+
+function testcase.nodes()
+    local nodes, err = numa.nodes()
+    if not nodes then
+        -- not supported on this platform
+        assert.match(err, 'not supported')
+        return
+    end
+
+    -- test that return the online nodes with their CPUs
+    assert.greater(#nodes, 0)
+    for _, node in ipairs(nodes) do
+        assert.is_uint(node.node)
+        assert.is_table(node.cpus)
+        for _, cpu in ipairs(node.cpus) do
+            assert.is_uint(cpu)
+        end
+        if node.mem_kb then
+            assert.is_uint(node.mem_kb)
+        end
+    end
+end
+
+function testcase.getcpu()
+    local cpu, node = numa.getcpu()
+    if not cpu then
+        -- not supported on this platform
+        assert.match(node, 'not supported')
+        return
+    end
+
+    -- test that return the current CPU and node
+    assert.is_uint(cpu)
+    assert.is_uint(node)
+end
+
+function testcase.bind()
+    local nodes = numa.nodes()
+    if not nodes then
+        return
+    end
+
+    -- test that bind the child process to the first node with CPUs
+    for _, node in ipairs(nodes) do
+        if #node.cpus > 0 then
+            local res, err = forkrun(function()
+                assert(numa.bind(node.node, node.node))
+                local _, cur = assert(numa.getcpu())
+                return tostring(cur)
+            end)
+            if res then
+                assert.equal(res, tostring(node.node))
+            else
+                -- the memory policy may be denied in the container
+                assert.match(err, 'failed to set')
+            end
+            break
+        end
+    end
+
+    -- test that return an error for the missing node
+    local ok, err = numa.bind(1023)
+    assert.is_nil(ok)
+    assert.match(err, 'node 1023 is not found')
+
+    -- test that throw an error with invalid arguments
+    assert.throws(numa.bind)
+    assert.throws(numa.bind, -1)
+    assert.throws(numa.bind, 0, 1024)
+end
@@ -2,6 +2,7 @@ require('luacov')
 local testcase = require('testcase')
 local assert = require('assert')
 
+local format = string.format
 local new_options = require('measure.options')
 
 -- Helper function to assert valid options creation
@@ -231,6 +232,123 @@ function testcase.invalid_rciw_values()
     end
 end
 
+function testcase.forks_values()
+    -- Test forks option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.forks) -- Default: run in the current process
+
+    opts = assert_valid_options({
+        forks = 5,
+    })
+    assert.equal(opts.forks, 5)
+
+    local invalid_forks = {
+        0, -- Must be >= 1
+        -1, -- Negative
+        101, -- Over 100
+        1.5, -- Not an integer
+        "5", -- Not a number
+        {}, -- Not a number
+    }
+    for _, forks in ipairs(invalid_forks) do
+        assert_invalid_options({
+            forks = forks,
+        }, 'options.forks must be an integer between 1 and 100')
+    end
+end
+
+function testcase.cold_start_values()
+    -- Test cold_start option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.cold_start) -- Default: disabled
+
+    opts = assert_valid_options({
+        cold_start = 20,
+    })
+    assert.equal(opts.cold_start, 20)
+
+    local invalid_values = {
+        0, -- Must be >= 1
+        10001, -- Over 10000
+        2.5, -- Not an integer
+        "20", -- Not a number
+        true, -- Not a number
+    }
+    for _, v in ipairs(invalid_values) do
+        assert_invalid_options({
+            cold_start = v,
+        }, 'options.cold_start must be an integer between 1 and 10000')
+    end
+end
+
+function testcase.ab_values()
+    -- Test ab option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.ab) -- Default: disabled
+
+    local ab = {
+        a = '../old',
+        b = {
+            path = './?.lua',
+        },
+        rounds = 4,
+        samples = 50,
+    }
+    opts = assert_valid_options({
+        ab = ab,
+    })
+    assert.equal(opts.ab, ab)
+
+    for _, v in ipairs({
+        {
+            'not a table',
+            'options.ab must be a table',
+        },
+        {
+            {
+                b = '.',
+            },
+            'options.ab.a must be a root directory or a table of path and cpath',
+        },
+        {
+            {
+                a = '.',
+                b = {},
+            },
+            'options.ab.b must be a root directory or a table of path and cpath',
+        },
+        {
+            {
+                a = '.',
+                b = {
+                    path = 1,
+                },
+            },
+            'options.ab.b must be a root directory or a table of path and cpath',
+        },
+        {
+            {
+                a = '.',
+                b = '..',
+                rounds = 1,
+            },
+            'options.ab.rounds must be an integer between 2 and 100',
+        },
+        {
+            {
+                a = '.',
+                b = '..',
+                samples = 5,
+            },
+            'options.ab.samples must be an integer between 10 and 10000',
+        },
+    }) do
+        assert_invalid_options({
+            ab = v[1],
+        }, v[2])
+    end
+end
+
 function testcase.options_object_prevents_new_fields()
     -- Test that options object prevents adding new fields
     local opts = assert_valid_options({
@@ -307,3 +425,664 @@ function testcase.all_defined_fields_accessible()
 
     assert.equal(field_count, 4) -- warmup, gc_step, confidence_level, rciw are non-nil
 end
+
+function testcase.allocators_values()
+    -- Test allocators option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.allocators) -- Default: disabled
+
+    local list = {
+        'system',
+        'pool',
+    }
+    opts = assert_valid_options({
+        allocators = list,
+    })
+    assert.equal(opts.allocators, list)
+
+    for _, v in ipairs({
+        'system',
+        {},
+        {
+            'system',
+            'tlsf',
+        },
+        {
+            'arena',
+            'arena',
+        },
+    }) do
+        assert_invalid_options({
+            allocators = v,
+        }, 'options.allocators must be a list of unique "system", "arena" or "pool"')
+    end
+end
+
+function testcase.gc_modes_values()
+    -- Test gc_modes option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.gc_modes) -- Default: disabled
+
+    local modes = {
+        incremental = true,
+        generational = {
+            minormul = 25,
+            majormul = 50,
+        },
+    }
+    opts = assert_valid_options({
+        gc_modes = modes,
+    })
+    assert.equal(opts.gc_modes, modes)
+
+    for _, v in ipairs({
+        {
+            'incremental',
+            'options.gc_modes must be a table of incremental and/or generational',
+        },
+        {
+            {},
+            'options.gc_modes must be a table of incremental and/or generational',
+        },
+        {
+            {
+                incremental = true,
+                emergency = true,
+            },
+            'options.gc_modes.emergency is not a GC mode',
+        },
+        {
+            {
+                incremental = 200,
+            },
+            'options.gc_modes.incremental must be true or a table of parameters',
+        },
+        {
+            {
+                generational = {
+                    pause = 200,
+                },
+            },
+            'options.gc_modes.generational.pause is not a parameter of the mode',
+        },
+        {
+            {
+                incremental = {
+                    stepmul = 0,
+                },
+            },
+            'options.gc_modes.incremental.stepmul must be an integer between 1 and 1000',
+        },
+    }) do
+        assert_invalid_options({
+            gc_modes = v[1],
+        }, v[2])
+    end
+end
+
+function testcase.gc_tune_values()
+    -- Test gc_tune option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.gc_tune) -- Default: disabled
+
+    local tune = {
+        objective = 'p99',
+        max_memory = 2048,
+        samples = 50,
+    }
+    opts = assert_valid_options({
+        gc_tune = tune,
+    })
+    assert.equal(opts.gc_tune, tune)
+    assert_valid_options({
+        gc_tune = {},
+    })
+
+    for _, v in ipairs({
+        {
+            true,
+            'options.gc_tune must be a table',
+        },
+        {
+            {
+                objective = 'p95',
+            },
+            'options.gc_tune.objective must be "mean" or "p99"',
+        },
+        {
+            {
+                max_memory = 0,
+            },
+            'options.gc_tune.max_memory must be a positive number',
+        },
+        {
+            {
+                samples = 10.5,
+            },
+            'options.gc_tune.samples must be an integer between 10 and 10000',
+        },
+    }) do
+        assert_invalid_options({
+            gc_tune = v[1],
+        }, v[2])
+    end
+end
+
+function testcase.leak_check_values()
+    -- Test leak_check option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.leak_check) -- Default: disabled
+
+    opts = assert_valid_options({
+        leak_check = true,
+    })
+    assert.equal(opts.leak_check, {})
+    local check = {
+        interval = 10,
+        samples = 1000,
+    }
+    opts = assert_valid_options({
+        leak_check = check,
+    })
+    assert.equal(opts.leak_check, check)
+
+    for _, v in ipairs({
+        {
+            false,
+            'options.leak_check must be true or a table',
+        },
+        {
+            {
+                interval = 0,
+            },
+            'options.leak_check.interval must be an integer between 1 and 1000',
+        },
+        {
+            {
+                samples = 5,
+            },
+            'options.leak_check.samples must be an integer between 10 and 100000',
+        },
+        {
+            {
+                interval = 100,
+            },
+            'options.leak_check.samples must be at least 3 times the interval',
+        },
+    }) do
+        assert_invalid_options({
+            leak_check = v[1],
+        }, v[2])
+    end
+end
+
+function testcase.heap_census_values()
+    -- Test heap_census option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.heap_census) -- Default: disabled
+
+    opts = assert_valid_options({
+        heap_census = true,
+    })
+    assert.equal(opts.heap_census, {})
+    local c = {
+        runs = 1000,
+        top = 20,
+    }
+    opts = assert_valid_options({
+        heap_census = c,
+    })
+    assert.equal(opts.heap_census, c)
+
+    for _, v in ipairs({
+        {
+            'yes',
+            'options.heap_census must be true or a table',
+        },
+        {
+            {
+                runs = 0,
+            },
+            'options.heap_census.runs must be an integer between 1 and 100000',
+        },
+        {
+            {
+                top = 101,
+            },
+            'options.heap_census.top must be an integer between 1 and 100',
+        },
+    }) do
+        assert_invalid_options({
+            heap_census = v[1],
+        }, v[2])
+    end
+end
+
+function testcase.alloc_profile_values()
+    -- Test alloc_profile option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.alloc_profile) -- Default: disabled
+
+    opts = assert_valid_options({
+        alloc_profile = true,
+    })
+    assert.equal(opts.alloc_profile, {})
+    local c = {
+        runs = 10,
+        top = 5,
+    }
+    opts = assert_valid_options({
+        alloc_profile = c,
+    })
+    assert.equal(opts.alloc_profile, c)
+
+    for _, v in ipairs({
+        {
+            1,
+            'options.alloc_profile must be true or a table',
+        },
+        {
+            {
+                runs = 100001,
+            },
+            'options.alloc_profile.runs must be an integer between 1 and 100000',
+        },
+        {
+            {
+                top = 0,
+            },
+            'options.alloc_profile.top must be an integer between 1 and 100',
+        },
+    }) do
+        assert_invalid_options({
+            alloc_profile = v[1],
+        }, v[2])
+    end
+end
+
+function testcase.opcode_profile_values()
+    -- Test opcode_profile option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.opcode_profile) -- Default: disabled
+
+    opts = assert_valid_options({
+        opcode_profile = true,
+    })
+    assert.equal(opts.opcode_profile, {})
+    local c = {
+        runs = 10,
+        top = 5,
+    }
+    opts = assert_valid_options({
+        opcode_profile = c,
+    })
+    assert.equal(opts.opcode_profile, c)
+
+    for _, v in ipairs({
+        {
+            1,
+            'options.opcode_profile must be true or a table',
+        },
+        {
+            {
+                runs = 100001,
+            },
+            'options.opcode_profile.runs must be an integer between 1 and 100000',
+        },
+        {
+            {
+                top = 0,
+            },
+            'options.opcode_profile.top must be an integer between 1 and 100',
+        },
+    }) do
+        assert_invalid_options({
+            opcode_profile = v[1],
+        }, v[2])
+    end
+end
+
+function testcase.cpu_profile_values()
+    -- Test cpu_profile option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.cpu_profile) -- Default: disabled
+
+    opts = assert_valid_options({
+        cpu_profile = true,
+    })
+    assert.equal(opts.cpu_profile, {})
+    local c = {
+        duration = 0.5,
+        interval = 500,
+        top = 5,
+        dir = 'profile',
+    }
+    opts = assert_valid_options({
+        cpu_profile = c,
+    })
+    assert.equal(opts.cpu_profile, c)
+
+    for _, v in ipairs({
+        {
+            1,
+            'options.cpu_profile must be true or a table',
+        },
+        {
+            {
+                duration = 0.01,
+            },
+            'options.cpu_profile.duration must be a number between 0.1 and 60',
+        },
+        {
+            {
+                interval = 99,
+            },
+            'options.cpu_profile.interval must be an integer between 100 and 100000',
+        },
+        {
+            {
+                top = 101,
+            },
+            'options.cpu_profile.top must be an integer between 1 and 100',
+        },
+        {
+            {
+                dir = '',
+            },
+            'options.cpu_profile.dir must be a non-empty string',
+        },
+    }) do
+        assert_invalid_options({
+            cpu_profile = v[1],
+        }, v[2])
+    end
+end
+
+function testcase.jit_trace_values()
+    -- Test jit_trace option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.jit_trace) -- Default: disabled
+
+    opts = assert_valid_options({
+        jit_trace = true,
+    })
+    assert.is_true(opts.jit_trace)
+
+    for _, v in ipairs({
+        1,
+        'yes',
+        {},
+    }) do
+        assert_invalid_options({
+            jit_trace = v,
+        }, 'options.jit_trace must be a boolean')
+    end
+end
+
+function testcase.cold_cache_values()
+    -- Test cold_cache option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.cold_cache) -- Default: disabled
+
+    opts = assert_valid_options({
+        cold_cache = true,
+    })
+    assert.equal(opts.cold_cache, {})
+    local c = {
+        size_kb = 65536,
+    }
+    opts = assert_valid_options({
+        cold_cache = c,
+    })
+    assert.equal(opts.cold_cache, c)
+
+    for _, v in ipairs({
+        {
+            false,
+            'options.cold_cache must be true or a table',
+        },
+        {
+            {
+                size_kb = 32,
+            },
+            'options.cold_cache.size_kb must be an integer between 64 and 16777216',
+        },
+        {
+            {
+                size_kb = 1024.5,
+            },
+            'options.cold_cache.size_kb must be an integer between 64 and 16777216',
+        },
+    }) do
+        assert_invalid_options({
+            cold_cache = v[1],
+        }, v[2])
+    end
+end
+
+function testcase.page_cache_values()
+    -- Test page_cache option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.page_cache) -- Default: disabled
+
+    local files = {
+        'fixture.dat',
+        '/tmp/data.json',
+    }
+    opts = assert_valid_options({
+        page_cache = files,
+    })
+    assert.equal(opts.page_cache, files)
+
+    for _, v in ipairs({
+        {
+            true,
+            'options.page_cache must be a non-empty list of pathnames',
+        },
+        {
+            {},
+            'options.page_cache must be a non-empty list of pathnames',
+        },
+        {
+            {
+                'fixture.dat',
+                '',
+            },
+            'options.page_cache[2] must be a non-empty string',
+        },
+        {
+            {
+                1,
+            },
+            'options.page_cache[1] must be a non-empty string',
+        },
+    }) do
+        assert_invalid_options({
+            page_cache = v[1],
+        }, v[2])
+    end
+end
+
+function testcase.numa_values()
+    -- Test numa option
+    local opts = assert_valid_options({})
+    assert.is_nil(opts.numa) -- Default: disabled
+
+    for _, c in ipairs({
+        {
+            node = 0,
+        },
+        {
+            node = 1,
+            remote = 0,
+        },
+    }) do
+        opts = assert_valid_options({
+            numa = c,
+        })
+        assert.equal(opts.numa, c)
+    end
+
+    for _, v in ipairs({
+        {
+            true,
+            'options.numa must be a table',
+        },
+        {
+            {},
+            'options.numa.node must be an integer between 0 and 1023',
+        },
+        {
+            {
+                node = 1.5,
+            },
+            'options.numa.node must be an integer between 0 and 1023',
+        },
+        {
+            {
+                node = 1024,
+            },
+            'options.numa.node must be an integer between 0 and 1023',
+        },
+        {
+            {
+                node = 0,
+                remote = -1,
+            },
+            'options.numa.remote must be an integer between 0 and 1023',
+        },
+        {
+            {
+                node = 0,
+                remote = 0,
+            },
+            'options.numa.remote must be different from node',
+        },
+    }) do
+        assert_invalid_options({
+            numa = v[1],
+        }, v[2])
+    end
+end
+
+function testcase.variant_options_conflict()
+    -- Test that each variant option is valid alone
+    local variants = {
+        {
+            'ab',
+            {
+                a = 'a',
+                b = 'b',
+            },
+        },
+        {
+            'gc_modes',
+            {
+                incremental = true,
+            },
+        },
+        {
+            'gc_tune',
+            {},
+        },
+        {
+            'cold_cache',
+            true,
+        },
+        {
+            'page_cache',
+            {
+                'fixture.dat',
+            },
+        },
+        {
+            'numa',
+            {
+                node = 0,
+            },
+        },
+        {
+            'allocators',
+            {
+                'system',
+            },
+        },
+    }
+    for _, v in ipairs(variants) do
+        assert_valid_options({
+            [v[1]] = v[2],
+        })
+    end
+
+    -- Test that any two of them are rejected
+    for i = 1, #variants do
+        for j = i + 1, #variants do
+            local a, b = variants[i], variants[j]
+            assert_invalid_options({
+                [a[1]] = a[2],
+                [b[1]] = b[2],
+            }, format('options.%s cannot be combined with options.%s', b[1],
+                      a[1]))
+        end
+    end
+
+    -- Test that the options of the steady state are rejected with any of them
+    for _, v in ipairs(variants) do
+        for _, s in ipairs({
+            {
+                'cold_start',
+                10,
+            },
+            {
+                'jit_trace',
+                true,
+            },
+            {
+                'leak_check',
+                true,
+            },
+            {
+                'heap_census',
+                true,
+            },
+            {
+                'alloc_profile',
+                true,
+            },
+            {
+                'cpu_profile',
+                true,
+            },
+            {
+                'opcode_profile',
+                true,
+            },
+        }) do
+            assert_invalid_options({
+                [v[1]] = v[2],
+                [s[1]] = s[2],
+            }, format('options.%s cannot be combined with options.%s', s[1],
+                      v[1]))
+        end
+
+        -- Test that the disabled jit_trace is accepted
+        assert_valid_options({
+            [v[1]] = v[2],
+            jit_trace = false,
+        })
+    end
+
+    -- Test that the forks option is rejected with ab and gc_tune
+    for _, v in ipairs(variants) do
+        local opts = {
+            [v[1]] = v[2],
+            forks = 2,
+        }
+        if v[1] == 'ab' or v[1] == 'gc_tune' then
+            local err = 'options.forks cannot be combined with options.' .. v[1]
+            assert_invalid_options(opts, err)
+        else
+            assert_valid_options(opts)
+        end
+    end
+end
@@ -0,0 +1,85 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local pagecache = require('measure.pagecache')
+
+local PATHNAME
+
+function testcase.before_all()
+    PATHNAME = os.tmpname()
+    local f = assert(io.open(PATHNAME, 'w'))
+    f:write(string.rep('x', 1024 * 1024))
+    f:close()
+end
+
+function testcase.after_all()
+    os.remove(PATHNAME)
+end
+
+function testcase.warm()
+    -- test that the file is read into the page cache
+    assert.is_true(pagecache.warm(PATHNAME))
+    local bytes, size = pagecache.resident(PATHNAME)
+    if bytes then
+        assert.equal(size, 1024 * 1024)
+        assert.equal(bytes, size)
+    end
+
+    -- test that return an error for the missing file
+    local ok, err = pagecache.warm(PATHNAME .. '.missing')
+    assert.is_nil(ok)
+    assert.match(err, 'No such file')
+end
+
+function testcase.evict()
+    local ok, err = pagecache.evict(PATHNAME)
+    if not ok then
+        -- not supported on this platform
+        assert.match(err, 'not supported')
+        return
+    end
+
+    -- test that the file is still readable after the eviction
+    local f = assert(io.open(PATHNAME, 'r'))
+    assert.equal(#f:read('*a'), 1024 * 1024)
+    f:close()
+
+    -- test that return an error for the missing file
+    ok, err = pagecache.evict(PATHNAME .. '.missing')
+    assert.is_nil(ok)
+    assert.match(err, 'No such file')
+end
+
+function testcase.resident()
+    local bytes, size = pagecache.resident(PATHNAME)
+    if not bytes then
+        -- not supported on this platform
+        assert.match(size, 'not supported')
+        return
+    end
+
+    -- test that the resident bytes do not exceed the file size
+    assert.greater_or_equal(bytes, 0)
+    assert.less_or_equal(bytes, size)
+
+    -- test that return zero for the empty file
+    local pathname = os.tmpname()
+    assert(io.open(pathname, 'w')):close()
+    bytes, size = pagecache.resident(pathname)
+    os.remove(pathname)
+    assert.equal(bytes, 0)
+    assert.equal(size, 0)
+
+    -- test that return an error for the missing file
+    local err
+    bytes, err = pagecache.resident(PATHNAME .. '.missing')
+    assert.is_nil(bytes)
+    assert.match(err, 'No such file')
+end
+
+function testcase.invalid_args()
+    for _, fn in pairs(pagecache) do
+        assert.throws(fn)
+        assert.throws(fn, {})
+    end
+end
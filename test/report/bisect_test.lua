@@ -0,0 +1,56 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local render_bisect = require('measure.report.bisect')
+local mock_samples = require('./test/helpers/mock_samples')
+
+-- Import helper function
+local create_mock_samples = mock_samples.create_mock_samples
+
+--- Create the samples around the given mean
+--- @param mean number
+--- @return measure.samples
+local function make_samples(mean)
+    local values = {}
+    for i = 1, 30 do
+        values[i] = mean + (i % 5) * 10
+    end
+    return create_mock_samples(values)
+end
+
+function testcase.render_bisect()
+    -- test that the revisions are rendered with the verdicts
+    local tbl = render_bisect({
+        {
+            revision = 'aaaaaaa',
+            subject = 'Initial commit',
+            samples = make_samples(1000),
+        },
+        {
+            revision = 'bbbbbbb',
+            subject = string.rep('x', 60),
+            samples = make_samples(1000),
+            ratio = 1.0,
+            p_value = 1,
+            bad = false,
+        },
+        {
+            revision = 'ccccccc',
+            subject = 'Slow down',
+            samples = make_samples(2000),
+            ratio = 1.98,
+            p_value = 0.0001,
+            bad = true,
+        },
+    })
+    local lines = {}
+    for line in tbl:gmatch('[^\n]+') do
+        lines[#lines + 1] = line
+    end
+    assert.equal(#lines, 5)
+    assert.match(lines[1], '^| Revision +| Subject +| Mean', false)
+    assert.match(lines[3], '^| aaaaaaa +| Initial commit .+| baseline +| %- +| good', false)
+    assert.match(lines[4], string.rep('x', 47) .. '...', true)
+    assert.match(lines[4], '| +1%.000x | 1%.0000 +| good +|$', false)
+    assert.match(lines[5], '| +1%.980x | 0%.0001 +| bad +|$', false)
+end
@@ -0,0 +1,69 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local render_matrix = require('measure.report.matrix')
+local mock_samples = require('./test/helpers/mock_samples')
+
+-- Import helper function
+local create_mock_samples = mock_samples.create_mock_samples
+
+--- Create the named samples around the given mean
+--- @param name string
+--- @param mean number
+--- @return measure.samples
+local function make_samples(name, mean)
+    local values = {}
+    for i = 1, 30 do
+        values[i] = mean + (i % 5) * 10
+    end
+    return create_mock_samples(values, nil, nil, {
+        name = name,
+    })
+end
+
+function testcase.render_matrix()
+    -- test that each describe is compared with the first runtime
+    local matrix = render_matrix({
+        {
+            runtime = 'lua5.1',
+            version = 'Lua 5.1',
+            results = {
+                make_samples('foo', 2000),
+                make_samples('bar', 1000),
+            },
+        },
+        {
+            runtime = 'luajit',
+            version = 'LuaJIT 2.1',
+            results = {
+                make_samples('foo', 1000),
+                make_samples('bar', 1000),
+            },
+        },
+    })
+    assert.is_string(matrix)
+    local lines = {}
+    for line in matrix:gmatch('[^\n]+') do
+        lines[#lines + 1] = line
+    end
+    -- header, separator and 4 rows
+    assert.equal(#lines, 6)
+    assert.match(lines[3], '| foo +| lua5.1 +| Lua 5.1 +|.+| baseline', false)
+    assert.match(lines[4], '| foo +| luajit +| LuaJIT 2.1 +|.+| 1.98x faster',
+                 false)
+    assert.match(lines[4], '[x]')
+    assert.match(lines[5], '| bar +| lua5.1 ', false)
+    assert.match(lines[6], '| bar +| luajit .+| %- +|.+| %[ %]', false)
+end
+
+function testcase.render_matrix_empty()
+    -- test that return nil if there are no results
+    assert.is_nil(render_matrix({}))
+    assert.is_nil(render_matrix({
+        {
+            runtime = 'lua5.1',
+            version = 'Lua 5.1',
+            results = {},
+        },
+    }))
+end
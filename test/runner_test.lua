@@ -0,0 +1,144 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local runner = require('measure.runner')
+
+local OPTS = {
+    context = {},
+    warmup = 0,
+    gc_step = 0,
+    confidence_level = 95,
+    rciw = 5,
+    sample_size = 5,
+}
+
+--- Create the describe of the functions
+--- @param spec table The setup(), run() and teardown() of the describe
+--- @return table desc The describe
+local function new_desc(spec)
+    spec.name = 'test'
+    return {
+        spec = spec,
+    }
+end
+
+function testcase.with_opts()
+    -- test that return the copy of the options with the overrides
+    local opts = {
+        warmup = 1,
+        gc_step = 0,
+    }
+    local copy = runner.with_opts(opts, {
+        gc_step = 1,
+        sample_size = 10,
+    })
+    assert.equal(copy, {
+        warmup = 1,
+        gc_step = 1,
+        sample_size = 10,
+    })
+    assert.not_equal(copy, opts)
+    assert.equal(opts, {
+        warmup = 1,
+        gc_step = 0,
+    })
+end
+
+function testcase.sample()
+    -- test that run setup(), run() and teardown() of the describe
+    local calls = {}
+    local samples = assert(runner.sample(new_desc({
+        setup = function()
+            calls[#calls + 1] = 'setup'
+        end,
+        run = function()
+        end,
+        teardown = function()
+            calls[#calls + 1] = 'teardown'
+        end,
+    }), OPTS))
+    assert.equal(#samples, 5)
+    assert.equal(calls, {
+        'setup',
+        'teardown',
+    })
+
+    -- test that return an error if run() fails
+    local res, err = runner.sample(new_desc({
+        run = function()
+            error('oops', 0)
+        end,
+    }), OPTS)
+    assert.is_nil(res)
+    assert.match(err, 'ERROR: run(): ')
+    assert.match(err, 'oops')
+
+    -- test that restart the GC if run() fails with the GC stopped
+    res, err = runner.sample(new_desc({
+        run = function()
+            error('oops', 0)
+        end,
+    }), runner.with_opts(OPTS, {
+        gc_stopped = true,
+    }))
+    assert.is_nil(res)
+    assert.match(err, 'oops')
+    if _VERSION ~= 'Lua 5.1' then
+        assert.is_true(collectgarbage('isrunning'))
+    end
+end
+
+function testcase.fork()
+    -- test that return the samples collected in each child process
+    local list = assert(runner.fork(new_desc({
+        run = function()
+        end,
+    }), OPTS, 2, 'Fork'))
+    assert.equal(#list, 2)
+    assert.equal(#list[1], 5)
+
+    -- test that return an error if the describe fails in the child process
+    local res, err = runner.fork(new_desc({
+        run = function()
+        end,
+    }), OPTS, 1, 'Fork', function()
+        error('prepare failed', 0)
+    end)
+    assert.is_nil(res)
+    assert.match(err, 'ERROR: Fork 1: ')
+    assert.match(err, 'prepare failed')
+end
+
+function testcase.profile()
+    -- test that start the profile before the first and stop it after the last
+    -- run
+    local nrun = 0
+    local events = {}
+    assert(runner.profile(new_desc({
+        run = function()
+            nrun = nrun + 1
+        end,
+    }), OPTS, 3, 'Profile', {
+        start = function()
+            events[#events + 1] = nrun
+        end,
+        stop = function()
+            events[#events + 1] = nrun
+        end,
+    }))
+    assert.equal(events, {
+        0,
+        3,
+    })
+end
+
+function testcase.caller_sources()
+    -- test that contain the sources of the callers and of the runner
+    local srcs = runner.caller_sources()
+    assert.is_true(srcs[debug.getinfo(1, 'S').short_src])
+    local n = 0
+    for _ in pairs(srcs) do
+        n = n + 1
+    end
+    assert.greater(n, 1)
+end
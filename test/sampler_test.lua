@@ -492,6 +492,28 @@ function testcase.sampler_different_gc_modes()
     assert.equal(#data3.before_kb, 3)
 end
 
+function testcase.sampler_restores_gc_mode()
+    if not pcall(collectgarbage, 'incremental') then
+        -- GC modes are not supported before Lua 5.4
+        return
+    end
+
+    -- test that the GC mode changed by the function is restored
+    local samples = new_samples(nil, 3)
+    local ok = sampler(function()
+        collectgarbage('generational')
+    end, samples)
+    assert.is_true(ok)
+    assert.equal(collectgarbage('incremental'), 'incremental')
+
+    collectgarbage('generational')
+    ok = sampler(function()
+        collectgarbage('incremental')
+    end, samples, nil, true)
+    assert.is_true(ok)
+    assert.equal(collectgarbage('incremental'), 'generational')
+end
+
 function testcase.sampler_gc_data_without_allocation()
     local samples = new_samples(nil, 5, 0) -- Full GC mode
 
@@ -664,3 +686,80 @@ function testcase.sampler_invalid_clear_arg()
     assert.is_true(ok)
 end
 
+
+function testcase.sampler_with_evict_arg()
+    local samples = new_samples(nil, 10)
+
+    -- Test that the samples are collected with the eviction buffer
+    local count = 0
+    local ok = sampler(function()
+        count = count + 1
+    end, samples, nil, nil, 1024)
+    assert.is_true(ok)
+    assert.equal(count, 10)
+    assert.equal(#samples, 10)
+
+    -- Test that zero disables the eviction
+    ok = sampler(function()
+    end, samples, nil, true, 0)
+    assert.is_true(ok)
+
+    -- Test with invalid eviction size
+    assert.throws(function()
+        sampler(function()
+        end, samples, nil, true, 'large')
+    end)
+
+    -- Test with invalid before function after the eviction size
+    assert.throws(function()
+        sampler(function()
+        end, samples, nil, true, 1024, 'before')
+    end)
+end
+
+function testcase.sampler_with_before_arg()
+    local samples = new_samples(nil, 10)
+
+    -- Test that the before function is called before each sample
+    local calls = {}
+    local ok = sampler(function()
+        calls[#calls + 1] = 'run'
+    end, samples, nil, nil, nil, function()
+        calls[#calls + 1] = 'before'
+    end)
+    assert.is_true(ok)
+    assert.equal(#calls, 20)
+    for i = 1, #calls, 2 do
+        assert.equal(calls[i], 'before')
+        assert.equal(calls[i + 1], 'run')
+    end
+
+    -- Test that the before function is not called while warming up
+    local nbefore = 0
+    local nrun = 0
+    ok = sampler(function(is_warmup)
+        if not is_warmup then
+            nrun = nrun + 1
+        end
+    end, samples, 1, true, nil, function()
+        nbefore = nbefore + 1
+    end)
+    assert.is_true(ok)
+    assert.equal(nbefore, 10)
+    assert.equal(nrun, 10)
+
+    -- Test that an error in the before function is returned
+    local err
+    ok, err = sampler(function()
+    end, samples, nil, true, nil, function()
+        error('before error')
+    end)
+    assert.is_false(ok)
+    assert.match(err, 'before error')
+
+    -- Test with invalid before function
+    assert.throws(function()
+        sampler(function()
+        end, samples, nil, true, nil, 'before')
+    end)
+end
@@ -1583,6 +1583,14 @@ function testcase.memstat()
     -- Allocation rate should be average of allocated_kb
     assert.equal(stat.alloc_op, 40.0) -- (20+30+40+50+60)/5 = 40
 
+    -- Allocation rate of the merged samples is the average of all samples
+    stat = require('measure.samples').merge('merged', {
+        s,
+        new_samples(s:dump()),
+    }):memstat()
+    assert.equal(stat.alloc_op, 40.0)
+    assert.equal(stat.max_alloc_op, 60.0)
+
     -- Peak memory should be maximum after_kb
     assert.equal(stat.peak_memory, 360)
 
@@ -1777,3 +1785,96 @@ function testcase.capacity_increase()
     assert.is_true(ok)
     assert.equal(#s, 15) -- Should be at new capacity
 end
+
+function testcase.process_memory()
+    -- Test that the resident set size is recorded after each sample
+    local s = new_samples('rss', 10)
+    assert(sampler(function()
+        local t = {}
+        for i = 1, 100 do
+            t[i] = i
+        end
+    end, s))
+    local data = s:dump()
+    assert.equal(#data.rss_kb, 10)
+    local stat = s:memstat()
+    if io.open('/proc/self/statm') then
+        for _, v in ipairs(data.rss_kb) do
+            assert.greater(v, 0)
+        end
+        assert.greater_or_equal(stat.peak_rss, data.rss_kb[10])
+        assert.equal(stat.rss_growth, data.rss_kb[10] - data.rss_kb[1])
+    end
+    if data.malloc_kb then
+        -- Test that the malloc statistics are reported on glibc
+        assert.equal(stat.malloc_kb, data.malloc_kb)
+        assert.equal(stat.native_kb, data.native_kb)
+        assert.equal(stat.malloc_free_kb, data.malloc_free_kb)
+    end
+
+    -- Test that the process memory is preserved through dump/restore
+    s = create_samples_data({
+        1000,
+        2000,
+        3000,
+    }, {
+        rss_kb = {
+            4000,
+            4100,
+            4050,
+        },
+        malloc_kb = 300,
+        native_kb = 200,
+        malloc_free_kb = 50,
+    })
+    stat = s:memstat()
+    assert.equal(stat.peak_rss, 4100)
+    assert.equal(stat.rss_growth, 50)
+    assert.equal(stat.malloc_kb, 300)
+    assert.equal(stat.native_kb, 200)
+    assert.equal(stat.malloc_free_kb, 50)
+    data = s:dump()
+    assert.equal(data.rss_kb, {
+        4000,
+        4100,
+        4050,
+    })
+    assert.equal(data.native_kb, 200)
+
+    -- Test that the growth of the merged samples is summed up
+    local merged = require('measure.samples').merge('merged', {
+        s,
+        new_samples(data),
+    })
+    stat = merged:memstat()
+    assert.equal(stat.malloc_kb, 600)
+    assert.equal(stat.native_kb, 400)
+    assert.equal(stat.malloc_free_kb, 50)
+
+    -- Test that the process memory is absent in the older dumps
+    stat = create_samples_data({
+        1000,
+        2000,
+    }):memstat()
+    assert.is_nil(stat.peak_rss)
+    assert.is_nil(stat.malloc_kb)
+
+    -- Test that the invalid process memory is rejected
+    local _, err = create_samples_data({
+        1000,
+        2000,
+    }, {
+        rss_kb = {
+            4000,
+        },
+    })
+    assert.match(err, "field 'rss_kb' array size does not match", false)
+    err = assert.throws(create_samples_data, {
+        1000,
+    }, {
+        malloc_kb = 1.5,
+        native_kb = 0,
+        malloc_free_kb = 0,
+    })
+    assert.match(err, "'malloc_kb', 'native_kb' and 'malloc_free_kb'", false)
+end
@@ -0,0 +1,132 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local serialize = require('measure.serialize')
+local new_samples = require('measure.samples').new
+local sampler = require('measure.sampler')
+
+function testcase.encode_decode()
+    -- test that values are restored to the same values
+    for _, v in ipairs({
+        true,
+        false,
+        0,
+        -1,
+        123456789012,
+        0.1,
+        1 / 3,
+        -1e-300,
+        math.huge,
+        -math.huge,
+        'hello',
+        'line1\nline2\0"quoted"',
+        {},
+        {
+            1,
+            2,
+            3,
+        },
+        {
+            foo = 'bar',
+            list = {
+                1.5,
+                {
+                    nested = true,
+                },
+            },
+            [10] = 'sparse',
+            [1.5] = 'float key',
+        },
+    }) do
+        local src = assert(serialize.encode(v))
+        assert.is_string(src)
+        local restored, err = serialize.decode(src)
+        assert.is_nil(err)
+        assert.equal(restored, v)
+    end
+
+    -- test that NaN is restored
+    local v = assert(serialize.decode(assert(serialize.encode(0 / 0))))
+    assert.is_nan(v)
+
+    -- test that the output is stable regardless of the insertion order
+    assert.equal(serialize.encode({
+        b = 2,
+        a = 1,
+    }), serialize.encode({
+        a = 1,
+        b = 2,
+    }))
+end
+
+function testcase.encode_samples_dump()
+    -- test that the samples can be restored from the serialized dump
+    local s = new_samples('foo', 10)
+    assert(sampler(function()
+        local t = {}
+        for i = 1, 100 do
+            t[i] = i
+        end
+    end, s))
+    local dump = s:dump()
+    local restored = new_samples(assert(serialize.decode(
+                                            assert(serialize.encode(dump)))))
+    local restored_dump = restored:dump()
+    for _, k in ipairs({
+        'name',
+        'capacity',
+        'count',
+        'gc_step',
+        'cl',
+        'rciw',
+        'time_ns',
+        'before_kb',
+        'after_kb',
+        'allocated_kb',
+    }) do
+        assert.equal(restored_dump[k], dump[k])
+    end
+    assert.equal(restored:mean(), s:mean())
+end
+
+function testcase.encode_error()
+    -- test that return an error for unsupported values
+    for _, v in ipairs({
+        print,
+        coroutine.create(function()
+        end),
+        {
+            fn = print,
+        },
+        {
+            [{}] = true,
+        },
+    }) do
+        local src, err = serialize.encode(v)
+        assert.is_nil(src)
+        assert.match(err, 'cannot serialize')
+    end
+
+    -- test that return an error for tables with cycles
+    local t = {}
+    t.self = t
+    local src, err = serialize.encode(t)
+    assert.is_nil(src)
+    assert.match(err, 'cycles')
+end
+
+function testcase.decode_error()
+    -- test that return an error for invalid source
+    local v, err = serialize.decode('{')
+    assert.is_nil(v)
+    assert.is_string(err)
+
+    -- test that the source cannot access the global variables
+    v, err = serialize.decode('print("hello")')
+    assert.is_nil(v)
+    assert.is_string(err)
+
+    -- test that throws an error if src is not a string
+    err = assert.throws(serialize.decode, 123)
+    assert.match(err, 'src must be a string')
+end
@@ -248,6 +248,18 @@ function testcase.verify_describes_with_valid_run_with_timer_function()
     assert.is_nil(errs)
 end
 
+function testcase.verify_describes_with_require()
+    local spec = new_spec()
+
+    -- Create describe that measures require()
+    local desc = spec:new_describe('Test with require')
+    desc:require('foo')
+
+    -- Verify should succeed
+    local errs = spec:verify_describes()
+    assert.is_nil(errs)
+end
+
 function testcase.verify_describes_with_both_run_functions()
     local spec = new_spec()
 
@@ -498,6 +498,10 @@ function testcase.resampling_recommendations()
     local result_poor = ci(s_poor)
     assert.is_number(result_poor.resample_size)
     assert.greater(result_poor.resample_size, result_poor.sample_size)
+
+    -- Recommended size is capped by max_sample_size
+    local result_capped = ci(s_poor, 120)
+    assert.equal(result_capped.resample_size, 120)
 end
 
 function testcase.custom_target_rciw()
@@ -0,0 +1,86 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local coldstart = require('measure.stats.coldstart')
+local mock_samples = require('./test/helpers/mock_samples')
+
+-- Import helper function
+local create_mock_samples = mock_samples.create_mock_samples
+
+function testcase.coldstart()
+    -- test that the warm-up curve is computed per invocation index
+    local list = {
+        create_mock_samples({
+            1000,
+            300,
+            120,
+            100,
+        }),
+        create_mock_samples({
+            1200,
+            500,
+            110,
+            100,
+        }),
+        create_mock_samples({
+            800,
+            400,
+            100,
+            100,
+        }),
+    }
+    local steady = create_mock_samples({
+        100,
+        100,
+        100,
+        100,
+    })
+    local res = coldstart(list, steady)
+    assert.equal(res.runs, 3)
+    assert.equal(res.invocations, 4)
+    assert.equal(res.first, {
+        mean = 1000,
+        median = 1000,
+        min = 800,
+        max = 1200,
+    })
+    assert.equal(#res.curve, 4)
+    assert.equal(res.curve[2].median, 400)
+    assert.equal(res.curve[3].median, 110)
+    assert.equal(res.steady_mean, 100)
+    assert.equal(res.slowdown, 10)
+    assert.equal(res.warm_after, 3)
+end
+
+function testcase.coldstart_not_warm()
+    -- test that warm_after is nil if no invocation reaches the steady state
+    local res = coldstart({
+        create_mock_samples({
+            1000,
+            500,
+        }),
+        create_mock_samples({
+            1000,
+            600,
+        }),
+    }, create_mock_samples({
+        100,
+        100,
+    }))
+    assert.is_nil(res.warm_after)
+    assert.equal(res.curve[2].median, 550)
+end
+
+function testcase.coldstart_without_steady()
+    -- test that slowdown is NaN without the steady state samples
+    local res = coldstart({
+        create_mock_samples({
+            1000,
+            500,
+        }),
+    })
+    assert.equal(res.first.median, 1000)
+    assert.is_nan(res.steady_mean)
+    assert.is_nan(res.slowdown)
+    assert.is_nil(res.warm_after)
+end
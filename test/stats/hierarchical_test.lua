@@ -0,0 +1,83 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local hierarchical = require('measure.stats.hierarchical')
+local mock_samples = require('./test/helpers/mock_samples')
+
+-- Import helper function
+local create_mock_samples = mock_samples.create_mock_samples
+
+--- Create the time values around the given mean
+--- @param mean number
+--- @param n integer
+--- @return number[]
+local function make_values(mean, n)
+    local values = {}
+    for i = 1, n do
+        values[i] = mean + (i % 5) * 10 - 20
+    end
+    return values
+end
+
+function testcase.consistent_forks()
+    -- test that the CI is close to the pooled CI if the forks agree
+    local list = {}
+    for i = 1, 5 do
+        list[i] = create_mock_samples(make_values(1000 + i % 2, 50))
+    end
+    local res = hierarchical(list)
+    assert.equal(res.forks, 5)
+    assert.equal(res.sample_size, 250)
+    assert.equal(res.level, 95)
+    assert.equal(#res.means, 5)
+    assert.less(res.lower, res.mean)
+    assert.greater(res.upper, res.mean)
+    assert.less(res.icc, 0.1)
+    assert.less(res.rciw, 1)
+end
+
+function testcase.divergent_forks()
+    -- test that the between-fork variance widens the CI
+    local list = {}
+    for i, mean in ipairs({
+        1000,
+        1080,
+        960,
+        1040,
+    }) do
+        list[i] = create_mock_samples(make_values(mean, 50))
+    end
+    local res = hierarchical(list)
+    assert.equal(res.forks, 4)
+    assert.greater(res.rciw, res.pooled_rciw * 2)
+    assert.greater(res.between_stddev, 30)
+    assert.greater(res.icc, 0.5)
+    assert.equal(res.mean, 1020)
+    -- t-distribution with 3 degrees of freedom
+    local se = (res.upper - res.mean) / 3.182
+    assert.less(math.abs(se - math.sqrt(((20 ^ 2) * 2 + 60 ^ 2 + 60 ^ 2) /
+                                            3 / 4)), 1)
+end
+
+function testcase.single_fork()
+    -- test that fall back to the pooled CI with a single fork
+    local res = hierarchical({
+        create_mock_samples(make_values(1000, 50)),
+    })
+    assert.equal(res.forks, 1)
+    assert.equal(res.rciw, res.pooled_rciw)
+    assert.is_nan(res.between_stddev)
+    assert.is_nan(res.icc)
+end
+
+function testcase.insufficient_samples()
+    -- test that return NaN if a fork has less than 2 samples
+    local res = hierarchical({
+        create_mock_samples(make_values(1000, 50)),
+        create_mock_samples({
+            1000,
+        }),
+    })
+    assert.is_nan(res.mean)
+    assert.is_nan(res.rciw)
+end
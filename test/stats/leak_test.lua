@@ -0,0 +1,75 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local leak = require('measure.stats.leak')
+
+function testcase.leaking()
+    -- test that the steady growth with noise is detected
+    local heap = {}
+    for i = 1, 100 do
+        heap[i] = 500 + i * 0.5 + (i % 7) * 2
+    end
+    local res = leak(heap, 1, 95)
+    assert.equal(res.probes, 100)
+    assert.equal(res.first_kb, heap[1])
+    assert.equal(res.last_kb, heap[100])
+    assert.less(math.abs(res.slope_kb - 0.5), 0.05)
+    assert.less(res.lower, res.slope_kb)
+    assert.greater(res.lower, 0)
+    assert.greater(res.upper, res.slope_kb)
+    assert.less(res.p_value, 0.001)
+    assert.is_true(res.leaking)
+
+    -- test that the growth is per invocation with the interval
+    res = leak(heap, 10, 95)
+    assert.equal(res.interval, 10)
+    assert.less(math.abs(res.slope_kb - 0.05), 0.005)
+    assert.is_true(res.leaking)
+end
+
+function testcase.not_leaking()
+    -- test that the noise around the constant heap is not a leak
+    local heap = {}
+    for i = 1, 60 do
+        heap[i] = 500 + (i % 3 == 0 and 4 or 0) - (i % 5 == 0 and 4 or 0)
+    end
+    local res = leak(heap, 1, 95)
+    assert.less(res.lower, 0)
+    assert.greater(res.upper, 0)
+    assert.greater(res.p_value, 0.05)
+    assert.is_false(res.leaking)
+
+    -- test that the constant heap is not a leak
+    res = leak({
+        500,
+        500,
+        500,
+        500,
+    }, 1, 95)
+    assert.equal(res.slope_kb, 0)
+    assert.equal(res.p_value, 1)
+    assert.is_false(res.leaking)
+
+    -- test that the shrinking heap is not a leak
+    res = leak({
+        500,
+        490,
+        481,
+        470,
+        460,
+    }, 1, 95)
+    assert.less(res.slope_kb, 0)
+    assert.is_false(res.leaking)
+end
+
+function testcase.too_few_probes()
+    -- test that the regression needs three measurements
+    local res = leak({
+        500,
+        600,
+    }, 1, 95)
+    assert.equal(res.probes, 2)
+    assert.is_nan(res.slope_kb)
+    assert.is_nan(res.p_value)
+    assert.is_false(res.leaking)
+end
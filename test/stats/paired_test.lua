@@ -0,0 +1,72 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local paired = require('measure.stats.paired')
+local mock_samples = require('./test/helpers/mock_samples')
+
+-- Import helper function
+local create_mock_samples = mock_samples.create_mock_samples
+
+--- Create the samples of the rounds with the given means
+--- @param means number[]
+--- @return measure.samples[]
+local function make_rounds(means)
+    local list = {}
+    for i, mean in ipairs(means) do
+        list[i] = create_mock_samples({
+            mean - 10,
+            mean,
+            mean + 10,
+        })
+    end
+    return list
+end
+
+function testcase.faster_b()
+    -- test that B is detected as faster even if the host drifts
+    local means_a = {}
+    local means_b = {}
+    for i = 1, 10 do
+        local drift = i % 3 * 200
+        means_a[i] = 1000 + drift
+        means_b[i] = (1000 + drift) * (i % 2 == 0 and 0.79 or 0.81)
+    end
+    local res = paired(make_rounds(means_a), make_rounds(means_b))
+    assert.equal(res.rounds, 10)
+    assert.equal(res.level, 95)
+    assert.equal(res.wins, 10)
+    assert.less(math.abs(res.ratio - 0.8), 0.01)
+    assert.less(res.lower, res.ratio)
+    assert.greater(res.upper, res.ratio)
+    assert.less(res.upper, 1)
+    assert.less(res.p_value, 0.001)
+end
+
+function testcase.no_difference()
+    -- test that the same variants are not significantly different
+    local means_a = {}
+    local means_b = {}
+    for i = 1, 8 do
+        means_a[i] = 1000 + (i % 2 == 0 and 20 or -20)
+        means_b[i] = 1000 + (i % 4 < 2 and 20 or -20)
+    end
+    local res = paired(make_rounds(means_a), make_rounds(means_b))
+    assert.equal(res.rounds, 8)
+    assert.less(res.lower, 1)
+    assert.greater(res.upper, 1)
+    assert.greater(res.p_value, 0.05)
+end
+
+function testcase.single_round()
+    -- test that the confidence interval is not available for one round
+    local res = paired(make_rounds({
+        1000,
+    }), make_rounds({
+        500,
+    }))
+    assert.equal(res.rounds, 1)
+    assert.equal(res.ratio, 0.5)
+    assert.equal(res.wins, 1)
+    assert.is_nan(res.lower)
+    assert.is_nan(res.p_value)
+end
@@ -0,0 +1,67 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local t = require('measure.stats.tdist')
+
+--- Check that the value is close to the expected value
+--- @param v number
+--- @param expected number
+--- @param eps number
+local function near(v, expected, eps)
+    assert.less(math.abs(v - expected), eps)
+end
+
+function testcase.critical_value()
+    -- test the critical values against the t-table
+    for _, v in ipairs({
+        {0.95, 1, 12.706},
+        {0.95, 2, 4.303},
+        {0.95, 3, 3.182},
+        {0.95, 5, 2.571},
+        {0.95, 9, 2.262},
+        {0.95, 30, 2.042},
+        {0.99, 9, 3.250},
+        {0.90, 4, 2.132},
+    }) do
+        near(t.critical_value(v[1], v[2]), v[3], 0.02)
+    end
+
+    -- test the critical values of the other levels and df > 30
+    for _, v in ipairs({
+        {0.975, 9, 2.685},
+        {0.80, 5, 1.476},
+        {0.95, 60, 2.000},
+        {0.99, 120, 2.617},
+    }) do
+        near(t.critical_value(v[1], v[2]), v[3], 0.002)
+    end
+
+    -- test that the invalid arguments are rejected
+    assert.throws(function()
+        t.critical_value(1, 9)
+    end)
+    assert.throws(function()
+        t.critical_value(0.95, 0)
+    end)
+end
+
+function testcase.p_value()
+    -- test the two-sided p-values against the t-table
+    near(t.p_value(2.262, 9), 0.05, 0.001)
+    near(t.p_value(-2.262, 9), 0.05, 0.001)
+    near(t.p_value(3.250, 9), 0.01, 0.001)
+    near(t.p_value(12.706, 1), 0.05, 0.001)
+    assert.equal(t.p_value(0, 5), 1)
+    assert.less(t.p_value(100, 5), 1e-6)
+end
+
+function testcase.inverse()
+    -- test that p_value() is the inverse of critical_value()
+    for _, df in ipairs({
+        3,
+        7,
+        19,
+    }) do
+        near(t.p_value(t.critical_value(0.95, df), df), 0.05, 0.002)
+    end
+end
@@ -0,0 +1,21 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local uname = require('measure.uname')
+
+function testcase.uname()
+    -- test that return the system information
+    local info, err = uname()
+    assert.is_nil(err)
+    assert.is_table(info)
+    for _, k in ipairs({
+        'sysname',
+        'nodename',
+        'release',
+        'version',
+        'machine',
+    }) do
+        assert.is_string(info[k])
+    end
+    assert.greater(#info.sysname, 0)
+end
@@ -0,0 +1,80 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local vmprof = require('measure.vmprof')
+
+--- Find the line of this file
+--- @param lines table[] The lines
+--- @param line integer The line
+--- @return table? line
+local function find_line(lines, line)
+    for _, v in ipairs(lines) do
+        if v.source:find('vmprof_test.lua', 1, true) and v.line == line then
+            return v
+        end
+    end
+end
+
+function testcase.start_stop()
+    local function sum(n)
+        local s = 0
+        for i = 1, n do
+            s = s + i -- linedefined + 3
+        end
+        return s
+    end
+    local line = debug.getinfo(sum, 'S').linedefined + 3
+    assert(vmprof.start())
+    local v = sum(1000)
+    local res = assert(vmprof.stop())
+    assert.equal(v, 500500)
+
+    -- test that the instructions of the line are counted on every iteration
+    local l = find_line(res.lines, line)
+    assert.greater_or_equal(l.count, 1000)
+    assert.equal(l.linedefined, line - 3)
+    assert.equal(res.dropped, 0)
+
+    -- test that the functions are kept by short_src:linedefined
+    assert.equal(res.functions[l.source .. ':' .. l.linedefined], sum)
+
+    -- test that the lines are sorted by the count
+    local total = 0
+    for i, x in ipairs(res.lines) do
+        total = total + x.count
+        if i > 1 then
+            assert.greater_or_equal(res.lines[i - 1].count, x.count)
+        end
+    end
+    assert.equal(res.count, total)
+end
+
+function testcase.restore_hook()
+    -- test that the previous hook is restored
+    local called = 0
+    local hook = function()
+        called = called + 1
+    end
+    debug.sethook(hook, '', 1000)
+    assert(vmprof.start())
+    assert(vmprof.stop())
+    local fn, mask, count = debug.gethook()
+    debug.sethook()
+    assert.equal(fn, hook)
+    assert.equal(mask, '')
+    assert.equal(count, 1000)
+end
+
+function testcase.errors()
+    -- test that the profiler cannot be started twice
+    assert(vmprof.start())
+    local ok, err = vmprof.start()
+    assert.is_nil(ok)
+    assert.match(err, 'already running')
+    assert(vmprof.stop())
+
+    -- test that the profiler must be running to stop
+    ok, err = vmprof.stop()
+    assert.is_nil(ok)
+    assert.match(err, 'not running')
+end
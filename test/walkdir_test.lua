@@ -0,0 +1,107 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local walkdir = require('measure.walkdir')
+
+local TMPDIR = 'tmp_walkdir'
+
+function testcase.before_all()
+    for _, dir in ipairs({
+        TMPDIR .. '/a/b',
+        TMPDIR .. '/c',
+    }) do
+        assert(os.execute('mkdir -p ' .. dir))
+    end
+    for _, file in ipairs({
+        TMPDIR .. '/z.lua',
+        TMPDIR .. '/a/x.lua',
+        TMPDIR .. '/a/b/y.lua',
+        TMPDIR .. '/c/w.txt',
+    }) do
+        assert(io.open(file, 'w')):close()
+    end
+    -- symbolic link that points to the ancestor directory
+    assert(os.execute('ln -s .. ' .. TMPDIR .. '/a/b/loop'))
+    -- broken symbolic link
+    assert(os.execute('ln -s unknown ' .. TMPDIR .. '/c/broken'))
+end
+
+function testcase.after_all()
+    os.execute('rm -rf ' .. TMPDIR)
+end
+
+function testcase.walkdir()
+    -- test that list the regular files in the directory
+    local files, err = walkdir(TMPDIR)
+    assert.is_nil(err)
+    assert.equal(files, {
+        TMPDIR .. '/z.lua',
+    })
+
+    -- test that trailing slash is not duplicated
+    files = assert(walkdir(TMPDIR .. '/'))
+    assert.equal(files, {
+        TMPDIR .. '/z.lua',
+    })
+end
+
+function testcase.walkdir_recursive()
+    -- test that list the files recursively without following symlink loops
+    local files, err = walkdir(TMPDIR, true)
+    assert.is_nil(err)
+    assert.equal(files, {
+        TMPDIR .. '/a/b/y.lua',
+        TMPDIR .. '/a/x.lua',
+        TMPDIR .. '/c/w.txt',
+        TMPDIR .. '/z.lua',
+    })
+end
+
+function testcase.walkdir_with_patterns()
+    -- test that list only the files that match the include patterns
+    local files = assert(walkdir(TMPDIR, true, {
+        '*.lua',
+    }))
+    assert.equal(files, {
+        TMPDIR .. '/a/b/y.lua',
+        TMPDIR .. '/a/x.lua',
+        TMPDIR .. '/z.lua',
+    })
+
+    -- test that pattern with slash matches the relative pathname
+    files = assert(walkdir(TMPDIR, true, {
+        'a/*.lua',
+    }))
+    assert.equal(files, {
+        TMPDIR .. '/a/x.lua',
+    })
+
+    -- test that exclude patterns skip the directories
+    files = assert(walkdir(TMPDIR, true, nil, {
+        'b',
+        'z.*',
+    }))
+    assert.equal(files, {
+        TMPDIR .. '/a/x.lua',
+        TMPDIR .. '/c/w.txt',
+    })
+end
+
+function testcase.walkdir_error()
+    -- test that return error if the directory does not exist
+    local files, err, errno = walkdir(TMPDIR .. '/unknown')
+    assert.is_nil(files)
+    assert.is_string(err)
+    assert.is_number(errno)
+
+    -- test that return error if the pathname is not a directory
+    files, err = walkdir(TMPDIR .. '/z.lua')
+    assert.is_nil(files)
+    assert.match(err, 'failed to open directory')
+
+    -- test that throw error if the patterns are invalid
+    err = assert.throws(walkdir, TMPDIR, false, {
+        1,
+    })
+    assert.match(err, 'patterns must be a list of strings')
+end
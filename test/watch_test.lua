@@ -0,0 +1,262 @@
+require('luacov')
+local testcase = require('testcase')
+local assert = require('assert')
+local watch = require('measure.watch')
+
+local TMPDIR = 'tmp_watch'
+
+local function write_file(pathname, content)
+    local f = assert(io.open(pathname, 'w'))
+    f:write(content)
+    f:close()
+end
+
+function testcase.before_all()
+    os.execute('mkdir -p ' .. TMPDIR)
+end
+
+function testcase.after_all()
+    os.execute('rm -rf ' .. TMPDIR)
+end
+
+function testcase.new()
+    -- test that create a new watch object
+    local w, err = watch.new()
+    assert.is_nil(err)
+    assert.match(tostring(w), '^measure%.watch: ', false)
+    w:close()
+end
+
+function testcase.add()
+    local w = assert(watch.new())
+    local pathname = TMPDIR .. '/add.lua'
+    write_file(pathname, 'return 1')
+
+    -- test that add a file to the watch list
+    local ok, err = w:add(pathname)
+    assert.is_nil(err)
+    assert.is_true(ok)
+    assert.is_true(w:has(pathname))
+    assert.is_true(w:has('./' .. pathname))
+    assert.is_false(w:has(TMPDIR .. '/unknown.lua'))
+
+    -- test that return error if the directory does not exist
+    ok, err = w:add(TMPDIR .. '/unknown/foo.lua')
+    assert.is_false(ok)
+    assert.match(err, 'failed to watch')
+
+    -- test that throw error if pathname is not a string
+    err = assert.throws(w.add, w, 123)
+    assert.match(err, 'pathname must be a string')
+    w:close()
+end
+
+function testcase.remove()
+    local w = assert(watch.new())
+    local foo = TMPDIR .. '/foo.lua'
+    local bar = TMPDIR .. '/bar.lua'
+    write_file(foo, 'return 1')
+    write_file(bar, 'return 1')
+    assert(w:add(foo))
+    assert(w:add(foo))
+    assert(w:add(bar))
+
+    -- test that keep watching the file until removed as many times as added
+    local ok, err = w:remove(foo)
+    assert.is_nil(err)
+    assert.is_true(ok)
+    assert.is_true(w:has(foo))
+    assert(w:remove(foo))
+    assert.is_false(w:has(foo))
+
+    -- test that the changes of the removed file are not reported
+    write_file(foo, 'return 2')
+    write_file(bar, 'return 2')
+    assert.equal(assert(w:wait(1)), {
+        bar,
+    })
+
+    -- test that the directory is not watched after its last file is removed
+    assert(w:remove(bar))
+    assert.is_false(w:has(bar))
+    write_file(bar, 'return 3')
+    assert.equal(assert(w:wait(0.1)), {})
+
+    -- test that removing the file that is not watched is ignored
+    assert.is_true(w:remove(bar))
+
+    -- test that throw error if pathname is not a string
+    err = assert.throws(w.remove, w, 123)
+    assert.match(err, 'pathname must be a string')
+    w:close()
+end
+
+function testcase.wait()
+    local w = assert(watch.new())
+    local foo = TMPDIR .. '/foo.lua'
+    local bar = TMPDIR .. '/bar.lua'
+    write_file(foo, 'return 1')
+    write_file(bar, 'return 1')
+    assert(w:add(foo))
+
+    -- test that return empty list on timeout
+    local changed, err = w:wait(0.01)
+    assert.is_nil(err)
+    assert.equal(changed, {})
+
+    -- test that return only the changed files that are watched
+    write_file(bar, 'return 2')
+    write_file(foo, 'return 2')
+    changed, err = w:wait(1)
+    assert.is_nil(err)
+    assert.equal(changed, {
+        TMPDIR .. '/foo.lua',
+    })
+
+    -- test that detect the file replaced by rename
+    write_file(foo .. '.tmp', 'return 3')
+    assert(os.rename(foo .. '.tmp', foo))
+    changed = assert(w:wait(1))
+    assert.equal(#changed, 1)
+    assert.match(changed[1], 'foo%.lua$', false)
+    w:close()
+end
+
+function testcase.fingerprint()
+    local pathname = TMPDIR .. '/fp.lua'
+    write_file(pathname, [[
+return {
+    foo = function()
+        return 'foo'
+    end,
+    bar = function()
+        return 'bar'
+    end,
+}
+]])
+    local fns = dofile(pathname)
+
+    -- test that fingerprint of the function is its source code
+    local fp = watch.fingerprint(fns.foo)
+    assert.match(fp, "return 'foo'")
+    assert.not_equal(fp, watch.fingerprint(fns.bar))
+
+    -- test that fingerprint of the table is independent of its identity
+    assert.equal(watch.fingerprint({
+        a = 1,
+        b = fns.foo,
+    }), watch.fingerprint({
+        b = fns.foo,
+        a = 1,
+    }))
+
+    -- test that fingerprint does not change if only the surrounding code of
+    -- the function has been changed
+    write_file(pathname, [[
+-- comment
+return {
+    foo = function()
+        return 'foo'
+    end,
+    bar = function()
+        return 'baz'
+    end,
+}
+]])
+    watch.clear_cache()
+    local newfns = dofile(pathname)
+    assert.equal(watch.fingerprint(newfns.foo), fp)
+    assert.not_equal(watch.fingerprint(newfns.bar), watch.fingerprint(fns.bar))
+
+    -- test that fingerprint of the C function and other values
+    assert.match(watch.fingerprint(print), '^function: ', false)
+    assert.equal(watch.fingerprint('foo'), '"foo"')
+    assert.equal(watch.fingerprint(1), '1')
+
+    -- test that fingerprint of the cyclic table
+    local t = {}
+    t.self = t
+    assert.equal(watch.fingerprint(t), '{"self"=<cycle>}')
+end
+
+function testcase.fingerprint_outside()
+    local pathname = TMPDIR .. '/outside.lua'
+    write_file(pathname, [[
+local N = 10
+local function helper()
+    return N
+end
+return {
+    foo = function()
+        return helper()
+    end,
+    bar = function()
+        return 'bar'
+    end,
+}
+]])
+    watch.clear_cache()
+    local fns = dofile(pathname)
+    local fp = watch.fingerprint_outside({
+        fns.foo,
+        fns.bar,
+    })
+
+    -- test that fingerprint contains the code outside the functions
+    assert.match(fp, 'local N = 10')
+    assert.match(fp, 'return N')
+    assert.not_match(fp, "return 'bar'")
+
+    -- test that fingerprint does not change if only the functions, the
+    -- blank lines or the comments have been changed
+    write_file(pathname, [[
+-- comment
+local N = 10
+
+local function helper()
+    -- the constant
+    return N
+end
+return {
+    foo = function()
+        return helper() + 1
+    end,
+    bar = function()
+        return 'baz'
+    end,
+}
+]])
+    watch.clear_cache()
+    fns = dofile(pathname)
+    assert.equal(watch.fingerprint_outside({
+        fns.foo,
+        fns.bar,
+    }), fp)
+
+    -- test that fingerprint changes if the captured constant has been changed
+    write_file(pathname, [[
+local N = 20
+local function helper()
+    return N
+end
+return {
+    foo = function()
+        return helper()
+    end,
+    bar = function()
+        return 'bar'
+    end,
+}
+]])
+    watch.clear_cache()
+    fns = dofile(pathname)
+    assert.not_equal(watch.fingerprint_outside({
+        fns.foo,
+        fns.bar,
+    }), fp)
+
+    -- test that C functions are ignored
+    assert.equal(watch.fingerprint_outside({
+        print,
+    }), '')
+end